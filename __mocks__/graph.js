@@ -0,0 +1,7 @@
+// Stand-in for the emscripten build output (src/graph.js), which only exists
+// once the WASM sources are built (see docker-build.sh). Tests that need the
+// real module load it themselves (tests/wasm/graphModule.js); the rest hand
+// the controller a fake.
+export default async function createModule() {
+  throw new Error("The WASM module is not built for unit tests");
+}
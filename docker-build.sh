@@ -180,7 +180,7 @@ if [ "$SERVICE" == "novagraph-dev" ]; then
             
             echo ""
             echo -e "${GREEN}Copying WASM files to local workspace...${NC}"
-            docker run --rm -v $(pwd):/host ${SERVICE} cp ./src/graph.js ./src/graph.wasm ./src/graph.d.ts /host/src/
+            docker run --rm -v $(pwd):/host ${SERVICE} cp ./src/graph.js ./src/graph.wasm ./src/graph.d.ts ./src/graph-mt.js ./src/graph-mt.wasm ./src/graph-mt.d.ts /host/src/
             
             echo ""
             echo -e "${GREEN}Starting ${SERVICE} container...${NC}"
@@ -208,7 +208,7 @@ if [ "$SERVICE" == "novagraph-dev" ]; then
             
             echo ""
             echo -e "${GREEN}Copying WASM files to local workspace...${NC}"
-            docker run --rm -v $(pwd):/host ${SERVICE} cp ./src/graph.js ./src/graph.wasm ./src/graph.d.ts /host/src/
+            docker run --rm -v $(pwd):/host ${SERVICE} cp ./src/graph.js ./src/graph.wasm ./src/graph.d.ts ./src/graph-mt.js ./src/graph-mt.wasm ./src/graph-mt.d.ts /host/src/
             
             echo ""
             echo -e "${GREEN}Starting ${SERVICE} container...${NC}"
@@ -18,6 +18,9 @@ export default [
       "**/graph.js",
       "**/graph.d.ts",
       "**/graph.wasm",
+      "**/graph-mt.js",
+      "**/graph-mt.d.ts",
+      "**/graph-mt.wasm",
     ],
   },
 
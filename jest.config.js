@@ -7,7 +7,9 @@ export default {
     '^@/graph$': '<rootDir>/__mocks__/graph.js',
     '^@/graph\\.js$': '<rootDir>/__mocks__/graph.js',
     '^@/src/graph$': '<rootDir>/__mocks__/graph.js',
-    '^@/src/graph\\.js$': '<rootDir>/__mocks__/graph.js'
+    '^@/src/graph\\.js$': '<rootDir>/__mocks__/graph.js',
+    '^\\.\\./graph$': '<rootDir>/__mocks__/graph.js',
+    '^~/(.*)$': '<rootDir>/src/$1'
   },
   transform: {
     '^.+\\.(ts|js)$': ['ts-jest', {
@@ -18,6 +20,7 @@ export default {
   testMatch: ['**/tests/**/*.test.{ts,js}'],
   transformIgnorePatterns: [
     'node_modules/(?!(kuzu-wasm|.*\\.js$)/)',
-    'src/graph\\.js$'
+    'src/graph\\.js$',
+    'src/graph-mt\\.js$'
   ]
 };
\ No newline at end of file
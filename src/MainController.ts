@@ -8,6 +8,11 @@ import type {
 import type { InputChangeResult } from "./features/visualizer/inputs";
 import { IgraphController } from "./igraph/IgraphController";
 import { InMemoryGraphManager } from "./lib/InMemoryGraphManager";
+import {
+  GraphChangeLog,
+  edgesBetween,
+  mayWriteGraph,
+} from "./lib/GraphChangeLog";
 
 class MainController {
   // Private sector
@@ -74,7 +79,8 @@ class MainController {
     this._IgraphController = new IgraphController(
       // Bind to ensure 'this' inside db methods points to db namespace
       this.db.snapshotGraphState.bind(this.db),
-      this.db.getGraphDirection.bind(this.db)
+      this.db.getGraphDirection.bind(this.db),
+      this.db.changes
     );
   }
 
@@ -96,6 +102,9 @@ class MainController {
 
   // Database operations namespace
   db = {
+    // Bumped on every mutation below; the resident WASM graph replays it
+    changes: new GraphChangeLog(),
+
     getGraphDirection() {
       if (!this._currentDatabasePersistent && this._inMemoryGraphManager) {
         return this._inMemoryGraphManager.getGraphDirection();
@@ -160,30 +169,45 @@ class MainController {
         { value: any; success?: boolean; message?: string }
       >
     ) {
-      if (!this._currentDatabasePersistent && this._inMemoryGraphManager) {
-        const snapshot = this._inMemoryGraphManager.createNode(label, properties);
-        return Promise.resolve(snapshot);
-      }
-      return Promise.resolve(kuzuController.createNode(label, properties));
+      const result =
+        !this._currentDatabasePersistent && this._inMemoryGraphManager
+          ? this._inMemoryGraphManager.createNode(label, properties)
+          : await kuzuController.createNode(label, properties);
+      // The new node is the one of its table holding the given primary key
+      const node = result.nodes.find(
+        (n: GraphNode) =>
+          n.tableName === label &&
+          properties[n._primaryKey]?.value === n._primaryKeyValue
+      );
+      if (node) this.changes.record({ type: "node", id: node.id, node });
+      else this.changes.reset();
+      return result;
     },
 
     async updateNode(
       node: GraphNode,
       values: Record<string, InputChangeResult<any>>
     ) {
-      if (!this._currentDatabasePersistent && this._inMemoryGraphManager) {
-        const snapshot = this._inMemoryGraphManager.updateNode(node, values);
-        return Promise.resolve(snapshot);
+      const result =
+        !this._currentDatabasePersistent && this._inMemoryGraphManager
+          ? this._inMemoryGraphManager.updateNode(node, values)
+          : await kuzuController.updateNode(node, values);
+      const updated = result.nodes.find((n: GraphNode) => n.id === node.id);
+      if (updated) {
+        this.changes.record({ type: "node", id: node.id, node: updated });
+      } else {
+        this.changes.reset();
       }
-      return Promise.resolve(kuzuController.updateNode(node, values));
+      return result;
     },
 
     async deleteNode(node: GraphNode) {
-      if (!this._currentDatabasePersistent && this._inMemoryGraphManager) {
-        const snapshot = this._inMemoryGraphManager.deleteNode(node);
-        return Promise.resolve(snapshot);
-      }
-      return Promise.resolve(kuzuController.deleteNode(node));
+      const result =
+        !this._currentDatabasePersistent && this._inMemoryGraphManager
+          ? this._inMemoryGraphManager.deleteNode(node)
+          : await kuzuController.deleteNode(node);
+      this.changes.record({ type: "node", id: node.id, node: null });
+      return result;
     },
 
     // Execute query method (adds directed flag based on current DB metadata)
@@ -194,7 +218,9 @@ class MainController {
           "Please use a persistent graph to execute queries."
         );
       }
-      const result = await kuzuController.executeQuery(query);
+      const result = await this.withOpaqueWrite(query, () =>
+        kuzuController.executeQuery(query)
+      );
       return {
         ...result,
         directed: this.getGraphDirection(),
@@ -209,13 +235,31 @@ class MainController {
           "Please use a persistent graph to execute queries."
         );
       }
-      const result = await kuzuController.executeCliQuery(query);
+      const result = await this.withOpaqueWrite(query, () =>
+        kuzuController.executeCliQuery(query)
+      );
       return {
         ...result,
         directed: this.getGraphDirection(),
       };
     },
 
+    // Runs a write of unknown extent (raw Cypher, imports, switching
+    // databases). Snapshot consumers rebuild afterwards, even if it failed
+    // part way.
+    async opaqueWrite<T>(run: () => T | Promise<T>): Promise<T> {
+      try {
+        return await run();
+      } finally {
+        this.changes.reset();
+      }
+    },
+
+    // Read-only queries leave the change log alone
+    async withOpaqueWrite<T>(query: string, run: () => T | Promise<T>) {
+      return mayWriteGraph(query) ? this.opaqueWrite(run) : await run();
+    },
+
     // Get column types from query
     async getColumnTypes(query: string) {
       if (!this._currentDatabasePersistent) {
@@ -274,24 +318,25 @@ class MainController {
       edgeTable: EdgeSchema,
       attributes?: Record<string, InputChangeResult<any>>
     ) {
-      if (!this._currentDatabasePersistent && this._inMemoryGraphManager) {
-        const snapshot = this._inMemoryGraphManager.createEdge(
-          node1,
-          node2,
-          edgeTable,
-          attributes
-        );
-        return Promise.resolve(snapshot);
-      }
-      return Promise.resolve(
-        kuzuController.createEdge(
-          node1,
-          node2,
-          edgeTable,
-          this.getGraphDirection(),
-          attributes
-        )
+      const result =
+        !this._currentDatabasePersistent && this._inMemoryGraphManager
+          ? this._inMemoryGraphManager.createEdge(
+              node1,
+              node2,
+              edgeTable,
+              attributes
+            )
+          : await kuzuController.createEdge(
+              node1,
+              node2,
+              edgeTable,
+              this.getGraphDirection(),
+              attributes
+            );
+      this.changes.record(
+        edgesBetween(result.edges, node1.id, node2.id, edgeTable.tableName)
       );
+      return result;
     },
 
     async deleteEdge(
@@ -300,17 +345,19 @@ class MainController {
       isDirected: boolean,
       edgeTableName: string
     ) {
-      if (!this._currentDatabasePersistent && this._inMemoryGraphManager) {
-        const snapshot = this._inMemoryGraphManager.deleteEdge(
-          node1,
-          node2,
-          edgeTableName
-        );
-        return Promise.resolve(snapshot);
-      }
-      return Promise.resolve(
-        kuzuController.deleteEdge(node1, node2, edgeTableName, isDirected)
+      const result =
+        !this._currentDatabasePersistent && this._inMemoryGraphManager
+          ? this._inMemoryGraphManager.deleteEdge(node1, node2, edgeTableName)
+          : await kuzuController.deleteEdge(
+              node1,
+              node2,
+              edgeTableName,
+              isDirected
+            );
+      this.changes.record(
+        edgesBetween(result.edges, node1.id, node2.id, edgeTableName)
       );
+      return result;
     },
 
     async updateEdge(
@@ -319,24 +366,25 @@ class MainController {
       edgeTableName: string,
       values: Record<string, InputChangeResult<any>>
     ) {
-      if (!this._currentDatabasePersistent && this._inMemoryGraphManager) {
-        const snapshot = this._inMemoryGraphManager.updateEdge(
-          node1,
-          node2,
-          edgeTableName,
-          values
-        );
-        return Promise.resolve(snapshot);
-      }
-      return Promise.resolve(
-        kuzuController.updateEdge(
-          node1,
-          node2,
-          edgeTableName,
-          values,
-          this.getGraphDirection()
-        )
+      const result =
+        !this._currentDatabasePersistent && this._inMemoryGraphManager
+          ? this._inMemoryGraphManager.updateEdge(
+              node1,
+              node2,
+              edgeTableName,
+              values
+            )
+          : await kuzuController.updateEdge(
+              node1,
+              node2,
+              edgeTableName,
+              values,
+              this.getGraphDirection()
+            );
+      this.changes.record(
+        edgesBetween(result.edges, node1.id, node2.id, edgeTableName)
       );
+      return result;
     },
 
     async writeVirtualFile(path: string, content: string) {
@@ -353,6 +401,7 @@ class MainController {
     ) {
       const persistent = metadata?.persistent ?? true;
       this._currentDatabasePersistent = persistent;
+      this.changes.reset();
 
       if (!persistent) {
         // Create in-memory graph manager
@@ -363,18 +412,21 @@ class MainController {
         if (this._IgraphController) {
           this._IgraphController = new IgraphController(
             this.db.snapshotGraphState.bind(this.db),
-            this.db.getGraphDirection.bind(this.db)
+            this.db.getGraphDirection.bind(this.db),
+            this.db.changes
           );
           await this._IgraphController.initIgraph();
         }
         return Promise.resolve(undefined);
       }
 
-      return Promise.resolve(kuzuController.createDatabase(dbName, metadata));
+      return this.opaqueWrite(() =>
+        kuzuController.createDatabase(dbName, metadata)
+      );
     },
 
     async deleteDatabase(dbName: string) {
-      return Promise.resolve(kuzuController.deleteDatabase(dbName));
+      return this.opaqueWrite(() => kuzuController.deleteDatabase(dbName));
     },
 
     async listDatabases() {
@@ -386,7 +438,7 @@ class MainController {
       // In the future, we might need to track which databases are persistent
       this._currentDatabasePersistent = true;
       this._inMemoryGraphManager = null;
-      return Promise.resolve(kuzuController.connectToDatabase(dbName));
+      return this.opaqueWrite(() => kuzuController.connectToDatabase(dbName));
     },
 
     async getCurrentDatabaseName() {
@@ -398,7 +450,7 @@ class MainController {
     },
 
     async loadDatabase() {
-      return Promise.resolve(kuzuController.loadDatabase());
+      return this.opaqueWrite(() => kuzuController.loadDatabase());
     },
 
     /**
@@ -422,12 +474,15 @@ class MainController {
       persistent: boolean = true
     ) {
       if (!persistent && this._inMemoryGraphManager) {
-        const snapshot = await this._inMemoryGraphManager.importFromCSV(
-          nodesText,
-          edgesText,
-          nodeTableName,
-          edgeTableName,
-          isDirected
+        const manager = this._inMemoryGraphManager;
+        const snapshot = await this.opaqueWrite(() =>
+          manager.importFromCSV(
+            nodesText,
+            edgesText,
+            nodeTableName,
+            edgeTableName,
+            isDirected
+          )
         );
         return {
           databaseName,
@@ -435,13 +490,15 @@ class MainController {
         };
       }
 
-      const result = await kuzuController.importFromCSV(
-        databaseName,
-        nodesText,
-        edgesText,
-        nodeTableName,
-        edgeTableName,
-        isDirected
+      const result = await this.opaqueWrite(() =>
+        kuzuController.importFromCSV(
+          databaseName,
+          nodesText,
+          edgesText,
+          nodeTableName,
+          edgeTableName,
+          isDirected
+        )
       );
 
       return {
@@ -471,12 +528,15 @@ class MainController {
       persistent: boolean = true
     ) {
       if (!persistent && this._inMemoryGraphManager) {
-        const snapshot = await this._inMemoryGraphManager.importFromJSON(
-          nodesText,
-          edgesText,
-          nodeTableName,
-          edgeTableName,
-          isDirected
+        const manager = this._inMemoryGraphManager;
+        const snapshot = await this.opaqueWrite(() =>
+          manager.importFromJSON(
+            nodesText,
+            edgesText,
+            nodeTableName,
+            edgeTableName,
+            isDirected
+          )
         );
         return {
           databaseName,
@@ -484,13 +544,15 @@ class MainController {
         };
       }
 
-      const result = await kuzuController.importFromJSON(
-        databaseName,
-        nodesText,
-        edgesText,
-        nodeTableName,
-        edgeTableName,
-        isDirected
+      const result = await this.opaqueWrite(() =>
+        kuzuController.importFromJSON(
+          databaseName,
+          nodesText,
+          edgesText,
+          nodeTableName,
+          edgeTableName,
+          isDirected
+        )
       );
 
       return {
@@ -1,4 +1,5 @@
 import Logo from "../logo";
+import { Button } from "../button";
 
 import { useLoading } from "./use-loading";
 
@@ -11,7 +12,7 @@ export function Loading({
   className?: string;
   overlayClassName?: string;
 }) {
-  const { isLoading, loadingMessage } = useLoading();
+  const { isLoading, loadingMessage, onCancel } = useLoading();
 
   if (!isLoading) return null;
 
@@ -39,6 +40,13 @@ export function Loading({
         {loadingMessage && (
           <p className="text-center text-white">{loadingMessage}</p>
         )}
+
+        {/* Cancel button */}
+        {onCancel && (
+          <Button variant="outline" size="sm" onClick={onCancel}>
+            Cancel
+          </Button>
+        )}
       </div>
     </div>
   );
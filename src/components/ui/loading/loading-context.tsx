@@ -3,7 +3,9 @@ import { createContext, useState, type ReactNode } from "react";
 type LoadingContextType = {
   isLoading: boolean;
   loadingMessage?: string;
-  startLoading: (message?: string) => void;
+  // Shown as a Cancel button while loading
+  onCancel?: () => void;
+  startLoading: (message?: string, onCancel?: () => void) => void;
   stopLoading: () => void;
   withLoading: <T>(promise: Promise<T>, message?: string) => Promise<T>;
 };
@@ -15,15 +17,19 @@ export const LoadingContext = createContext<LoadingContextType | undefined>(
 export function LoadingProvider({ children }: { children: ReactNode }) {
   const [isLoading, setIsLoading] = useState(false);
   const [loadingMessage, setLoadingMessage] = useState<string>();
+  const [onCancel, setOnCancel] = useState<() => void>();
 
-  const startLoading = (message?: string) => {
+  const startLoading = (message?: string, cancel?: () => void) => {
     setIsLoading(true);
     setLoadingMessage(message);
+    // Wrapped, or React would call it as a state updater
+    setOnCancel(() => cancel);
   };
 
   const stopLoading = () => {
     setIsLoading(false);
     setLoadingMessage(undefined);
+    setOnCancel(undefined);
   };
 
   const withLoading = async <T,>(
@@ -44,6 +50,7 @@ export function LoadingProvider({ children }: { children: ReactNode }) {
       value={{
         isLoading,
         loadingMessage,
+        onCancel,
         startLoading,
         stopLoading,
         withLoading,
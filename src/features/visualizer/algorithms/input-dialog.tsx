@@ -23,6 +23,7 @@ import {
 } from "~/components/ui/dialog";
 import { Button } from "~/components/ui/button";
 import { useLoading } from "~/components/ui/loading";
+import { AlgorithmCancelledError } from "~/igraph/utils/runIgraphAlgo";
 
 export default function InputDialog({
   controller,
@@ -68,24 +69,29 @@ export default function InputDialog({
 
     setOpen(false);
     setInputResults(createEmptyInputResults(algorithm.inputs));
-    startLoading("Running Algorithm...");
+
+    const igraph = controller.getAlgorithm();
+    const cancel = () => igraph.cancel();
+    startLoading("Running Algorithm...", cancel);
+    igraph.onProgress(({ percent }) =>
+      startLoading(`Running Algorithm... ${Math.floor(percent)}%`, cancel)
+    );
 
     setTimeout(async () => {
       try {
         const args = algorithm.inputs.map(
           (input) => inputResults[input.key].value
         );
-        const algorithmResponse = await algorithm.wasmFunction(
-          controller.getAlgorithm(),
-          args
-        );
+        const algorithmResponse = await algorithm.wasmFunction(igraph, args);
         setActiveAlgorithm(algorithm);
         setActiveResponse(algorithmResponse);
       } catch (err) {
+        if (err instanceof AlgorithmCancelledError) return;
         throw new Error(
           String(err) ?? "An unexpected error occurred. Please try again later."
         );
       } finally {
+        igraph.onProgress(null);
         stopLoading();
       }
     }, 0);
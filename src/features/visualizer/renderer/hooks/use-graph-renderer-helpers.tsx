@@ -4,6 +4,7 @@ import chroma from "chroma-js";
 import type { GraphEdge } from "../../types";
 
 import { MODE, type ColorMap, type SizeMap } from "~/igraph/types";
+import type { EdgeColorIndex } from "~/igraph/utils/edgeColorIndex";
 
 const DEFAULT_NODE_SIZE = 7;
 const INACTIVE_NODE_SIZE = 7;
@@ -18,11 +19,13 @@ const DISABLED_COLOR = "#757575";
 export const useGraphRendererHelpers = ({
   mode,
   colors,
+  edgeColors,
   sizes,
   directed,
 }: {
   mode: number;
   colors: ColorMap;
+  edgeColors: EdgeColorIndex;
   sizes: SizeMap;
   directed: boolean;
 }) => {
@@ -66,41 +69,38 @@ export const useGraphRendererHelpers = ({
   const getLinkColor = useMemo(
     () =>
       (link: GraphEdge): string | null => {
-        const forwardKey = `${link.source}-${link.target}`;
-        const backwardKey = `${link.target}-${link.source}`;
+        const forward = edgeColors.get(link.source, link.target);
+        const backward = edgeColors.get(link.target, link.source);
 
-        if (colors[forwardKey] > 0) {
+        if (forward > 0) {
           return PRIMARY_LOW_COLOR;
         }
-        if (!directed && colors[backwardKey] > 0) {
+        if (!directed && backward > 0) {
           return PRIMARY_LOW_COLOR;
         }
-        if (colors[backwardKey] === 0) {
+        if (backward === 0) {
           return GRADIENT_COLOR(1).hex();
         }
-        if (!directed && colors[forwardKey] === 0) {
+        if (!directed && forward === 0) {
           return GRADIENT_COLOR(1).hex();
         }
         return null;
       },
-    [colors, directed]
+    [edgeColors, directed]
   );
 
   const getLinkWidth = useMemo(
     () =>
       (link: GraphEdge): number => {
-        const forwardKey = `${link.source}-${link.target}`;
-        const backwardKey = `${link.target}-${link.source}`;
-
-        if (colors[forwardKey] >= 0) {
+        if (edgeColors.get(link.source, link.target) >= 0) {
           return HIGHLIGHTED_LINK_WIDTH;
         }
-        if (!directed && colors[backwardKey] >= 0) {
+        if (!directed && edgeColors.get(link.target, link.source) >= 0) {
           return HIGHLIGHTED_LINK_WIDTH;
         }
         return DEFAULT_LINK_WIDTH;
       },
-    [colors, directed]
+    [edgeColors, directed]
   );
 
   return { getNodeSize, getNodeColor, getLinkColor, getLinkWidth };
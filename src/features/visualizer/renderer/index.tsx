@@ -17,6 +17,7 @@ import NodeMetadata from "./node-metadata";
 
 import { cn } from "~/lib/utils";
 import { MODE, type ColorMap, type SizeMap } from "~/igraph/types";
+import { EdgeColorIndex } from "~/igraph/utils/edgeColorIndex";
 
 const INITIAL_ZOOM_LEVEL = 1;
 const SIMULATION_LINK_DISTANCE = 20;
@@ -31,15 +32,26 @@ const GraphRenderer = observer(({ className }: { className?: string }) => {
 
   const { nodes, edges, nodesMap, nodeTables, directed } = database.graph;
 
-  const { sizes, colors, mode } = useMemo(() => {
-    const result: { sizes: SizeMap; colors: ColorMap; mode: number } = {
+  const { sizes, colors, edgeColors, mode } = useMemo(() => {
+    const result: {
+      sizes: SizeMap;
+      colors: ColorMap;
+      edgeColors: EdgeColorIndex;
+      mode: number;
+    } = {
       sizes: {},
       colors: {},
+      edgeColors: new EdgeColorIndex(),
       mode: MODE.COLOR_SHADE_DEFAULT,
     };
     if (!!activeResponse) {
       !!activeResponse.sizeMap && (result.sizes = activeResponse.sizeMap);
       result.colors = activeResponse.colorMap;
+      // Highlight-based results index their edges already; "from-to" keys
+      // of the others are parsed once here rather than built per link
+      result.edgeColors =
+        ("edgeColors" in activeResponse && activeResponse.edgeColors) ||
+        EdgeColorIndex.fromColorMap(activeResponse.colorMap);
       result.mode = activeResponse.mode;
     }
     return result;
@@ -60,6 +72,7 @@ const GraphRenderer = observer(({ className }: { className?: string }) => {
     useGraphRendererHelpers({
       mode,
       colors,
+      edgeColors,
       sizes,
       directed: database.graph.directed,
     });
@@ -0,0 +1,182 @@
+import type { AlgorithmProgress, GraphModule, IgraphInput } from "./types";
+
+interface WorkerMessage {
+  id: number;
+  type: string;
+  data: unknown;
+}
+
+interface PendingRequest {
+  resolve: (value: unknown) => void;
+  reject: (error: Error) => void;
+}
+
+type WorkerProgressListener = (
+  progress: AlgorithmProgress,
+  message: string
+) => void;
+
+/**
+ * GraphWorkerClient - Hosts the graph WASM module in a Web Worker
+ * (workers/graph.worker.ts) so algorithms run off the main thread, which
+ * stays free to poll progress and cancel them
+ */
+export class GraphWorkerClient {
+  // Stands in for the module: every export posts a call to the worker and
+  // returns a promise of its result, so callers must await each call
+  readonly module: GraphModule;
+
+  private _worker: Worker | null = null;
+  private _ready: Promise<void> | null = null;
+  private _messageId = 0;
+  private _pendingRequests = new Map<number, PendingRequest>();
+  // [percent, elapsed ms, ETA ms, running]: the module's own cells when its
+  // memory is shared, else a copy of the last ones the worker reported
+  private _progressCells: Float64Array = Float64Array.of(0, 0, NaN, 0);
+  // The module's cancel flag, only reachable when its memory is shared
+  private _cancelFlag: Int32Array | null = null;
+  private _onProgress: WorkerProgressListener | null = null;
+  private _onRestart: () => void;
+
+  // onRestart runs whenever cancel() had to replace the worker, dropping
+  // every graph handle it held
+  constructor(onRestart: () => void) {
+    this._onRestart = onRestart;
+    this.module = new Proxy({} as GraphModule, {
+      get: (_target, name) =>
+        // Not a thenable, so it can be returned from async functions
+        typeof name !== "string" || name === "then"
+          ? undefined
+          : (...args: unknown[]) => this._send("call", { name, args }),
+    });
+  }
+
+  async start(): Promise<GraphModule> {
+    this._spawn();
+    await this._ready;
+    return this.module;
+  }
+
+  terminate() {
+    this._worker?.terminate();
+    this._worker = null;
+    this._failPendingRequests("Graph worker terminated");
+  }
+
+  // Builds the handle's graph from a copy of the edge arrays, filled into
+  // the module's ingest buffers inside the worker
+  upload(handle: number, igraphInput: IgraphInput, version: number) {
+    return this._send("upload", { handle, ...igraphInput, version });
+  }
+
+  progress(): AlgorithmProgress {
+    const cells = this._progressCells;
+    return {
+      percent: cells[0],
+      elapsedMs: cells[1],
+      etaMs: cells[2],
+      running: cells[3] !== 0,
+    };
+  }
+
+  // Raises the shared cancel flag. Without shared memory the busy worker
+  // cannot see a flag, so it is terminated and replaced instead: pending
+  // calls reject with "Cancelled" and resident graphs must be uploaded again.
+  cancel() {
+    if (this._cancelFlag) {
+      Atomics.store(this._cancelFlag, 0, 1);
+      return;
+    }
+    if (this._pendingRequests.size === 0) return;
+
+    this._worker?.terminate();
+    this._failPendingRequests("Cancelled");
+    this._progressCells[3] = 0;
+    this._spawn();
+    this._onRestart();
+  }
+
+  // Lowers the shared cancel flag as a run starts. Without shared memory
+  // nothing raises the worker's flag, since cancel() replaces the worker.
+  clearCancel() {
+    if (this._cancelFlag) Atomics.store(this._cancelFlag, 0, 0);
+  }
+
+  onProgress(callback: WorkerProgressListener | null) {
+    this._onProgress = callback;
+  }
+
+  private _spawn() {
+    const worker = new Worker(
+      new URL("./workers/graph.worker.ts", import.meta.url),
+      {
+        type: "module",
+      }
+    );
+
+    worker.onmessage = (e) => {
+      const { id, type, data, error, progress } = e.data;
+      if (type === "progress") {
+        this._report(data.cells, data.message);
+        return;
+      }
+      if (progress && !this._cancelFlag) this._progressCells.set(progress);
+
+      const request = this._pendingRequests.get(id);
+      if (request) {
+        error ? request.reject(new Error(error)) : request.resolve(data);
+        this._pendingRequests.delete(id);
+      }
+    };
+
+    worker.onerror = (error) => {
+      // eslint-disable-next-line no-console
+      console.error("Graph worker error:", error);
+      this._failPendingRequests(
+        `Graph worker error: ${error.message || "Unknown error"}`
+      );
+    };
+
+    this._worker = worker;
+    this._ready = this._post("init", {}).then((data) => {
+      const { progress, cancel } = data as {
+        progress: Float64Array | null;
+        cancel: Int32Array | null;
+      };
+      // Views over shared memory are shared, not copied, by postMessage
+      if (progress && cancel) {
+        this._progressCells = progress;
+        this._cancelFlag = cancel;
+      }
+    });
+  }
+
+  private _report(cells: number[], message: string) {
+    if (!this._cancelFlag) this._progressCells.set(cells);
+    this._onProgress?.(this.progress(), message);
+  }
+
+  private async _send(type: string, data: Record<string, unknown>) {
+    await this._ready;
+    return this._post(type, data);
+  }
+
+  private _post(type: string, data: Record<string, unknown>) {
+    const worker = this._worker;
+    if (!worker) {
+      return Promise.reject(new Error("Graph worker is not running"));
+    }
+    return new Promise<unknown>((resolve, reject) => {
+      const id = this._messageId++;
+      this._pendingRequests.set(id, { resolve, reject });
+      worker.postMessage({ id, type, data } as WorkerMessage);
+    });
+  }
+
+  private _failPendingRequests(message: string) {
+    this._pendingRequests.forEach((request) =>
+      request.reject(new Error(message))
+    );
+    this._pendingRequests.clear();
+  }
+}
@@ -2,13 +2,42 @@ import { toast } from "sonner";
 
 import createModule from "../graph";
 
-import type { GraphModule, KuzuToIgraphParseResult } from "./types";
+import { GraphWorkerClient } from "./GraphWorkerClient";
+import type {
+  AlgorithmProgress,
+  AttributeKind,
+  EdgeColumns,
+  GraphModule,
+  IgraphInput,
+  KuzuToIgraphParseResult,
+  NodeColumns,
+  ProgressCallback,
+  ResidentGraphData,
+  SpectralOptions,
+  TypedAttributeInput,
+  VertexOrder,
+  VertexOrderStats,
+  WeightMerge,
+} from "./types";
 import { igraphBFS, type BFSResult } from "./algorithms/PathFinding/IgraphBFS";
 import { igraphDFS, type DFSResult } from "./algorithms/PathFinding/IgraphDFS";
 import {
   igraphDijkstraAToB,
   type DijkstraAToBResult,
 } from "./algorithms/PathFinding/IgraphDijkstraAtoB";
+import {
+  igraphAStar,
+  type AStarResult,
+} from "./algorithms/PathFinding/IgraphAStar";
+import {
+  igraphBuildShortestPathIndex,
+  type ShortestPathIndexStats,
+} from "./algorithms/PathFinding/IgraphShortestPathIndex";
+import {
+  igraphShortestPathPairs,
+  type ShortestPathPairsOptions,
+  type ShortestPathPairsResult,
+} from "./algorithms/PathFinding/IgraphShortestPathPairs";
 import {
   igraphDijkstraAToAll,
   type DijkstraAToAllResult,
@@ -22,6 +51,11 @@ import {
   igraphBellmanFordAToAll,
   type BellmanFordAToAllResult,
 } from "./algorithms/PathFinding/IgraphBellmanFordAToAll";
+import {
+  igraphShortestPathTree,
+  type ShortestPathTreeAlgorithm,
+  type ShortestPathTreeResult,
+} from "./algorithms/PathFinding/IgraphShortestPathTree";
 import {
   igraphRandomWalk,
   type RandomWalkResult,
@@ -31,6 +65,10 @@ import {
   igraphBetweennessCentrality,
   type BetweennessCentralityResult,
 } from "./algorithms/Centrality/IgraphBetweenessCentrality";
+import {
+  igraphApproximateBetweenness,
+  type ApproximateBetweennessResult,
+} from "./algorithms/Centrality/IgraphApproximateBetweenness";
 import {
   igraphClosenessCentrality,
   type ClosenessCentralityResult,
@@ -43,6 +81,19 @@ import {
   igraphEigenvectorCentrality,
   type EigenvectorCentralityResult,
 } from "./algorithms/Centrality/IgraphEigenvectorCentrality";
+import {
+  igraphKatzCentrality,
+  type KatzCentralityResult,
+} from "./algorithms/Centrality/IgraphKatzCentrality";
+import {
+  igraphPersonalizedPageRank,
+  type PersonalizedPageRankOptions,
+  type PersonalizedPageRankResult,
+} from "./algorithms/Centrality/IgraphPersonalizedPageRank";
+import {
+  igraphHits,
+  type HitsResult,
+} from "./algorithms/Centrality/IgraphHits";
 import {
   igraphHarmonicCentrality,
   type HarmonicCentralityResult,
@@ -51,6 +102,11 @@ import {
   igraphStrengthCentrality,
   type StrengthCentralityResult,
 } from "./algorithms/Centrality/IgraphStrengthCentrality";
+import {
+  igraphCentralityColumns,
+  type CentralityAlgorithm,
+  type CentralityColumnsResult,
+} from "./algorithms/Centrality/IgraphCentralityColumns";
 import {
   igraphPageRank,
   type PageRankResult,
@@ -119,7 +175,11 @@ import {
   igraphJaccardSimilarity,
   type JaccardSimilarityResult,
 } from "./algorithms/Misc/IgraphJaccardSimilarity";
-import { parseKuzuToIgraphInput } from "./utils/parseKuzuToIgraphInput";
+import {
+  parseEdgeWeight,
+  parseKuzuToIgraphInput,
+} from "./utils/parseKuzuToIgraphInput";
+import { AlgorithmCancelledError } from "./utils/runIgraphAlgo";
 
 import type {
   EdgeSchema,
@@ -127,13 +187,23 @@ import type {
   GraphNode,
   NodeSchema,
 } from "~/features/visualizer/types";
+import type { GraphChange, GraphChangeLog } from "~/lib/GraphChangeLog";
 
 type InitializedIgraphController = IgraphController & {
   _wasmGraphModule: NonNullable<IgraphController["_wasmGraphModule"]>;
 };
 
+type EdgeIndex = {
+  src: number[];
+  dst: number[];
+  tables: string[];
+  weights: number[] | null;
+};
+
 export class IgraphController {
   protected _wasmGraphModule: GraphModule | null = null;
+  // Worker hosting the module; null when it runs on this thread
+  private _worker: GraphWorkerClient | null = null;
   private _getKuzuData: () => Promise<{
     nodes: GraphNode[];
     edges: GraphEdge[];
@@ -141,6 +211,37 @@ export class IgraphController {
     edgeTables: EdgeSchema[];
   }>;
   private _getDirection: () => boolean;
+  private _changes: GraphChangeLog;
+
+  // Residency bookkeeping: the database version the resident WASM graph
+  // reflects (null: unknown), the version of the WASM graph itself and the
+  // parse results per direction
+  private _dbVersion: number | null = null;
+  private _graphVersion = 0;
+  // Edges of the snapshot the unpatched parse results were built from
+  private _residentEdges: GraphEdge[] | null = null;
+  private _parseCache = new Map<boolean, KuzuToIgraphParseResult>();
+  // Parse results whose maps were patched in place by a delta; their
+  // IgraphInput no longer matches the graph and must not be uploaded
+  private _patchedParseResults = new WeakSet<KuzuToIgraphParseResult>();
+  // Endpoints, edge table and weight of each resident graph's edges, indexed
+  // by igraph edge ID. Built lazily the first time a delta is applied to
+  // that direction.
+  private _edgeIndex = new Map<boolean, EdgeIndex>();
+  // WASM graph handle per direction, so both orientations stay resident
+  private _handles = new Map<boolean, number>();
+  // Undirected projection of the directed graph for undirected-only
+  // algorithms, and the weight merge it was built with
+  private _projectionHandle: number | null = null;
+  private _projectionMerge: WeightMerge | null = null;
+  private _weightMerge: WeightMerge = "sum";
+  private _vertexOrder: VertexOrder = "none";
+  // Tail of the queue residency updates run in, one at a time, since they
+  // span several module calls
+  private _residency: Promise<unknown> = Promise.resolve();
+  // Runs still preparing their graph; cancel() marks them so they stop
+  // before reaching the kernel
+  private _preparingRuns = new Set<{ cancelled: boolean }>();
 
   constructor(
     getKuzuData: () => Promise<{
@@ -149,19 +250,49 @@ export class IgraphController {
       nodeTables: NodeSchema[];
       edgeTables: EdgeSchema[];
     }>,
-    getDirection: () => boolean
+    getDirection: () => boolean,
+    changes: GraphChangeLog
   ) {
     this._getDirection = getDirection;
     this._getKuzuData = getKuzuData;
+    this._changes = changes;
   }
 
-  // Initialize WASM module
+  // Initialize WASM module, in a Web Worker where there is one so algorithms
+  // do not block the page and progress()/cancel() work while they run.
+  // Cross-origin isolated pages (SharedArrayBuffer available) get the
+  // multithreaded build; anything else, or a failure to start it, falls back
+  // to the single-threaded one.
   async initIgraph(): Promise<GraphModule> {
-    if (!this._wasmGraphModule) {
+    if (!this._wasmGraphModule && typeof Worker !== "undefined") {
+      const worker = new GraphWorkerClient(() => this._resetResidency());
       try {
-        this._wasmGraphModule = await createModule();
+        this._wasmGraphModule = await worker.start();
+        this._worker = worker;
       } catch (err) {
-        throw new Error("Failed to load WASM module: " + err);
+        worker.terminate();
+        // eslint-disable-next-line no-console
+        console.warn("Graph worker unavailable:", err);
+      }
+    }
+    if (!this._wasmGraphModule) {
+      if (globalThis.crossOriginIsolated) {
+        try {
+          const { default: createThreadedModule } = await import(
+            "../graph-mt"
+          );
+          this._wasmGraphModule = await createThreadedModule();
+        } catch (err) {
+          // eslint-disable-next-line no-console
+          console.warn("Multithreaded WASM module unavailable:", err);
+        }
+      }
+      if (!this._wasmGraphModule) {
+        try {
+          this._wasmGraphModule = await createModule();
+        } catch (err) {
+          throw new Error("Failed to load WASM module: " + err);
+        }
       }
     }
     return this._wasmGraphModule;
@@ -171,28 +302,556 @@ export class IgraphController {
     return this._wasmGraphModule;
   }
 
-  // Centralized data preparation - only called when needed
-  private async _prepareGraphData(): Promise<KuzuToIgraphParseResult> {
+  private async _graphHandle(directed: boolean): Promise<number> {
+    this.checkInitialization();
+
+    let handle = this._handles.get(directed);
+    if (handle === undefined) {
+      handle = await this._wasmGraphModule.create_graph_handle();
+      await this._wasmGraphModule.set_vertex_order(handle, this._vertexOrder);
+      this._handles.set(directed, handle);
+    }
+    return handle;
+  }
+
+  // Copies the edge list straight into module-owned WASM buffers and builds
+  // the handle's graph from them (one bulk copy per array, no per-edge calls)
+  private async _uploadGraph(
+    handle: number,
+    igraphInput: IgraphInput,
+    version: number
+  ): Promise<void> {
+    this.checkInitialization();
+
+    // The worker fills its own buffers from a copy of the arrays
+    if (this._worker) {
+      await this._worker.upload(handle, igraphInput, version);
+      return;
+    }
+
+    const { nodes, src, dst, directed, weight } = igraphInput;
+
+    // The views alias WASM memory and are invalidated by heap growth,
+    // so they must be filled before any other call into the module
+    const buffers = this._wasmGraphModule.ingest_buffers(
+      src.length,
+      weight !== undefined
+    );
+    buffers.src.set(src);
+    buffers.dst.set(dst);
+    if (weight) buffers.weight.set(weight);
+
+    await this._wasmGraphModule.create_graph_from_ingest_buffers(
+      handle,
+      nodes,
+      directed,
+      version
+    );
+  }
+
+  // Forces the next algorithm call to rebuild the WASM graph
+  invalidateGraph() {
+    this._residentEdges = null;
+    this._edgeIndex.clear();
+    this._parseCache.clear();
+    this._graphVersion++;
+  }
+
+  // The worker was restarted to cancel a run, taking every resident graph
+  // with it
+  private _resetResidency() {
+    this._handles.clear();
+    this._projectionHandle = null;
+    this._projectionMerge = null;
+    this._dbVersion = null;
+    this.invalidateGraph();
+  }
+
+  // Runs a residency update once the ones queued before it are done
+  private _queueResidency<T>(update: () => Promise<T>): Promise<T> {
+    const result = this._residency.then(update);
+    this._residency = result.catch(() => {});
+    return result;
+  }
+
+  private _residentGraphData(directed: boolean): Promise<ResidentGraphData> {
+    return this._queueResidency(() => this._loadResidentGraph(directed));
+  }
+
+  // Uploads the graph only if the WASM module does not already hold the
+  // current database version in this direction. An unchanged version costs
+  // no snapshot at all; a moved one replays the change log when it can.
+  private async _loadResidentGraph(
+    directed: boolean
+  ): Promise<ResidentGraphData> {
+    this.checkInitialization();
+
+    const handle = await this._graphHandle(directed);
+    const version = this._changes.version;
+    if (this._dbVersion !== version) {
+      const changes =
+        this._dbVersion === null ? null : this._changes.since(this._dbVersion);
+      if (!changes || !(await this._applyChanges(changes, directed))) {
+        this.invalidateGraph();
+      }
+      this._dbVersion = version;
+    }
+
+    let parseResult = this._parseCache.get(directed);
+    if (
+      parseResult &&
+      (await this._wasmGraphModule.graph_is_resident(
+        handle,
+        this._graphVersion,
+        directed
+      ))
+    ) {
+      return { ...parseResult, handle };
+    }
+
+    if (!parseResult || this._patchedParseResults.has(parseResult)) {
+      const kuzuData = await this._getKuzuData();
+      // A mutation that landed while the snapshot was taken may or may not
+      // be part of it, so it cannot be replayed on top
+      if (this._changes.version !== version) this._dbVersion = null;
+      parseResult = parseKuzuToIgraphInput(
+        kuzuData.nodes,
+        kuzuData.edges,
+        directed
+      );
+      this._parseCache.set(directed, parseResult);
+      this._residentEdges = kuzuData.edges;
+    }
+
+    // Edge IDs follow the uploaded edge order from here on
+    this._edgeIndex.delete(directed);
+    await this._uploadGraph(
+      handle,
+      parseResult.IgraphInput,
+      this._graphVersion
+    );
+    return { ...parseResult, handle };
+  }
+
+  // Brings the resident graph up to date by replaying the changes logged
+  // since it was built (add_vertices, add_edges, delete_edges,
+  // delete_vertices). Returns false when a full rebuild is needed instead:
+  // nothing resident, a change it cannot place, or too many changes.
+  private async _applyChanges(
+    changes: GraphChange[],
+    directed: boolean
+  ): Promise<boolean> {
+    this.checkInitialization();
+
+    const mod = this._wasmGraphModule;
+    const handle = await this._graphHandle(directed);
+    const parseResult = this._parseCache.get(directed);
+    if (
+      !parseResult ||
+      !(await mod.graph_is_resident(handle, this._graphVersion, directed))
+    ) {
+      return false;
+    }
+    const { KuzuToIgraphMap, IgraphToKuzuMap, nodesMap } = parseResult;
+
+    const index =
+      this._edgeIndex.get(directed) ?? this._buildEdgeIndex(parseResult);
+    if (!index) return false;
+
+    // Net effect of the log: the last state of every touched node, and the
+    // edges last stored between every touched pair of nodes and table
+    const nodeStates = new Map<string, GraphNode | null>();
+    const pairs = new Map<string, Map<string, Map<string, GraphEdge[]>>>();
+    for (const change of changes) {
+      if (change.type === "node") {
+        // A deleted ID coming back would alias the old vertex's edges
+        if (nodeStates.get(change.id) === null && change.node) return false;
+        nodeStates.set(change.id, change.node);
+        continue;
+      }
+      const [a, b] =
+        change.source <= change.target
+          ? [change.source, change.target]
+          : [change.target, change.source];
+      let byTarget = pairs.get(a);
+      if (!byTarget) pairs.set(a, (byTarget = new Map()));
+      let byTable = byTarget.get(b);
+      if (!byTable) byTarget.set(b, (byTable = new Map()));
+      byTable.set(change.tableName, change.edges);
+    }
+
+    const vertexCount = IgraphToKuzuMap.size;
+    const deletedVertex = new Uint8Array(vertexCount);
+    const deletedNodes: number[] = [];
+    const addedNodes: GraphNode[] = [];
+    for (const [kuzuId, node] of nodeStates) {
+      const id = KuzuToIgraphMap.get(kuzuId);
+      if (node && id === undefined) addedNodes.push(node);
+      if (!node && id !== undefined) {
+        deletedVertex[id] = 1;
+        deletedNodes.push(id);
+      }
+    }
+    const known = (kuzuId: string) =>
+      nodeStates.has(kuzuId) || KuzuToIgraphMap.has(kuzuId);
+    const alive = (kuzuId: string) =>
+      nodeStates.has(kuzuId)
+        ? nodeStates.get(kuzuId) !== null
+        : KuzuToIgraphMap.has(kuzuId);
+
+    // Edge groups between surviving nodes, watched by their resident
+    // endpoints (new nodes have no resident edges yet)
+    type Group = {
+      s?: number;
+      t?: number;
+      tableName: string;
+      edges: GraphEdge[];
+      resident: number[];
+    };
+    const groups: Group[] = [];
+    const watch = new Map<number, Group[]>();
+    for (const [a, byTarget] of pairs) {
+      for (const [b, byTable] of byTarget) {
+        // Not a node the graph or the log knows of
+        if (!known(a) || !known(b)) return false;
+        // Deleted with one of its nodes
+        if (!alive(a) || !alive(b)) continue;
+        for (const [tableName, edges] of byTable) {
+          const group: Group = {
+            s: KuzuToIgraphMap.get(a),
+            t: KuzuToIgraphMap.get(b),
+            tableName,
+            edges,
+            resident: [],
+          };
+          groups.push(group);
+          if (group.s === undefined || group.t === undefined) continue;
+          const watched = watch.get(group.s);
+          if (watched) watched.push(group);
+          else watch.set(group.s, [group]);
+          if (group.t !== group.s) {
+            const watchedT = watch.get(group.t);
+            if (watchedT) watchedT.push(group);
+            else watch.set(group.t, [group]);
+          }
+        }
+      }
+    }
+
+    // One pass over the resident edges, comparing numbers only
+    const deletedEdges: number[] = [];
+    const { src, dst, tables } = index;
+    if (deletedNodes.length > 0 || watch.size > 0) {
+      for (let eid = 0; eid < src.length; eid++) {
+        const u = src[eid];
+        const v = dst[eid];
+        if (deletedVertex[u] || deletedVertex[v]) {
+          deletedEdges.push(eid);
+          continue;
+        }
+        const candidates = watch.get(u);
+        if (!candidates) continue;
+        for (const g of candidates) {
+          if (
+            g.tableName === tables[eid] &&
+            ((g.s === u && g.t === v) || (g.s === v && g.t === u))
+          ) {
+            g.resident.push(eid);
+          }
+        }
+      }
+    }
+
+    // Match each group's stored edges against its resident ones by
+    // orientation and weight; a changed weight is a delete + add
+    const weightOf = (eid: number) => (index.weights ? index.weights[eid] : 0);
+    const addedEdges: { edge: GraphEdge; weight?: number }[] = [];
+    for (const g of groups) {
+      const resident = g.resident;
+      g.edges.forEach((edge, i) => {
+        const weight = parseEdgeWeight(edge, i);
+        const s = KuzuToIgraphMap.get(edge.source);
+        const t = KuzuToIgraphMap.get(edge.target);
+        const match = resident.findIndex(
+          (eid) =>
+            src[eid] === s && dst[eid] === t && weightOf(eid) === (weight ?? 0)
+        );
+        if (match >= 0) resident.splice(match, 1);
+        else addedEdges.push({ edge, weight });
+      });
+      deletedEdges.push(...resident);
+    }
+
+    const structural =
+      addedNodes.length +
+      deletedNodes.length +
+      addedEdges.length +
+      deletedEdges.length;
+    if (structural > Math.max(64, src.length / 4)) return false;
+
+    // An attribute-only edit leaves the resident graph untouched
+    const version =
+      structural === 0 ? this._graphVersion : this._graphVersion + 1;
+
+    if (deletedEdges.length > 0) {
+      await mod.delete_edges(handle, Int32Array.from(deletedEdges), version);
+      const deleted = new Uint8Array(src.length);
+      for (const eid of deletedEdges) deleted[eid] = 1;
+      const keep = (_: unknown, eid: number) => !deleted[eid];
+      index.src = src.filter(keep);
+      index.dst = dst.filter(keep);
+      index.tables = tables.filter(keep);
+      if (index.weights) index.weights = index.weights.filter(keep);
+    }
+
+    if (deletedNodes.length > 0) {
+      const remap: Int32Array = await mod.delete_vertices(
+        handle,
+        Int32Array.from(deletedNodes),
+        version
+      );
+      const entries = [...KuzuToIgraphMap];
+      KuzuToIgraphMap.clear();
+      IgraphToKuzuMap.clear();
+      for (const [kuzuId, oldId] of entries) {
+        const newId = remap[oldId];
+        if (newId < 0) continue;
+        KuzuToIgraphMap.set(kuzuId, newId);
+        IgraphToKuzuMap.set(newId, kuzuId);
+      }
+      // Their edges went first, so every remaining endpoint survives
+      index.src = index.src.map((v) => remap[v]);
+      index.dst = index.dst.map((v) => remap[v]);
+    }
+
+    if (addedNodes.length > 0) {
+      let id = await mod.add_vertices(handle, addedNodes.length, version);
+      for (const node of addedNodes) {
+        KuzuToIgraphMap.set(node.id, id);
+        IgraphToKuzuMap.set(id, node.id);
+        id++;
+      }
+    }
+
+    if (addedEdges.length > 0) {
+      const addedSrc = new Int32Array(addedEdges.length);
+      const addedDst = new Int32Array(addedEdges.length);
+      const hasWeights =
+        index.weights !== null ||
+        addedEdges.some((a) => a.weight !== undefined);
+      const addedWeights = hasWeights
+        ? new Float64Array(addedEdges.length)
+        : undefined;
+      addedEdges.forEach(({ edge, weight }, i) => {
+        addedSrc[i] = KuzuToIgraphMap.get(edge.source)!;
+        addedDst[i] = KuzuToIgraphMap.get(edge.target)!;
+        if (addedWeights) addedWeights[i] = weight ?? 0;
+      });
+      await mod.add_edges(handle, addedSrc, addedDst, addedWeights, version);
+
+      if (addedWeights && !index.weights) {
+        index.weights = new Array<number>(index.src.length).fill(0);
+      }
+      for (let i = 0; i < addedEdges.length; i++) {
+        index.src.push(addedSrc[i]);
+        index.dst.push(addedDst[i]);
+        index.tables.push(addedEdges[i].edge.tableName);
+        if (index.weights && addedWeights) {
+          index.weights.push(addedWeights[i]);
+        }
+      }
+    }
+
+    // Node objects are what results map back to, in every direction
+    const nodesMaps = new Set([nodesMap]);
+    for (const cached of this._parseCache.values()) {
+      nodesMaps.add(cached.nodesMap);
+    }
+    for (const map of nodesMaps) {
+      for (const [kuzuId, node] of nodeStates) {
+        if (node) map.set(kuzuId, node);
+        else map.delete(kuzuId);
+      }
+    }
+
+    if (structural > 0) {
+      // The other direction's graph is now stale and will be rebuilt on
+      // demand
+      this._edgeIndex.clear();
+      this._parseCache.clear();
+      this._parseCache.set(directed, parseResult);
+      this._patchedParseResults.add(parseResult);
+    }
+    this._edgeIndex.set(directed, index);
+    this._graphVersion = version;
+    return true;
+  }
+
+  // Edge index of a resident graph uploaded from the current snapshot, or
+  // null if that snapshot is gone
+  private _buildEdgeIndex(
+    parseResult: KuzuToIgraphParseResult
+  ): EdgeIndex | null {
+    const edges = this._residentEdges;
+    const { src, dst, weight } = parseResult.IgraphInput;
+    if (!edges || edges.length !== src.length) return null;
+    return {
+      src: Array.from(src),
+      dst: Array.from(dst),
+      tables: edges.map((e) => e.tableName),
+      weights: weight ? Array.from(weight) : null,
+    };
+  }
+
+  // Exports the resident graph's attributes column by column (one typed
+  // array per attribute) instead of one object per node or edge
+  async graphColumns(): Promise<{ nodes: NodeColumns; edges: EdgeColumns }> {
+    this.checkInitialization();
+
+    const { handle } = await this._prepareGraphData();
+    return {
+      nodes: await this._wasmGraphModule.graph_node_columns(handle),
+      edges: await this._wasmGraphModule.graph_edge_columns(handle),
+    };
+  }
+
+  // Imports typed attribute columns (one value per igraph vertex or edge ID)
+  // into the resident graph in one call. They live next to the graph and are
+  // dropped when it is rebuilt from a new snapshot.
+  async importAttributes(
+    kind: AttributeKind,
+    columns: Record<string, TypedAttributeInput>
+  ): Promise<void> {
+    this.checkInitialization();
+
+    const { handle } = await this._prepareGraphData();
+    await this._wasmGraphModule.import_attributes(handle, kind, columns);
+  }
+
+  // Kuzu IDs of the nodes whose numeric typed attribute lies in [min, max]
+  async filterNodesByAttribute(
+    name: string,
+    min: number,
+    max: number
+  ): Promise<string[]> {
+    this.checkInitialization();
+
+    const { handle, IgraphToKuzuMap } = await this._prepareGraphData();
+    const ids: Int32Array = await this._wasmGraphModule.filter_by_attribute(
+      handle,
+      "vertex",
+      name,
+      min,
+      max
+    );
+    return Array.from(ids, (id) => IgraphToKuzuMap.get(id) ?? String(id));
+  }
+
+  // Progress of the running algorithm, or of the last one once it is done.
+  // With the module in the worker this can be polled while it runs; on this
+  // thread only from an onProgress callback.
+  progress(): AlgorithmProgress {
+    this.checkInitialization();
+
+    if (this._worker) return this._worker.progress();
+
+    const cells: Float64Array = this._wasmGraphModule.progress_view();
+    return {
+      percent: cells[0],
+      elapsedMs: cells[1],
+      etaMs: cells[2],
+      running: cells[3] !== 0,
+    };
+  }
+
+  // Asks the running algorithm to stop; its call then rejects with an
+  // AlgorithmCancelledError. A run still taking its snapshot or uploading
+  // stops before its kernel. With the module on this thread, return true
+  // from an onProgress callback instead.
+  cancel() {
+    this.checkInitialization();
+
+    for (const run of this._preparingRuns) run.cancelled = true;
+    this._preparingRuns.clear();
+
+    if (this._worker) {
+      this._worker.cancel();
+      return;
+    }
+
+    const flag: Int32Array = this._wasmGraphModule.cancel_view();
+    if (
+      typeof SharedArrayBuffer !== "undefined" &&
+      flag.buffer instanceof SharedArrayBuffer
+    ) {
+      Atomics.store(flag, 0, 1);
+    } else {
+      this._wasmGraphModule.request_cancel();
+    }
+  }
+
+  // Registers a callback run as the algorithm advances (throttled to whole
+  // percents and 100 ms); null removes it. With the module in the worker it
+  // runs here once the report arrives, otherwise on the algorithm's thread.
+  onProgress(callback: ProgressCallback | null) {
     this.checkInitialization();
 
-    const kuzuData = await this._getKuzuData();
-    const direction = this._getDirection();
-    const parseResult = parseKuzuToIgraphInput(
-      kuzuData.nodes,
-      kuzuData.edges,
-      direction
+    if (this._worker) {
+      this._worker.onProgress(
+        callback &&
+          ((progress, message) => {
+            if (callback(progress, message) === true) this.cancel();
+          })
+      );
+      return;
+    }
+
+    if (!callback) {
+      this._wasmGraphModule.set_progress_callback(null);
+      return;
+    }
+    this._wasmGraphModule.set_progress_callback(
+      (percent: number, etaMs: number, message: string) => {
+        const progress = { ...this.progress(), percent, etaMs };
+        return callback(progress, message) === true;
+      }
     );
+  }
+
+  // Starts a run: clears the cancel flag a previous run may have left set,
+  // then prepares its graph. A cancel raised meanwhile, or the worker
+  // restart it caused, rejects with AlgorithmCancelledError.
+  private async _prepareRun(
+    prepare: () => Promise<ResidentGraphData>
+  ): Promise<ResidentGraphData> {
+    this.checkInitialization();
+
+    if (this._worker) this._worker.clearCancel();
+    else this._wasmGraphModule.clear_cancel();
+
+    const run = { cancelled: false };
+    this._preparingRuns.add(run);
+    try {
+      const graphData = await prepare();
+      if (run.cancelled) throw new AlgorithmCancelledError();
+      return graphData;
+    } catch (e) {
+      if (e instanceof Error && e.message === "Cancelled") {
+        throw new AlgorithmCancelledError();
+      }
+      throw e;
+    } finally {
+      this._preparingRuns.delete(run);
+    }
+  }
+
+  // Centralized data preparation - only called when needed
+  private async _prepareGraphData(): Promise<ResidentGraphData> {
+    this.checkInitialization();
 
-    const igraphInput = parseResult.IgraphInput;
-    await this._wasmGraphModule.cleanupGraph();
-    await this._wasmGraphModule.create_graph_from_kuzu_to_igraph(
-      igraphInput.nodes,
-      igraphInput.src,
-      igraphInput.dst,
-      igraphInput.directed,
-      igraphInput.weight
+    return await this._prepareRun(() =>
+      this._residentGraphData(this._getDirection())
     );
-    return parseResult;
   }
 
   // @ts-ignore: used via side-effecting calls
@@ -202,7 +861,7 @@ export class IgraphController {
     }
   }
 
-  private async _prepareGraphDataWithoutDirection(): Promise<KuzuToIgraphParseResult> {
+  private async _prepareGraphDataWithoutDirection(): Promise<ResidentGraphData> {
     this.checkInitialization();
 
     const directed = this._getDirection();
@@ -216,23 +875,74 @@ export class IgraphController {
       );
     }
 
-    const kuzuData = await this._getKuzuData();
-    const parseResult = parseKuzuToIgraphInput(
-      kuzuData.nodes,
-      kuzuData.edges,
-      false
+    return await this._prepareRun(() =>
+      directed ? this._undirectedProjection() : this._residentGraphData(false)
     );
+  }
+
+  // Collapses reciprocal edges of a directed graph into one undirected edge.
+  // Weights of collapsed edges are merged with this rule ("sum" by default).
+  setUndirectedWeightMerge(merge: WeightMerge) {
+    this._weightMerge = merge;
+  }
 
-    const igraphInput = parseResult.IgraphInput;
-    await this._wasmGraphModule.cleanupGraph();
-    await this._wasmGraphModule.create_graph_from_kuzu_to_igraph(
-      igraphInput.nodes,
-      igraphInput.src,
-      igraphInput.dst,
-      igraphInput.directed,
-      igraphInput.weight
+  // Renumbers the vertices of the CSR snapshot that every native kernel
+  // (centralities, spectral methods, routing, BFS) traverses, for every
+  // resident graph. Results are mapped back inside WASM, so IgraphToKuzuMap
+  // is unaffected.
+  async setVertexOrder(order: VertexOrder): Promise<void> {
+    this.checkInitialization();
+
+    this._vertexOrder = order;
+    const handles = [...this._handles.values()];
+    if (this._projectionHandle !== null) handles.push(this._projectionHandle);
+    for (const handle of handles) {
+      await this._wasmGraphModule.set_vertex_order(handle, order);
+    }
+  }
+
+  // Reordering cost versus kernel time per order for the current direction
+  async vertexOrderStats(): Promise<VertexOrderStats> {
+    this.checkInitialization();
+
+    const directed = this._getDirection();
+    const handle = await this._queueResidency(() =>
+      this._graphHandle(directed)
     );
-    return parseResult;
+    return await this._wasmGraphModule.vertex_order_stats(handle);
+  }
+
+  // Derives the undirected graph from the resident directed one inside WASM,
+  // once per graph version and weight merge, instead of re-parsing and
+  // uploading the snapshot a second time
+  private _undirectedProjection(): Promise<ResidentGraphData> {
+    return this._queueResidency(() => this._loadUndirectedProjection());
+  }
+
+  private async _loadUndirectedProjection(): Promise<ResidentGraphData> {
+    this.checkInitialization();
+
+    const graphData = await this._loadResidentGraph(true);
+
+    const mod = this._wasmGraphModule;
+    if (this._projectionHandle === null) {
+      const created = await mod.create_graph_handle();
+      await mod.set_vertex_order(created, this._vertexOrder);
+      this._projectionHandle = created;
+    }
+    const handle = this._projectionHandle;
+    if (
+      this._projectionMerge !== this._weightMerge ||
+      !(await mod.graph_is_resident(handle, this._graphVersion, false))
+    ) {
+      await mod.create_undirected_projection(
+        graphData.handle,
+        handle,
+        this._weightMerge
+      );
+      this._projectionMerge = this._weightMerge;
+    }
+    return { ...graphData, handle };
   }
 
   // ==========================================
@@ -315,6 +1025,57 @@ export class IgraphController {
     );
   }
 
+  // A* with landmark lower bounds; the first query builds the landmark
+  // tables, later ones on the same graph reuse them
+  async aStarAToB(
+    start: string,
+    end: string,
+    landmarks: number = 8
+  ): Promise<AStarResult> {
+    this.checkInitialization();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphAStar(
+      this._wasmGraphModule,
+      graphData,
+      start,
+      end,
+      landmarks
+    );
+  }
+
+  // Preprocesses the graph into a contraction hierarchy so later Dijkstra
+  // and Bellman-Ford A-to-B queries take microseconds; kept until the graph
+  // or its weights change
+  async buildShortestPathIndex(): Promise<ShortestPathIndexStats> {
+    this.checkInitialization();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphBuildShortestPathIndex(
+      this._wasmGraphModule,
+      graphData
+    );
+  }
+
+  // Distances (and optionally paths) for pairs (sources[i], targets[i]) in
+  // one WASM call, with one search per distinct source
+  async shortestPathPairs(
+    sources: string[],
+    targets: string[],
+    options: ShortestPathPairsOptions = {}
+  ): Promise<ShortestPathPairsResult> {
+    this.checkInitialization();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphShortestPathPairs(
+      this._wasmGraphModule,
+      graphData,
+      sources,
+      targets,
+      options
+    );
+  }
+
   async dijkstraAToAll(start: string): Promise<DijkstraAToAllResult> {
     this.checkInitialization();
 
@@ -348,6 +1109,23 @@ export class IgraphController {
     );
   }
 
+  // Single-source shortest paths as a shortest-path tree (typed predecessor
+  // and distance arrays) for large graphs; paths are rebuilt on demand
+  async shortestPathTree(
+    start: string,
+    algorithm: ShortestPathTreeAlgorithm = "dijkstra"
+  ): Promise<ShortestPathTreeResult> {
+    this.checkInitialization();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphShortestPathTree(
+      this._wasmGraphModule,
+      graphData,
+      start,
+      algorithm
+    );
+  }
+
   async randomWalk(start: string, steps: number): Promise<RandomWalkResult> {
     this.checkInitialization();
 
@@ -410,6 +1188,25 @@ export class IgraphController {
     return await igraphBetweennessCentrality(this._wasmGraphModule, graphData);
   }
 
+  // Sampled betweenness: every normalized score is within epsilon of the
+  // exact one with probability 1 - delta. The same seed gives the same scores.
+  async approximateBetweennessCentrality(
+    epsilon: number,
+    delta: number = 0.1,
+    seed: number = 1
+  ): Promise<ApproximateBetweennessResult> {
+    this.checkInitialization();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphApproximateBetweenness(
+      this._wasmGraphModule,
+      graphData,
+      epsilon,
+      delta,
+      seed
+    );
+  }
+
   async closenessCentrality(): Promise<ClosenessCentralityResult> {
     this.checkInitialization();
 
@@ -424,11 +1221,47 @@ export class IgraphController {
     return await igraphDegreeCentrality(this._wasmGraphModule, graphData);
   }
 
-  async eigenvectorCentrality(): Promise<EigenvectorCentralityResult> {
+  async eigenvectorCentrality(
+    options?: SpectralOptions
+  ): Promise<EigenvectorCentralityResult> {
     this.checkInitialization();
 
     const graphData = await this._prepareGraphData();
-    return await igraphEigenvectorCentrality(this._wasmGraphModule, graphData);
+    const result = await igraphEigenvectorCentrality(
+      this._wasmGraphModule,
+      graphData,
+      options
+    );
+    // e.g. all zeros on a directed acyclic graph, as igraph reports them
+    if (result.data.warning) toast.warning(result.data.warning);
+    return result;
+  }
+
+  // Katz centrality; alpha must be below 1 / the largest eigenvalue of the
+  // adjacency matrix
+  async katzCentrality(
+    alpha: number,
+    beta: number = 1,
+    options?: SpectralOptions
+  ): Promise<KatzCentralityResult> {
+    this.checkInitialization();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphKatzCentrality(
+      this._wasmGraphModule,
+      graphData,
+      alpha,
+      beta,
+      options
+    );
+  }
+
+  // Hub and authority scores
+  async hits(options?: SpectralOptions): Promise<HitsResult> {
+    this.checkInitialization();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphHits(this._wasmGraphModule, graphData, options);
   }
 
   async harmonicCentrality(): Promise<HarmonicCentralityResult> {
@@ -445,13 +1278,59 @@ export class IgraphController {
     return await igraphStrengthCentrality(this._wasmGraphModule, graphData);
   }
 
-  async pageRank(damping: number): Promise<PageRankResult> {
+  async pageRank(
+    damping: number,
+    options?: SpectralOptions
+  ): Promise<PageRankResult> {
     this.checkInitialization();
 
     this._assertsDirected();
 
     const graphData = await this._prepareGraphData();
-    return await igraphPageRank(this._wasmGraphModule, graphData, damping);
+    return await igraphPageRank(
+      this._wasmGraphModule,
+      graphData,
+      damping,
+      options
+    );
+  }
+
+  // PageRank relative to the seed nodes, top-k only; cheap enough to run per
+  // selection on large graphs once the CSR snapshot exists
+  async personalizedPageRank(
+    kuzuSeedIDs: string[],
+    options?: PersonalizedPageRankOptions
+  ): Promise<PersonalizedPageRankResult> {
+    this.checkInitialization();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphPersonalizedPageRank(
+      this._wasmGraphModule,
+      graphData,
+      kuzuSeedIDs,
+      options
+    );
+  }
+
+  // Columnar variant of the centrality methods above for large graphs:
+  // typed-array scores/sizes plus summary scalars, rows built on demand
+  async centralityColumns(
+    algorithm: CentralityAlgorithm,
+    damping?: number,
+    options?: SpectralOptions
+  ): Promise<CentralityColumnsResult> {
+    this.checkInitialization();
+
+    if (algorithm === "pagerank") this._assertsDirected();
+
+    const graphData = await this._prepareGraphData();
+    return await igraphCentralityColumns(
+      this._wasmGraphModule,
+      graphData,
+      algorithm,
+      damping,
+      options
+    );
   }
 
   // ==========================================
@@ -0,0 +1,66 @@
+import type {
+  BaseGraphAlgorithmResult,
+  GraphModule,
+  ResidentGraphData,
+} from "../../types";
+import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+
+import { _parseCentralities, type CentralityItem } from "./util";
+
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+import type { GraphNode } from "~/features/visualizer/types";
+
+export type ApproximateBetweennessOutputData<T = string> = {
+  algorithm: string;
+  epsilon: number; // requested error on normalized scores
+  delta: number; // allowed failure probability
+  seed: number;
+  exact: boolean; // true when exact scores were cheaper than sampling
+  samples: number; // shortest paths sampled
+  vertexDiameterBound: number;
+  errorBound: number; // achieved error on normalized scores, <= epsilon
+  scoreErrorBound: number; // the same bound on the displayed scores
+  centralities: CentralityItem<T>[];
+};
+
+export type ApproximateBetweennessResult<T = string> =
+  BaseGraphAlgorithmResult & {
+    data: ApproximateBetweennessOutputData<T>;
+  };
+
+function _parseResult(
+  IgraphToKuzu: Map<number, string>,
+  nodesMap: Map<string, GraphNode>,
+  algorithmResult: ApproximateBetweennessResult<number>
+): ApproximateBetweennessResult {
+  const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
+
+  const { data, mode, colorMap = {}, sizeMap = {} } = algorithmResult;
+
+  return {
+    mode,
+    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    sizeMap: mapColorMapIds(sizeMap, mapIdBack),
+    data: {
+      ...data,
+      centralities: _parseCentralities(data.centralities, mapLabelBack),
+    },
+  };
+}
+
+export async function igraphApproximateBetweenness(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData,
+  epsilon: number,
+  delta: number,
+  seed: number
+): Promise<ApproximateBetweennessResult> {
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.approximate_betweenness(graphData.handle, epsilon, delta, seed, false)
+  );
+  return _parseResult(
+    graphData.IgraphToKuzuMap,
+    graphData.nodesMap,
+    wasmResult
+  );
+}
@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -42,10 +42,10 @@ function _parseResult(
 
 export async function igraphBetweennessCentrality(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<BetweennessCentralityResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.betweenness_centrality()
+    m.betweenness_centrality(graphData.handle, false)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -0,0 +1,97 @@
+import type {
+  BaseGraphAlgorithmResult,
+  GraphModule,
+  ResidentGraphData,
+  SpectralIterationData,
+  SpectralOptions,
+} from "../../types";
+import { createMapIdBack } from "../../utils/mapIdBack";
+
+import {
+  _centralityRows,
+  _rankCentralities,
+  type CentralityColumns,
+  type CentralityItem,
+} from "./util";
+
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+import type { GraphNode } from "~/features/visualizer/types";
+
+export type CentralityAlgorithm =
+  | "betweenness_centrality"
+  | "closeness_centrality"
+  | "degree_centrality"
+  | "eigenvector_centrality"
+  | "harmonic_centrality"
+  | "strength_centrality"
+  | "pagerank";
+
+export type CentralityColumnsOutputData = CentralityColumns &
+  Partial<SpectralIterationData> & {
+    algorithm: string;
+    eigenvalue?: number; // eigenvector centrality only
+    damping?: string; // PageRank only
+  };
+
+export type CentralityColumnsResult = BaseGraphAlgorithmResult & {
+  data: CentralityColumnsOutputData;
+  // Vertex IDs ordered by descending score
+  ranking: () => Uint32Array;
+  // Display rows for the given vertex IDs, e.g. a visible slice of ranking()
+  rows: (ids: ArrayLike<number>) => CentralityItem[];
+};
+
+function _parseResult(
+  IgraphToKuzu: Map<number, string>,
+  nodesMap: Map<string, GraphNode>,
+  algorithmResult: BaseGraphAlgorithmResult & {
+    data: CentralityColumnsOutputData;
+  }
+): CentralityColumnsResult {
+  const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
+
+  const { data, mode } = algorithmResult;
+
+  // The renderer looks node sizes up by Kuzu ID
+  const sizeMap: Record<string, number> = {};
+  for (let v = 0; v < data.sizes.length; v++) {
+    sizeMap[mapIdBack(v)] = data.sizes[v];
+  }
+
+  let ranking: Uint32Array | null = null;
+  return {
+    mode,
+    colorMap: {},
+    sizeMap,
+    data,
+    ranking: () => (ranking ??= _rankCentralities(data.scores)),
+    rows: (ids) => _centralityRows(data, ids, mapLabelBack),
+  };
+}
+
+// Runs a centrality algorithm in columnar mode: scores and sizes come back as
+// Float64Arrays instead of one object per vertex, and rows are only built
+// (and rounded) for the vertices the caller asks for. `options` applies to
+// PageRank and eigenvector centrality.
+export async function igraphCentralityColumns(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData,
+  algorithm: CentralityAlgorithm,
+  damping: number = 0.85,
+  options?: SpectralOptions
+): Promise<CentralityColumnsResult> {
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) => {
+    if (algorithm === "pagerank") {
+      return m.pagerank(graphData.handle, damping, true, options);
+    }
+    if (algorithm === "eigenvector_centrality") {
+      return m.eigenvector_centrality(graphData.handle, true, options);
+    }
+    return m[algorithm](graphData.handle, true);
+  });
+  return _parseResult(
+    graphData.IgraphToKuzuMap,
+    graphData.nodesMap,
+    wasmResult
+  );
+}
@@ -1,7 +1,9 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  SpectralIterationData,
+  SpectralOptions,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -10,11 +12,12 @@ import { _parseCentralities, type CentralityItem } from "./util";
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
 
-export type EigenvectorCentralityOutputData<T = string> = {
-  algorithm: string;
-  eigenvalue: number;
-  centralities: CentralityItem<T>[];
-};
+export type EigenvectorCentralityOutputData<T = string> =
+  SpectralIterationData & {
+    algorithm: string;
+    eigenvalue: number;
+    centralities: CentralityItem<T>[];
+  };
 
 export type EigenvectorCentralityResult<T = string> =
   BaseGraphAlgorithmResult & {
@@ -35,6 +38,7 @@ function _parseResult(
     colorMap: mapColorMapIds(colorMap, mapIdBack),
     sizeMap: mapColorMapIds(sizeMap, mapIdBack),
     data: {
+      ...data,
       algorithm: data.algorithm ?? "Eigenvector Centrality",
       eigenvalue: data.eigenvalue ?? 0,
       centralities: _parseCentralities(data.centralities, mapLabelBack),
@@ -44,10 +48,11 @@ function _parseResult(
 
 export async function igraphEigenvectorCentrality(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData,
+  options?: SpectralOptions
 ): Promise<EigenvectorCentralityResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.eigenvector_centrality()
+    m.eigenvector_centrality(graphData.handle, false, options)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
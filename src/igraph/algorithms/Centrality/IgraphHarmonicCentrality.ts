@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -41,10 +41,10 @@ function _parseResult(
 
 export async function igraphHarmonicCentrality(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<HarmonicCentralityResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.harmonic_centrality()
+    m.harmonic_centrality(graphData.handle, false)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -0,0 +1,69 @@
+import type {
+  BaseGraphAlgorithmResult,
+  GraphModule,
+  ResidentGraphData,
+  SpectralIterationData,
+  SpectralOptions,
+} from "../../types";
+import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+
+import { _parseCentralities, type CentralityItem } from "./util";
+
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+import type { GraphNode } from "~/features/visualizer/types";
+
+// Authority scores are the centralities (and node sizes); hub scores come
+// alongside. Both are scaled to a maximum of 1.
+export type HitsOutputData<T = string> = SpectralIterationData & {
+  algorithm: string;
+  eigenvalue: number;
+  centralities: CentralityItem<T>[];
+  hubs: CentralityItem<T>[];
+};
+
+export type HitsResult<T = string> = BaseGraphAlgorithmResult & {
+  data: HitsOutputData<T>;
+};
+
+type WasmHitsResult = BaseGraphAlgorithmResult & {
+  data: Omit<HitsOutputData<number>, "hubs"> & { hubs: Float64Array };
+};
+
+function _parseResult(
+  IgraphToKuzu: Map<number, string>,
+  nodesMap: Map<string, GraphNode>,
+  algorithmResult: WasmHitsResult
+): HitsResult {
+  const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
+
+  const { data, mode, colorMap = {}, sizeMap = {} } = algorithmResult;
+
+  return {
+    mode,
+    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    sizeMap: mapColorMapIds(sizeMap, mapIdBack),
+    data: {
+      ...data,
+      centralities: _parseCentralities(data.centralities, mapLabelBack),
+      hubs: Array.from(data.hubs, (score, v) => ({
+        node: mapLabelBack(v),
+        centrality: Number(score.toFixed(4)),
+      })),
+    },
+  };
+}
+
+export async function igraphHits(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData,
+  options?: SpectralOptions
+): Promise<HitsResult> {
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.hits(graphData.handle, false, options)
+  );
+  return _parseResult(
+    graphData.IgraphToKuzuMap,
+    graphData.nodesMap,
+    wasmResult
+  );
+}
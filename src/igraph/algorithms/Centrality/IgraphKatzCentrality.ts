@@ -0,0 +1,61 @@
+import type {
+  BaseGraphAlgorithmResult,
+  GraphModule,
+  ResidentGraphData,
+  SpectralIterationData,
+  SpectralOptions,
+} from "../../types";
+import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+
+import { _parseCentralities, type CentralityItem } from "./util";
+
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+import type { GraphNode } from "~/features/visualizer/types";
+
+export type KatzCentralityOutputData<T = string> = SpectralIterationData & {
+  algorithm: string;
+  alpha: number; // attenuation per hop, below 1 / the largest eigenvalue
+  beta: number; // score every vertex starts with
+  centralities: CentralityItem<T>[];
+};
+
+export type KatzCentralityResult<T = string> = BaseGraphAlgorithmResult & {
+  data: KatzCentralityOutputData<T>;
+};
+
+function _parseResult(
+  IgraphToKuzu: Map<number, string>,
+  nodesMap: Map<string, GraphNode>,
+  algorithmResult: KatzCentralityResult<number>
+): KatzCentralityResult {
+  const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
+
+  const { data, mode, colorMap = {}, sizeMap = {} } = algorithmResult;
+
+  return {
+    mode,
+    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    sizeMap: mapColorMapIds(sizeMap, mapIdBack),
+    data: {
+      ...data,
+      centralities: _parseCentralities(data.centralities, mapLabelBack),
+    },
+  };
+}
+
+export async function igraphKatzCentrality(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData,
+  alpha: number,
+  beta: number,
+  options?: SpectralOptions
+): Promise<KatzCentralityResult> {
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.katz_centrality(graphData.handle, alpha, beta, false, options)
+  );
+  return _parseResult(
+    graphData.IgraphToKuzuMap,
+    graphData.nodesMap,
+    wasmResult
+  );
+}
@@ -1,7 +1,9 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  SpectralIterationData,
+  SpectralOptions,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -10,7 +12,7 @@ import { _parseCentralities, type CentralityItem } from "./util";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
 import type { GraphNode } from "~/features/visualizer/types";
 
-export type PageRankOutputData<T = string> = {
+export type PageRankOutputData<T = string> = SpectralIterationData & {
   algorithm: string;
   damping: string;
   centralities: CentralityItem<T>[];
@@ -34,8 +36,7 @@ function _parseResult(
     colorMap: mapColorMapIds(colorMap, mapIdBack),
     sizeMap: mapColorMapIds(sizeMap, mapIdBack),
     data: {
-      algorithm: data.algorithm,
-      damping: data.damping,
+      ...data,
       centralities: _parseCentralities(data.centralities, mapLabelBack),
     },
   };
@@ -43,11 +44,12 @@ function _parseResult(
 
 export async function igraphPageRank(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
-  damping: number
+  graphData: ResidentGraphData,
+  damping: number,
+  options?: SpectralOptions
 ): Promise<PageRankResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.pagerank(damping)
+    m.pagerank(graphData.handle, damping, false, options)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
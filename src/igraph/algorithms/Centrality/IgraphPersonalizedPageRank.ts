@@ -0,0 +1,80 @@
+import type {
+  BaseGraphAlgorithmResult,
+  GraphModule,
+  ResidentGraphData,
+  WithHighlight,
+} from "../../types";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
+
+import type { GraphNode } from "~/features/visualizer/types";
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+
+export type PersonalizedPageRankOptions = {
+  damping?: number; // default 0.85
+  epsilon?: number; // residual threshold per unit of out-degree, default 1e-5
+  k?: number; // top scores returned, default 100; 0 for every vertex reached
+};
+
+// Inferred from src/wasm/algorithms/centrality.cpp (personalized_pagerank)
+export type PersonalizedPageRankOutputData = {
+  algorithm: string;
+  damping: number;
+  epsilon: number;
+  vertices: Int32Array; // igraph IDs by decreasing score
+  scores: Float64Array; // parallel to vertices
+  nodes: string[]; // labels of vertices
+  pushes: number;
+  touched: number; // vertices the walk reached
+  residual: number; // probability mass not pushed, bounds the total error
+};
+
+export type PersonalizedPageRankResult = BaseGraphAlgorithmResult & {
+  data: PersonalizedPageRankOutputData;
+};
+
+function _parseResult(
+  IgraphToKuzu: Map<number, string>,
+  nodesMap: Map<string, GraphNode>,
+  algorithmResult: WithHighlight<
+    BaseGraphAlgorithmResult & {
+      data: Omit<PersonalizedPageRankOutputData, "nodes">;
+    }
+  >
+): PersonalizedPageRankResult {
+  const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
+
+  const { data, mode, highlight } = algorithmResult;
+
+  return {
+    mode,
+    ...mapHighlightIds(highlight, mapIdBack),
+    data: { ...data, nodes: Array.from(data.vertices, mapLabelBack) },
+  };
+}
+
+// PageRank restarting at the given nodes, computed by local forward push:
+// the cost follows the neighbourhood the walk reaches, not the graph size
+export async function igraphPersonalizedPageRank(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData,
+  kuzuSeedIDs: string[],
+  { damping = 0.85, epsilon = 1e-5, k = 100 }: PersonalizedPageRankOptions = {}
+): Promise<PersonalizedPageRankResult> {
+  const seeds = new Int32Array(kuzuSeedIDs.length);
+  kuzuSeedIDs.forEach((id, i) => {
+    const seed = graphData.KuzuToIgraphMap.get(id);
+    if (seed == null) {
+      throw new Error(`Seed node "${id}" not found in graph data`);
+    }
+    seeds[i] = seed;
+  });
+
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.personalized_pagerank(graphData.handle, seeds, damping, epsilon, k)
+  );
+  return _parseResult(
+    graphData.IgraphToKuzuMap,
+    graphData.nodesMap,
+    wasmResult
+  );
+}
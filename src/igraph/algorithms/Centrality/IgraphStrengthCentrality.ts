@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -41,10 +41,10 @@ function _parseResult(
 
 export async function igraphStrengthCentrality(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<StrengthCentralityResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.strength_centrality()
+    m.strength_centrality(graphData.handle, false)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
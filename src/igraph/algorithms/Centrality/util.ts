@@ -12,3 +12,46 @@ export const _parseCentralities = (
     centrality: centrality.centrality,
   }));
 };
+
+// Columnar centrality result: one entry per igraph vertex ID
+export type CentralityColumns = {
+  scores: Float64Array; // raw, unrounded scores
+  sizes: Float64Array; // node sizes scaled for rendering
+  count: number;
+  min: number; // summary over the non-NaN scores
+  max: number;
+  mean: number;
+  precision: number; // digits the algorithm's scores are displayed with
+};
+
+// Vertex IDs ordered by descending score (NaN last), for paging through the
+// columns without materializing a row per vertex
+export const _rankCentralities = (scores: Float64Array): Uint32Array => {
+  const order = new Uint32Array(scores.length);
+  for (let i = 0; i < order.length; i++) order[i] = i;
+  return order.sort((a, b) => {
+    const sa = scores[a];
+    const sb = scores[b];
+    if (isNaN(sa)) return isNaN(sb) ? 0 : 1;
+    if (isNaN(sb)) return -1;
+    return sb - sa;
+  });
+};
+
+// Builds display rows for the given vertex IDs only, rounding like the
+// row-per-vertex results do
+export const _centralityRows = (
+  columns: CentralityColumns,
+  ids: ArrayLike<number>,
+  mapLabelBack: (id: string | number) => string
+): CentralityItem[] => {
+  const rows: CentralityItem[] = [];
+  for (let i = 0; i < ids.length; i++) {
+    const id = ids[i];
+    rows.push({
+      node: mapLabelBack(id),
+      centrality: Number(columns.scores[id].toFixed(columns.precision)),
+    });
+  }
+  return rows;
+};
@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -42,9 +42,11 @@ function _parseResult(
 
 export async function igraphFastGreedy(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<FastGreedyResult> {
-  const wasmResult = await _runIgraphAlgo(igraphMod, (m) => m.fast_greedy());
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.fast_greedy(graphData.handle)
+  );
   return _parseResult(
     graphData.IgraphToKuzuMap,
     graphData.nodesMap,
@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -22,15 +23,15 @@ export type KCoreResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: KCoreResult<number>
+  algorithmResult: WithHighlight<KCoreResult<number>>
 ): KCoreResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       k: data.k,
@@ -42,10 +43,12 @@ function _parseResult(
 
 export async function igraphKCore(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   k: number
 ): Promise<KCoreResult> {
-  const wasmResult = await _runIgraphAlgo(igraphMod, (m) => m.k_core(k));
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.k_core(graphData.handle, k)
+  );
   return _parseResult(
     graphData.IgraphToKuzuMap,
     graphData.nodesMap,
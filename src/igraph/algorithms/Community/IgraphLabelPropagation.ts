@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -40,10 +40,10 @@ function _parseResult(
 
 export async function igraphLabelPropagation(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<LabelPropagationResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.label_propagation()
+    m.label_propagation(graphData.handle)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -42,11 +42,11 @@ function _parseResult(
 
 export async function igraphLeiden(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   resolution: number
 ): Promise<LeidenResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.leiden(resolution)
+    m.leiden(graphData.handle, resolution)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
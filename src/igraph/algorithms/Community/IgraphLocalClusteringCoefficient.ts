@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -47,10 +47,10 @@ function _parseResult(
 
 export async function igraphLocalClusteringCoefficient(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<LocalClusteringCoefficientResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.local_clustering_coefficient()
+    m.local_clustering_coefficient(graphData.handle)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -42,11 +42,11 @@ function _parseResult(
 
 export async function igraphLouvain(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   resolution: number
 ): Promise<LouvainResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.louvain(resolution)
+    m.louvain(graphData.handle, resolution)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
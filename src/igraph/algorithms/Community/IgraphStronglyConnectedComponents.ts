@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -40,10 +40,10 @@ function _parseResult(
 
 export async function igraphStronglyConnectedComponents(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<SCCResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.strongly_connected_components()
+    m.strongly_connected_components(graphData.handle)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -25,15 +26,15 @@ export type TriangleCountResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: TriangleCountResult<number>
+  algorithmResult: WithHighlight<TriangleCountResult<number>>
 ): TriangleCountResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       triangles: data.triangles.map((triangle) => ({
@@ -48,9 +49,11 @@ function _parseResult(
 
 export async function igraphTriangles(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<TriangleCountResult> {
-  const wasmResult = await _runIgraphAlgo(igraphMod, (m) => m.triangle_count());
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.triangle_count(graphData.handle)
+  );
   return _parseResult(
     graphData.IgraphToKuzuMap,
     graphData.nodesMap,
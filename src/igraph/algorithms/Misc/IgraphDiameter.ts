@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -28,11 +29,11 @@ export type GraphDiameterResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: GraphDiameterResult<number>
+  algorithmResult: WithHighlight<GraphDiameterResult<number>>
 ): GraphDiameterResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const path = data.path.map(({ from, to, weight }) => ({
     from: mapLabelBack(from),
@@ -42,7 +43,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       source: mapLabelBack(data.source),
@@ -56,9 +57,11 @@ function _parseResult(
 
 export async function igraphDiameter(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<GraphDiameterResult> {
-  const wasmResult = await _runIgraphAlgo(igraphMod, (m) => m.diameter());
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.diameter(graphData.handle)
+  );
   return _parseResult(
     graphData.IgraphToKuzuMap,
     graphData.nodesMap,
@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -24,11 +25,11 @@ export type EulerianCircuitResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: EulerianCircuitResult<number>
+  algorithmResult: WithHighlight<EulerianCircuitResult<number>>
 ): EulerianCircuitResult {
   const { mapLabelBack, mapIdBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const path = data.path.map(({ from, to, weight }) => ({
     from: mapLabelBack(from),
@@ -38,7 +39,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       path,
@@ -48,10 +49,10 @@ function _parseResult(
 
 export async function igraphEulerianCircuit(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<EulerianCircuitResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.eulerian_circuit()
+    m.eulerian_circuit(graphData.handle)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
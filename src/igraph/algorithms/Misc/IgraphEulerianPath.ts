@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -26,11 +27,11 @@ export type EulerianPathResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: EulerianPathResult<number>
+  algorithmResult: WithHighlight<EulerianPathResult<number>>
 ): EulerianPathResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const path = data.path.map(({ from, to, weight }) => ({
     from: mapLabelBack(from),
@@ -40,7 +41,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       start: mapLabelBack(data.start),
@@ -52,9 +53,11 @@ function _parseResult(
 
 export async function igraphEulerianPath(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<EulerianPathResult> {
-  const wasmResult = await _runIgraphAlgo(igraphMod, (m) => m.eulerian_path());
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.eulerian_path(graphData.handle)
+  );
   return _parseResult(
     graphData.IgraphToKuzuMap,
     graphData.nodesMap,
@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -65,7 +65,7 @@ function _parseResult(
 
 export async function igraphJaccardSimilarity(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuNodeIds: string[]
 ): Promise<JaccardSimilarityResult> {
   const igraphIds = mapKuzuIdsToIgraphIds(
@@ -73,7 +73,7 @@ export async function igraphJaccardSimilarity(
     graphData.KuzuToIgraphMap
   );
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.jaccard_similarity(igraphIds)
+    m.jaccard_similarity(graphData.handle, igraphIds)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -25,11 +26,11 @@ export type MissingEdgePredictionResult<T = string> =
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: MissingEdgePredictionResult<number>
+  algorithmResult: WithHighlight<MissingEdgePredictionResult<number>>
 ): MissingEdgePredictionResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const predictedEdges = data.predictedEdges.map(
     ({ from, to, probability }) => ({
@@ -41,7 +42,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       predictedEdges,
@@ -51,12 +52,12 @@ function _parseResult(
 
 export async function igraphMissingEdgePrediction(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   sampleSize: number,
   numBins: number
 ): Promise<MissingEdgePredictionResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.missing_edge_prediction(sampleSize, numBins)
+    m.missing_edge_prediction(graphData.handle, sampleSize, numBins)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
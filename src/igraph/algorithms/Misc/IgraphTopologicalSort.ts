@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -38,10 +38,10 @@ function _parseResult(
 
 export async function igraphTopologicalSort(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<TopologicalSortResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.topological_sort()
+    m.topological_sort(graphData.handle)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
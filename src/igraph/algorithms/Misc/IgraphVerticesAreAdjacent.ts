@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -23,15 +24,15 @@ export type VerticesAreAdjacentResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: VerticesAreAdjacentResult<number>
+  algorithmResult: WithHighlight<VerticesAreAdjacentResult<number>>
 ): VerticesAreAdjacentResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       source: mapLabelBack(data.source),
@@ -44,7 +45,7 @@ function _parseResult(
 
 export async function igraphVerticesAreAdjacent(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string,
   kuzuTargetID: string
 ): Promise<VerticesAreAdjacentResult> {
@@ -58,7 +59,7 @@ export async function igraphVerticesAreAdjacent(
   }
 
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.vertices_are_adjacent(sourceIgraphId, targetIgraphId)
+    m.vertices_are_adjacent(graphData.handle, sourceIgraphId, targetIgraphId)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
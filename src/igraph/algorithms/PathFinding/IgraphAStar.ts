@@ -0,0 +1,89 @@
+import type {
+  BaseGraphAlgorithmResult,
+  GraphModule,
+  ResidentGraphData,
+  WithHighlight,
+} from "../../types";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
+
+import type { GraphNode } from "~/features/visualizer/types";
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+
+// Inferred from src/wasm/algorithms/path-finding.cpp (astar_source_to_target)
+export type AStarOutputData<T = string> = {
+  algorithm: string;
+  source: T;
+  target: T;
+  weighted: boolean;
+  path: { from: T; to: T; weight?: number }[];
+  totalWeight?: number;
+  settled?: number; // vertices the search settled
+  landmarks?: number;
+  landmarksBuilt?: boolean; // this query built the landmark tables
+  landmarkMs?: number; // time it took to build them
+  landmarkBytes?: number; // memory they occupy
+};
+
+export type AStarResult<T = string> = BaseGraphAlgorithmResult & {
+  data: AStarOutputData<T>;
+};
+
+function _parseResult(
+  IgraphToKuzu: Map<number, string>,
+  nodesMap: Map<string, GraphNode>,
+  algorithmResult: WithHighlight<AStarResult<number>>
+): AStarResult {
+  const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
+
+  const { data, mode, highlight } = algorithmResult;
+
+  const path = data.path.map(({ from, to, weight }) => ({
+    from: mapLabelBack(from),
+    to: mapLabelBack(to),
+    weight: weight != null ? Number(weight) : 0,
+  }));
+
+  return {
+    mode,
+    ...mapHighlightIds(highlight, mapIdBack),
+    data: {
+      ...data,
+      source: mapLabelBack(data.source),
+      target: mapLabelBack(data.target),
+      path,
+    },
+  };
+}
+
+// A* with landmark bounds (ALT). The landmark tables are built by the first
+// query and kept until the graph or its weights change.
+export async function igraphAStar(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData,
+  kuzuSourceID: string,
+  kuzuTargetID: string,
+  landmarks: number
+): Promise<AStarResult> {
+  const startIgraphId = graphData.KuzuToIgraphMap.get(kuzuSourceID);
+  const endIgraphId = graphData.KuzuToIgraphMap.get(kuzuTargetID);
+
+  if (startIgraphId == null || endIgraphId == null) {
+    throw new Error(
+      `Source node "${kuzuSourceID}" or target node "${kuzuTargetID}" not found in graph data`
+    );
+  }
+
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.astar_source_to_target(
+      graphData.handle,
+      startIgraphId,
+      endIgraphId,
+      landmarks
+    )
+  );
+  return _parseResult(
+    graphData.IgraphToKuzuMap,
+    graphData.nodesMap,
+    wasmResult
+  );
+}
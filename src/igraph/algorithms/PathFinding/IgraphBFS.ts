@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -12,7 +12,13 @@ export type BFSOutputData<T = string> = {
   algorithm: string;
   source: T;
   nodesFound: number;
-  layers: { layer: T[]; index: number }[];
+  // Vertices of a layer are sorted by igraph ID; direction is the step of
+  // the direction-optimizing BFS that found the layer
+  layers: {
+    layer: T[];
+    index: number;
+    direction: "top-down" | "bottom-up";
+  }[];
 };
 
 export type BFSResult<T = string> = BaseGraphAlgorithmResult & {
@@ -36,6 +42,7 @@ function _parseResult(
       layers: algorithmResult.data.layers.map((l) => ({
         layer: l.layer.map((x) => mapLabelBack(x)),
         index: l.index,
+        direction: l.direction,
       })),
     },
   };
@@ -43,7 +50,7 @@ function _parseResult(
 
 export async function igraphBFS(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string
 ): Promise<BFSResult> {
   let igraphID: number | undefined =
@@ -53,7 +60,9 @@ export async function igraphBFS(
     throw new Error(`Source node "${kuzuSourceID}" not found in graph data`);
   }
 
-  const wasmResult = await _runIgraphAlgo(igraphMod, (m) => m.bfs(igraphID));
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.bfs(graphData.handle, igraphID)
+  );
   return _parseResult(
     graphData.IgraphToKuzuMap,
     graphData.nodesMap,
@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
 import type { GraphNode } from "~/features/visualizer/types";
@@ -24,11 +25,11 @@ export type BellmanFordAToAllResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: BellmanFordAToAllResult<number>
+  algorithmResult: WithHighlight<BellmanFordAToAllResult<number>>
 ): BellmanFordAToAllResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const paths = data.paths.map((pathObj) => ({
     target: mapLabelBack(pathObj.target),
@@ -38,7 +39,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       source: mapLabelBack(data.source),
@@ -50,7 +51,7 @@ function _parseResult(
 
 export async function igraphBellmanFordAToAll(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string
 ): Promise<BellmanFordAToAllResult> {
   const startIgraphId = graphData.KuzuToIgraphMap.get(kuzuSourceID);
@@ -60,7 +61,7 @@ export async function igraphBellmanFordAToAll(
   }
 
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.bellman_ford_source_to_all(startIgraphId)
+    m.bellman_ford_source_to_all(graphData.handle, startIgraphId, false)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
 import type { GraphNode } from "~/features/visualizer/types";
@@ -16,6 +17,8 @@ export type BellmanFordAToBOutputData<T = string> = {
   weighted: boolean;
   path: { from: T; to: T; weight?: number }[];
   totalWeight?: number;
+  settled?: number; // vertices the indexed search settled
+  indexed?: boolean; // answered from the shortest-path index
 };
 
 export type BellmanFordAToBResult<T = string> = BaseGraphAlgorithmResult & {
@@ -25,11 +28,11 @@ export type BellmanFordAToBResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: BellmanFordAToBResult<number>
+  algorithmResult: WithHighlight<BellmanFordAToBResult<number>>
 ): BellmanFordAToBResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const path = data.path.map(({ from, to, weight }) => ({
     from: mapLabelBack(from),
@@ -39,7 +42,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       source: mapLabelBack(data.source),
@@ -47,13 +50,15 @@ function _parseResult(
       weighted: data.weighted,
       path,
       totalWeight: data.totalWeight,
+      settled: data.settled,
+      indexed: data.indexed,
     },
   };
 }
 
 export async function igraphBellmanFordAToB(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string,
   kuzuTargetID: string
 ): Promise<BellmanFordAToBResult> {
@@ -67,7 +72,11 @@ export async function igraphBellmanFordAToB(
   }
 
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.bellman_ford_source_to_target(startIgraphId, endIgraphId)
+    m.bellman_ford_source_to_target(
+      graphData.handle,
+      startIgraphId,
+      endIgraphId
+    )
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -1,7 +1,7 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
 } from "../../types";
 import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
 
@@ -48,7 +48,7 @@ function _parseResult(
 
 export async function igraphDFS(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string
 ): Promise<DFSResult> {
   const igraphID = graphData.KuzuToIgraphMap.get(kuzuSourceID);
@@ -57,7 +57,9 @@ export async function igraphDFS(
     throw new Error(`Source node "${kuzuSourceID}" not found in graph data`);
   }
 
-  const wasmResult = await _runIgraphAlgo(igraphMod, (m) => m.dfs(igraphID));
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    m.dfs(graphData.handle, igraphID)
+  );
   return _parseResult(
     graphData.IgraphToKuzuMap,
     graphData.nodesMap,
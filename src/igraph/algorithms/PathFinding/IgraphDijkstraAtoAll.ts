@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -23,11 +24,11 @@ export type DijkstraAToAllResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: DijkstraAToAllResult<number>
+  algorithmResult: WithHighlight<DijkstraAToAllResult<number>>
 ): DijkstraAToAllResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const paths = data.paths.map((pathObj) => ({
     target: mapLabelBack(pathObj.target),
@@ -37,7 +38,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       source: mapLabelBack(data.source),
@@ -49,7 +50,7 @@ function _parseResult(
 
 export async function igraphDijkstraAToAll(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string
 ): Promise<DijkstraAToAllResult> {
   const startIgraphId = graphData.KuzuToIgraphMap.get(kuzuSourceID);
@@ -59,7 +60,7 @@ export async function igraphDijkstraAToAll(
   }
 
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.dijkstra_source_to_all(startIgraphId)
+    m.dijkstra_source_to_all(graphData.handle, startIgraphId, false)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
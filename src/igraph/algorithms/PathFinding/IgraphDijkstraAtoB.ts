@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -16,6 +17,8 @@ export type DijkstraAToBOutputData<T = string> = {
   weighted: boolean;
   path: { from: T; to: T; weight?: number }[];
   totalWeight?: number;
+  settled?: number; // vertices the search settled
+  indexed?: boolean; // answered from the shortest-path index
 };
 
 export type DijkstraAToBResult<T = string> = BaseGraphAlgorithmResult & {
@@ -25,11 +28,11 @@ export type DijkstraAToBResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: DijkstraAToBResult<number>
+  algorithmResult: WithHighlight<DijkstraAToBResult<number>>
 ): DijkstraAToBResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const path = data.path.map(({ from, to, weight }) => ({
     from: mapLabelBack(from),
@@ -39,7 +42,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       source: mapLabelBack(data.source),
@@ -47,13 +50,15 @@ function _parseResult(
       weighted: data.weighted,
       path,
       totalWeight: data.totalWeight,
+      settled: data.settled,
+      indexed: data.indexed,
     },
   };
 }
 
 export async function igraphDijkstraAToB(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string,
   kuzuTargetID: string
 ): Promise<DijkstraAToBResult> {
@@ -67,7 +72,7 @@ export async function igraphDijkstraAToB(
   }
 
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.dijkstra_source_to_target(startIgraphId, endIgraphId)
+    m.dijkstra_source_to_target(graphData.handle, startIgraphId, endIgraphId)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -29,11 +30,11 @@ export type MSTResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: MSTResult<number>
+  algorithmResult: WithHighlight<MSTResult<number>>
 ): MSTResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const edges = data.edges.map(({ num, from, to, weight }) => ({
     num: num,
@@ -44,7 +45,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       weighted: data.weighted,
@@ -57,10 +58,10 @@ function _parseResult(
 
 export async function igraphMST(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult
+  graphData: ResidentGraphData
 ): Promise<MSTResult> {
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.min_spanning_tree()
+    m.min_spanning_tree(graphData.handle)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
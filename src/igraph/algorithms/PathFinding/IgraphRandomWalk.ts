@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -31,11 +32,11 @@ export type RandomWalkResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: RandomWalkResult<number>
+  algorithmResult: WithHighlight<RandomWalkResult<number>>
 ): RandomWalkResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const path = data.path.map((p) => ({
     step: p.step,
@@ -46,7 +47,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       source: mapLabelBack(data.source),
@@ -61,7 +62,7 @@ function _parseResult(
 
 export async function igraphRandomWalk(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string,
   steps: number
 ): Promise<RandomWalkResult> {
@@ -72,7 +73,7 @@ export async function igraphRandomWalk(
   }
 
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.random_walk(startIgraphId, steps)
+    m.random_walk(graphData.handle, startIgraphId, steps)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
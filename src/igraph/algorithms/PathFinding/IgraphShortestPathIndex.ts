@@ -0,0 +1,24 @@
+import type { GraphModule, ResidentGraphData } from "../../types";
+
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+
+// Inferred from src/wasm/algorithms/path-finding.cpp
+export type ShortestPathIndexStats = {
+  built: boolean; // false if the index already existed
+  buildMs: number; // preprocessing time
+  bytes: number; // memory the index occupies
+  shortcuts: number;
+  arcs: number;
+};
+
+// Contraction hierarchy for repeated A-to-B queries. Dijkstra and
+// Bellman-Ford A-to-B queries use it until the graph or its weights change;
+// needs positive weights.
+export async function igraphBuildShortestPathIndex(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData
+): Promise<ShortestPathIndexStats> {
+  return await _runIgraphAlgo(igraphMod, (m) =>
+    m.build_shortest_path_index(graphData.handle)
+  );
+}
@@ -0,0 +1,64 @@
+import type { GraphModule, ResidentGraphData } from "../../types";
+import { createMapIdBack } from "../../utils/mapIdBack";
+
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+
+export type ShortestPathPairsOptions = {
+  paths?: boolean; // also return the paths, default false
+};
+
+// Inferred from src/wasm/algorithms/path-finding.cpp (shortest_path_pairs).
+// Path i spans vertices[vertexOffsets[i], vertexOffsets[i + 1]) and
+// edges[edgeOffsets[i], edgeOffsets[i + 1]); empty if unreachable.
+export type ShortestPathPairsResult = {
+  algorithm: string;
+  pairs: number;
+  sources: number; // distinct sources, one search each
+  settled: number;
+  distances: Float64Array; // by pair, Infinity if unreachable
+  vertexOffsets?: Int32Array;
+  vertices?: Int32Array; // igraph IDs
+  edgeOffsets?: Int32Array;
+  edges?: Int32Array; // igraph edge IDs
+  pathNodes?: string[]; // Kuzu IDs of vertices
+};
+
+// Shortest paths for many (source, target) pairs in one call; pairs sharing
+// a source share a single search. Needs non-negative weights.
+export async function igraphShortestPathPairs(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData,
+  kuzuSourceIDs: string[],
+  kuzuTargetIDs: string[],
+  { paths = false }: ShortestPathPairsOptions = {}
+): Promise<ShortestPathPairsResult> {
+  if (kuzuSourceIDs.length !== kuzuTargetIDs.length) {
+    throw new Error("Every source needs a target");
+  }
+  const toIgraph = (ids: string[]) => {
+    const out = new Int32Array(ids.length);
+    ids.forEach((id, i) => {
+      const v = graphData.KuzuToIgraphMap.get(id);
+      if (v == null) {
+        throw new Error(`Node "${id}" not found in graph data`);
+      }
+      out[i] = v;
+    });
+    return out;
+  };
+  const sources = toIgraph(kuzuSourceIDs);
+  const targets = toIgraph(kuzuTargetIDs);
+
+  const result: ShortestPathPairsResult = await _runIgraphAlgo(
+    igraphMod,
+    (m) => m.shortest_path_pairs(graphData.handle, sources, targets, paths)
+  );
+  if (result.vertices) {
+    const { mapIdBack } = createMapIdBack(
+      graphData.IgraphToKuzuMap,
+      graphData.nodesMap
+    );
+    result.pathNodes = Array.from(result.vertices, mapIdBack);
+  }
+  return result;
+}
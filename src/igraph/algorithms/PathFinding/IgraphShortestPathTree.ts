@@ -0,0 +1,97 @@
+import type {
+  BaseGraphAlgorithmResult,
+  GraphModule,
+  ResidentGraphData,
+  WithHighlight,
+} from "../../types";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
+
+import type { GraphNode } from "~/features/visualizer/types";
+import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
+
+export type ShortestPathTreeAlgorithm = "dijkstra" | "bellman_ford";
+
+// Inferred from src/wasm/algorithms/path-finding.cpp (shortest_path_tree)
+export type ShortestPathTreeOutputData = {
+  algorithm: string;
+  source: string;
+  weighted: boolean;
+  reached: number; // vertices reachable from the source, excluding it
+  // Indexed by igraph vertex ID; -1 for the source and unreached vertices
+  predecessors: Int32Array;
+  predecessorEdges: Int32Array;
+  distances: Float64Array; // Infinity when unreachable
+  delta?: number; // Dijkstra with positive weights: delta-stepping bucket width
+  phases?: number; // frontiers the delta-stepping relaxed
+};
+
+export type ShortestPathTreeResult = BaseGraphAlgorithmResult & {
+  data: ShortestPathTreeOutputData;
+  // Walks the tree back from a target; null if it is unreachable
+  reconstructPath: (
+    kuzuTargetID: string
+  ) => { path: string[]; weight: number } | null;
+};
+
+function _parseResult(
+  IgraphToKuzu: Map<number, string>,
+  KuzuToIgraph: Map<string, number>,
+  nodesMap: Map<string, GraphNode>,
+  source: number,
+  algorithmResult: WithHighlight<
+    BaseGraphAlgorithmResult & { data: ShortestPathTreeOutputData }
+  >
+): ShortestPathTreeResult {
+  const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
+
+  const { data, mode, highlight } = algorithmResult;
+
+  const reconstructPath = (kuzuTargetID: string) => {
+    const target = KuzuToIgraph.get(kuzuTargetID);
+    if (target == null) {
+      throw new Error(`Target node "${kuzuTargetID}" not found in graph data`);
+    }
+    if (target !== source && data.predecessors[target] < 0) return null;
+
+    const path: string[] = [];
+    for (let v = target; v >= 0; v = data.predecessors[v]) {
+      path.push(mapLabelBack(v));
+    }
+    return { path: path.reverse(), weight: data.distances[target] };
+  };
+
+  return {
+    mode,
+    ...mapHighlightIds(highlight, mapIdBack),
+    data: { ...data, source: mapLabelBack(data.source) },
+    reconstructPath,
+  };
+}
+
+// Single-source shortest paths returned as a shortest-path tree: O(V) typed
+// arrays instead of one path per target, with paths rebuilt on demand
+export async function igraphShortestPathTree(
+  igraphMod: GraphModule,
+  graphData: ResidentGraphData,
+  kuzuSourceID: string,
+  algorithm: ShortestPathTreeAlgorithm
+): Promise<ShortestPathTreeResult> {
+  const startIgraphId = graphData.KuzuToIgraphMap.get(kuzuSourceID);
+
+  if (startIgraphId == null) {
+    throw new Error(`Source node "${kuzuSourceID}" not found in graph data`);
+  }
+
+  const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
+    algorithm === "dijkstra"
+      ? m.dijkstra_source_to_all(graphData.handle, startIgraphId, true)
+      : m.bellman_ford_source_to_all(graphData.handle, startIgraphId, true)
+  );
+  return _parseResult(
+    graphData.IgraphToKuzuMap,
+    graphData.KuzuToIgraphMap,
+    graphData.nodesMap,
+    startIgraphId,
+    wasmResult
+  );
+}
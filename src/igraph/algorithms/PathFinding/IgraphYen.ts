@@ -1,9 +1,10 @@
 import type {
   BaseGraphAlgorithmResult,
   GraphModule,
-  KuzuToIgraphParseResult,
+  ResidentGraphData,
+  WithHighlight,
 } from "../../types";
-import { createMapIdBack, mapColorMapIds } from "../../utils/mapIdBack";
+import { createMapIdBack, mapHighlightIds } from "../../utils/mapIdBack";
 
 import type { GraphNode } from "~/features/visualizer/types";
 import { _runIgraphAlgo } from "~/igraph/utils/runIgraphAlgo";
@@ -30,11 +31,11 @@ export type YenResult<T = string> = BaseGraphAlgorithmResult & {
 function _parseResult(
   IgraphToKuzu: Map<number, string>,
   nodesMap: Map<string, GraphNode>,
-  algorithmResult: YenResult<number>
+  algorithmResult: WithHighlight<YenResult<number>>
 ): YenResult {
   const { mapIdBack, mapLabelBack } = createMapIdBack(IgraphToKuzu, nodesMap);
 
-  const { data, mode, colorMap = {} } = algorithmResult;
+  const { data, mode, highlight } = algorithmResult;
 
   const paths = data.paths.map((p) => ({
     num: p.num,
@@ -44,7 +45,7 @@ function _parseResult(
 
   return {
     mode,
-    colorMap: mapColorMapIds(colorMap, mapIdBack),
+    ...mapHighlightIds(highlight, mapIdBack),
     data: {
       algorithm: data.algorithm,
       source: mapLabelBack(data.source),
@@ -58,7 +59,7 @@ function _parseResult(
 
 export async function igraphYen(
   igraphMod: GraphModule,
-  graphData: KuzuToIgraphParseResult,
+  graphData: ResidentGraphData,
   kuzuSourceID: string,
   kuzuTargetID: string,
   k: number
@@ -73,7 +74,7 @@ export async function igraphYen(
   }
 
   const wasmResult = await _runIgraphAlgo(igraphMod, (m) =>
-    m.yen_source_to_target(startIgraphId, endIgraphId, k)
+    m.yen_source_to_target(graphData.handle, startIgraphId, endIgraphId, k)
   );
   return _parseResult(
     graphData.IgraphToKuzuMap,
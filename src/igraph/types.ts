@@ -1,3 +1,5 @@
+import type { EdgeColorIndex } from "./utils/edgeColorIndex";
+
 import type { GraphNode } from "~/features/visualizer/types";
 import type { MainModule } from "~/graph";
 
@@ -16,6 +18,52 @@ export type KuzuToIgraphParseResult = {
   nodesMap: Map<string, GraphNode>; // Map back kuzu id to nodes
 };
 
+export type ResidentGraphData = KuzuToIgraphParseResult & {
+  handle: number; // WASM graph handle holding this graph
+};
+
+// How the weights of reciprocal edges are combined when a directed graph is
+// projected to an undirected one
+export type WeightMerge = "sum" | "max" | "min" | "mean" | "first";
+
+// Vertex numbering of the graph snapshot the native kernels traverse
+export type VertexOrder = "none" | "degree" | "rcm";
+
+export type KernelTime = { runs: number; ms: number; meanMs: number };
+
+export type VertexOrderStats = {
+  order: VertexOrder;
+  reorderMs: number; // total time spent reordering this graph
+  gapBefore: number | null; // mean neighbour ID distance in igraph IDs
+  gapAfter: number | null; // the same after reordering
+  // Kernel time under each order, in total and by CSR kernel
+  kernels: Record<
+    VertexOrder,
+    KernelTime & { byKernel: Record<string, KernelTime> }
+  >;
+  // Kernel time saved net of reordering, from kernels run under both "none"
+  // and the current order; null until there is one
+  savedMs: number | null;
+};
+
+// Parameters of the power iteration algorithms (PageRank, eigenvector, Katz,
+// HITS). Without `start` a run continues from the same algorithm's previous
+// result while the graph is unchanged.
+export type SpectralOptions = {
+  tolerance?: number; // relative L1 change per iteration, default 1e-10
+  maxIterations?: number; // default 1000
+  start?: Float64Array | number[]; // one non-negative value per igraph vertex
+};
+
+// How a power iteration run went
+export type SpectralIterationData = {
+  iterations: number;
+  residual: number; // relative L1 change of the last iteration
+  converged: boolean;
+  warmStarted: boolean; // started from the previous result
+  warning?: string; // degenerate input, e.g. eigenvector centrality on a DAG
+};
+
 type NodeId = string;
 type EdgeId = string; // Format: "fromNodeId-toNodeId"
 type ColorValue = number; // 0.5 for partial highlight, 1 for full highlight, or frequency-based values
@@ -30,10 +78,55 @@ export type SizeMap = {
 
 export type BaseGraphAlgorithmResult = {
   colorMap: ColorMap;
+  // Edge colors of highlight-based results; colorMap then holds vertices only
+  edgeColors?: EdgeColorIndex;
   sizeMap?: SizeMap;
   mode: number;
 };
 
+// Highlight buffers returned by path/tree algorithms in place of colorMap
+// entries: igraph vertex IDs and edge endpoints, each with its value
+export type Highlight = {
+  vertices: Int32Array;
+  vertexValues: Float64Array;
+  edgeSources: Int32Array;
+  edgeTargets: Int32Array;
+  edgeValues: Float64Array;
+};
+
+export type WithHighlight<R> = R & { highlight: Highlight };
+
+// Columnar attribute export (graph_node_columns / graph_edge_columns)
+export type AttributeColumn =
+  | { type: "number"; values: Float64Array }
+  | { type: "boolean"; values: Uint8Array }
+  | { type: "string"; offsets: Uint32Array; bytes: Uint8Array } // UTF-8
+  // Typed attribute store columns
+  | { type: "int"; values: Int32Array }
+  | { type: "timestamp"; values: Float64Array } // ms since epoch, NaN if missing
+  | { type: "dictionary"; codes: Int32Array; dictionary: string[] }; // -1 if missing
+
+// Typed attribute store (import_attributes / attribute_column), one value
+// per vertex or edge. String columns are dictionary encoded.
+export type AttributeKind = "vertex" | "edge";
+
+export type TypedAttributeInput =
+  | { type: "int"; values: Int32Array }
+  | { type: "float" | "timestamp"; values: Float64Array }
+  | { type: "bool"; values: Uint8Array }
+  | { type: "string"; codes: Int32Array; dictionary: string[] }
+  | { type: "string"; values: (string | null)[] };
+
+export type NodeColumns = {
+  count: number;
+  columns: Record<string, AttributeColumn>;
+};
+
+export type EdgeColumns = NodeColumns & {
+  sources: Int32Array;
+  targets: Int32Array;
+};
+
 export const MODE = {
   COLOR_IMPORTANT: 1,
   COLOR_SHADE_DEFAULT: 2,
@@ -43,3 +136,17 @@ export const MODE = {
 } as const;
 
 export type GraphModule = MainModule;
+
+// Progress of the running algorithm (see progress_view in the WASM module)
+export type AlgorithmProgress = {
+  percent: number;
+  elapsedMs: number;
+  etaMs: number; // NaN until the algorithm has reported any progress
+  running: boolean;
+};
+
+// Called as the running algorithm advances; returning true cancels it
+export type ProgressCallback = (
+  progress: AlgorithmProgress,
+  message: string
+) => boolean | void;
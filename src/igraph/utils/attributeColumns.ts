@@ -0,0 +1,36 @@
+import type { AttributeColumn } from "../types";
+
+const decoder = new TextDecoder();
+
+/**
+ * Reads one value of a columnar attribute export. String values are decoded
+ * on access, so only the rows actually shown pay for decoding.
+ *
+ * @param column - A column from graph_node_columns / graph_edge_columns
+ * @param index - Igraph vertex or edge ID
+ * @returns The value as a number, boolean, string or Date (null if missing)
+ */
+export function readAttributeValue(
+  column: AttributeColumn,
+  index: number
+): number | boolean | string | Date | null {
+  switch (column.type) {
+    case "number":
+    case "int":
+      return column.values[index];
+    case "timestamp": {
+      const ms = column.values[index];
+      return Number.isNaN(ms) ? null : new Date(ms);
+    }
+    case "dictionary": {
+      const code = column.codes[index];
+      return code < 0 ? null : column.dictionary[code];
+    }
+    case "boolean":
+      return column.values[index] !== 0;
+    case "string":
+      return decoder.decode(
+        column.bytes.subarray(column.offsets[index], column.offsets[index + 1])
+      );
+  }
+}
@@ -0,0 +1,40 @@
+import type { ColorMap } from "../types";
+
+/**
+ * Edge colors keyed by the Kuzu IDs of both endpoints, so the renderer looks
+ * a link up without building a "from-to" key for it on every draw.
+ * A class instance rather than a plain object: the visualizer store keeps
+ * it as is instead of deep-converting it into observables.
+ */
+export class EdgeColorIndex {
+  private _bySource = new Map<string, Map<string, number>>();
+
+  set(source: string, target: string, value: number) {
+    let byTarget = this._bySource.get(source);
+    if (!byTarget) {
+      byTarget = new Map();
+      this._bySource.set(source, byTarget);
+    }
+    byTarget.set(target, value);
+  }
+
+  /**
+   * Color value of the edge source -> target, or NaN if it has none
+   */
+  get(source: string, target: string): number {
+    return this._bySource.get(source)?.get(target) ?? NaN;
+  }
+
+  /**
+   * Indexes the "from-to" edge keys of a colorMap, once per result
+   */
+  static fromColorMap(colorMap: ColorMap): EdgeColorIndex {
+    const index = new EdgeColorIndex();
+    for (const [key, value] of Object.entries(colorMap)) {
+      if (!key.includes("-")) continue;
+      const [source, target] = key.split("-");
+      index.set(source, target, value);
+    }
+    return index;
+  }
+}
@@ -1,4 +1,8 @@
 /* eslint-disable no-console */
+import type { ColorMap, Highlight } from "../types";
+
+import { EdgeColorIndex } from "./edgeColorIndex";
+
 import type { GraphNode } from "~/features/visualizer/types";
 
 /**
@@ -65,3 +69,34 @@ export function mapColorMapIds(
     )
   ) as Record<string, number>;
 }
+
+/**
+ * Builds the vertex colorMap and the edge color index, keyed by Kuzu IDs,
+ * from typed-array highlight buffers. Unlike mapColorMapIds no key is
+ * built, split or parsed: vertex IDs and edge endpoints arrive as integers
+ * and are mapped back directly.
+ *
+ * @param highlight - Highlight buffers with Igraph IDs
+ * @param mapIdBack - Function to map an Igraph ID back to a Kuzu ID
+ * @returns The vertex colorMap and the edges' EdgeColorIndex
+ */
+export function mapHighlightIds(
+  highlight: Highlight,
+  mapIdBack: (id: string | number) => string
+): { colorMap: ColorMap; edgeColors: EdgeColorIndex } {
+  const colorMap: ColorMap = {};
+  const edgeColors = new EdgeColorIndex();
+  const { vertices, vertexValues, edgeSources, edgeTargets, edgeValues } =
+    highlight;
+  for (let i = 0; i < vertices.length; i++) {
+    colorMap[mapIdBack(vertices[i])] = vertexValues[i];
+  }
+  for (let i = 0; i < edgeSources.length; i++) {
+    edgeColors.set(
+      mapIdBack(edgeSources[i]),
+      mapIdBack(edgeTargets[i]),
+      edgeValues[i]
+    );
+  }
+  return { colorMap, edgeColors };
+}
@@ -2,6 +2,45 @@ import type { KuzuToIgraphParseResult } from "../types";
 
 import type { GraphEdge, GraphNode } from "~/features/visualizer/types";
 
+/**
+ * Reads the numeric "weight" attribute of an edge (case-insensitive key).
+ * Returns undefined if the edge has no usable weight.
+ */
+export function parseEdgeWeight(
+  e: GraphEdge,
+  i: number
+): number | undefined {
+  if (!e.attributes) return undefined;
+
+  const weightKey = Object.keys(e.attributes).find(
+    (key) => key.toLowerCase() === "weight"
+  );
+  if (!weightKey) return undefined;
+
+  const val = e.attributes[weightKey];
+  let numVal: string | number | boolean | null = null;
+  if (typeof val === "number") {
+    numVal = val;
+  } else if (val instanceof Number) {
+    numVal = val.valueOf();
+  }
+
+  if (
+    typeof numVal !== "string" &&
+    typeof numVal !== "boolean" &&
+    numVal !== null &&
+    Number.isFinite(numVal)
+  ) {
+    return numVal;
+  }
+
+  // eslint-disable-next-line no-console
+  console.warn(
+    `[KuzuToIgraphParsing] Non-numeric weight at edge ${i} (${e.source} -> ${e.target}); treated as 0.`
+  );
+  return undefined;
+}
+
 /**
  * Convert Kuzu input into Igraph input
  */
@@ -54,34 +93,10 @@ export function parseKuzuToIgraphInput(
     src[i] = sId;
     dst[i] = tId;
 
-    if (e.attributes) {
-      const weightKey = Object.keys(e.attributes).find(
-        (key) => key.toLowerCase() === "weight"
-      );
-      if (weightKey) {
-        const val = e.attributes[weightKey];
-        let numVal: string | number | boolean | null = null;
-        if (typeof val === "number") {
-          numVal = val;
-        } else if (val instanceof Number) {
-          numVal = val.valueOf();
-        }
-
-        if (
-          typeof numVal !== "string" &&
-          typeof numVal !== "boolean" &&
-          numVal !== null &&
-          Number.isFinite(numVal)
-        ) {
-          if (!weight) weight = new Float64Array(E); // default zeros
-          weight[i] = numVal;
-        } else {
-          // eslint-disable-next-line no-console
-          console.warn(
-            `[KuzuToIgraphParsing] Non-numeric weight at edge ${i} (${e.source} -> ${e.target}); treated as 0.`
-          );
-        }
-      }
+    const w = parseEdgeWeight(e, i);
+    if (w !== undefined) {
+      if (!weight) weight = new Float64Array(E); // default zeros
+      weight[i] = w;
     }
   }
 
@@ -1,5 +1,14 @@
 import type { GraphModule } from "../types";
 
+// Thrown when a run is stopped through IgraphController.cancel() or a
+// progress callback; the module has freed everything the run allocated
+export class AlgorithmCancelledError extends Error {
+  constructor() {
+    super("Algorithm cancelled");
+    this.name = "AlgorithmCancelledError";
+  }
+}
+
 export async function _runIgraphAlgo<M extends GraphModule, R>(
   mod: M,
   exec: (m: M) => Promise<R> | R
@@ -7,6 +16,15 @@ export async function _runIgraphAlgo<M extends GraphModule, R>(
   try {
     return await exec(mod);
   } catch (e) {
-    throw new Error(typeof e === "number" ? mod.what_to_stderr(e) : String(e));
+    // C++ exceptions arrive as pointers from a module on this thread; the
+    // graph worker converts them before rejecting with an Error
+    const message =
+      typeof e === "number"
+        ? mod.what_to_stderr(e)
+        : e instanceof Error
+          ? e.message
+          : String(e);
+    if (message === "Cancelled") throw new AlgorithmCancelledError();
+    throw new Error(message);
   }
 }
@@ -0,0 +1,171 @@
+/**
+ * Web Worker hosting the graph WASM module
+ * Runs algorithms off the main thread; see GraphWorkerClient for the calling
+ * side. Progress is posted back as the module reports it.
+ */
+
+import type { GraphModule } from "../types";
+
+interface WorkerMessage {
+  id: number;
+  type: string;
+  data: any;
+}
+
+let mod: GraphModule | null = null;
+
+// Cross-origin isolated pages get the multithreaded build; anything else, or
+// a failure to start it, falls back to the single-threaded one
+async function loadModule(): Promise<GraphModule> {
+  if (self.crossOriginIsolated) {
+    try {
+      const { default: createThreadedModule } = await import(
+        "../../graph-mt"
+      );
+      return await createThreadedModule();
+    } catch (error) {
+      console.warn("[Graph Worker] Multithreaded module unavailable:", error);
+    }
+  }
+  const { default: createModule } = await import("../../graph");
+  return await createModule();
+}
+
+function initializedModule(): GraphModule {
+  if (!mod) {
+    throw new Error("Graph module not initialized");
+  }
+  return mod;
+}
+
+function sharesMemory(m: GraphModule): boolean {
+  return (
+    typeof SharedArrayBuffer !== "undefined" &&
+    m.progress_view().buffer instanceof SharedArrayBuffer
+  );
+}
+
+/**
+ * Copy typed array views over WASM memory out of a result. Posted as is,
+ * a view would clone the whole heap, or share it when memory is shared.
+ */
+function detach(value: unknown, heap: ArrayBufferLike): unknown {
+  if (ArrayBuffer.isView(value)) {
+    return value.buffer === heap ? (value as Float64Array).slice() : value;
+  }
+  if (Array.isArray(value)) {
+    return value.map((item) => detach(item, heap));
+  }
+  if (
+    value !== null &&
+    typeof value === "object" &&
+    Object.getPrototypeOf(value) === Object.prototype
+  ) {
+    return Object.fromEntries(
+      Object.entries(value).map(([key, item]) => [key, detach(item, heap)])
+    );
+  }
+  return value;
+}
+
+function errorMessage(error: unknown): string {
+  // C++ exceptions arrive as pointers
+  if (typeof error === "number" && mod) {
+    return mod.what_to_stderr(error);
+  }
+  return error instanceof Error ? error.message : String(error);
+}
+
+/**
+ * Handle messages from the main thread
+ */
+self.onmessage = async (e: MessageEvent<WorkerMessage>) => {
+  const { id, type, data } = e.data;
+
+  try {
+    switch (type) {
+      case "init": {
+        if (!mod) {
+          const loaded = await loadModule();
+          // Runs on this thread as the algorithm advances, throttled by the
+          // module
+          loaded.set_progress_callback(
+            (_percent: number, _etaMs: number, message: string) => {
+              self.postMessage({
+                type: "progress",
+                data: { cells: Array.from(loaded.progress_view()), message },
+              });
+              return false;
+            }
+          );
+          mod = loaded;
+        }
+
+        // Views over shared memory let the main thread read progress and
+        // raise the cancel flag while this thread is busy
+        const shared = sharesMemory(mod);
+        self.postMessage({
+          id,
+          type,
+          data: {
+            progress: shared ? mod.progress_view() : null,
+            cancel: shared ? mod.cancel_view() : null,
+          },
+        });
+        break;
+      }
+
+      case "call": {
+        const m = initializedModule();
+        const fn = (m as unknown as Record<string, unknown>)[data.name];
+        if (typeof fn !== "function") {
+          throw new Error(`Unknown graph module function: ${data.name}`);
+        }
+        const result = await fn.apply(m, data.args);
+        self.postMessage({
+          id,
+          type,
+          data: detach(result, m.progress_view().buffer),
+          progress: Array.from(m.progress_view()),
+        });
+        break;
+      }
+
+      case "upload": {
+        const m = initializedModule();
+        const { handle, nodes, src, dst, directed, weight, version } = data;
+
+        // The views alias WASM memory and are invalidated by heap growth,
+        // so they must be filled before any other call into the module
+        const buffers = m.ingest_buffers(src.length, weight !== undefined);
+        buffers.src.set(src);
+        buffers.dst.set(dst);
+        if (weight) buffers.weight.set(weight);
+
+        await m.create_graph_from_ingest_buffers(
+          handle,
+          nodes,
+          directed,
+          version
+        );
+        self.postMessage({ id, type, data: null });
+        break;
+      }
+
+      default:
+        throw new Error(`Unknown message type: ${type}`);
+    }
+  } catch (error) {
+    self.postMessage({
+      id,
+      type,
+      error: errorMessage(error),
+      progress: mod ? Array.from(mod.progress_view()) : undefined,
+    });
+  }
+};
+
+// Handle worker errors
+self.onerror = (error) => {
+  console.error("[Graph Worker] Unhandled error:", error);
+};
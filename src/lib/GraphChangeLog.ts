@@ -0,0 +1,107 @@
+import type { GraphEdge, GraphNode } from "~/features/visualizer/types";
+
+/**
+ * One structural change to the graph, as recorded by the typed mutation APIs
+ */
+export type GraphChange =
+  // A node was created or updated (node set) or deleted (node null).
+  // Deleting a node also drops its edges.
+  | { type: "node"; id: string; node: GraphNode | null }
+  // All edges now stored between two nodes in an edge table, in either
+  // orientation (empty once they are deleted)
+  | {
+      type: "edges";
+      source: string;
+      target: string;
+      tableName: string;
+      edges: GraphEdge[];
+    };
+
+// Oldest entries are dropped past this length; consumers that fell that far
+// behind rebuild from a full snapshot instead
+const MAX_ENTRIES = 1024;
+
+/**
+ * GraphChangeLog - Version counter of the current graph, bumped on every
+ * mutation, plus the log of recent changes so consumers of snapshots
+ * (the resident WASM graph) can catch up without diffing them
+ */
+export class GraphChangeLog {
+  private _version = 0;
+  // Version the first entry was recorded against
+  private _base = 0;
+  private _entries: GraphChange[] = [];
+
+  get version(): number {
+    return this._version;
+  }
+
+  /**
+   * Record a change made through a typed mutation API
+   */
+  record(...changes: GraphChange[]): void {
+    for (const change of changes) {
+      this._entries.push(change);
+      this._version++;
+    }
+    if (this._entries.length > MAX_ENTRIES) {
+      const dropped = this._entries.length - MAX_ENTRIES;
+      this._entries.splice(0, dropped);
+      this._base += dropped;
+    }
+  }
+
+  /**
+   * Record a change whose effect is unknown (raw Cypher, imports, switching
+   * databases): consumers must rebuild from a snapshot
+   */
+  reset(): void {
+    this._version++;
+    this._entries = [];
+    this._base = this._version;
+  }
+
+  /**
+   * Changes made since the given version, or null if the log no longer
+   * reaches back that far
+   */
+  since(version: number): GraphChange[] | null {
+    if (version < this._base || version > this._version) return null;
+    return this._entries.slice(version - this._base);
+  }
+}
+
+// Clauses that can change the graph; queries without any of them only read
+const WRITE_CLAUSE =
+  /\b(CREATE|MERGE|DELETE|SET|REMOVE|DROP|ALTER|COPY|IMPORT|ATTACH|DETACH|USE)\b/i;
+
+/**
+ * Whether a Cypher query may change the graph
+ */
+export function mayWriteGraph(query: string): boolean {
+  return WRITE_CLAUSE.test(query);
+}
+
+/**
+ * The change record for the edges between two nodes in a snapshot taken
+ * after an edge mutation
+ */
+export function edgesBetween(
+  edges: GraphEdge[],
+  source: string,
+  target: string,
+  tableName: string
+): GraphChange {
+  return {
+    type: "edges",
+    source,
+    target,
+    tableName,
+    edges: edges.filter(
+      (e) =>
+        e.tableName === tableName &&
+        ((e.source === source && e.target === target) ||
+          (e.source === target && e.target === source))
+    ),
+  };
+}
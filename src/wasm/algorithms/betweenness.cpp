@@ -0,0 +1,371 @@
+#include "../graph.h"
+#include <cfloat>
+#include <cmath>
+#include <queue>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+// Brandes betweenness on the task pool. Sources are handed out to the pool
+// threads in chunks; each thread keeps its own traversal state and score
+// accumulator, and the accumulators are summed once all sources are done.
+// Scores match igraph_betweenness(..., directed = true, weights) up to
+// floating-point summation order.
+
+// Three-way comparison with igraph's relative tolerance for path lengths, so
+// that ties between weighted paths are detected the same way
+static int cmp_epsilon(double a, double b)
+{
+    const double eps = 1e-10;
+    if (a == b)
+        return 0;
+    const double diff = a - b;
+    const double sum = fabs(a) + fabs(b);
+    if (a == 0 || b == 0 || sum < DBL_MIN)
+        return fabs(diff) < eps * DBL_MIN ? 0 : (diff < 0 ? -1 : 1);
+    if (!std::isfinite(sum))
+        return fabs(diff) < eps * fabs(a) ? 0 : (diff < 0 ? -1 : 1);
+    return fabs(diff) / sum < eps ? 0 : (diff < 0 ? -1 : 1);
+}
+
+// Traversal state and score accumulator of one pool thread
+struct BrandesState
+{
+    std::vector<double> dist, sigma, delta, score;
+    std::vector<char> settled;
+    std::vector<int32_t> order;      // vertices in the order they were settled
+    std::vector<int32_t> discovered; // weighted only: every vertex given a distance
+
+    void init(size_t n)
+    {
+        dist.assign(n, INFINITY);
+        sigma.assign(n, 0);
+        delta.assign(n, 0);
+        score.assign(n, 0);
+        settled.assign(n, 0);
+    }
+};
+
+// Shortest path counts from s. With a target the search stops as soon as the
+// counts of the target and of everything closer than it are final.
+static void unweighted_paths(const EdgeRows &bg, int32_t s, BrandesState &st, int32_t target = -1)
+{
+    st.dist[s] = 0;
+    st.sigma[s] = 1;
+    st.order.push_back(s);
+    for (size_t head = 0; head < st.order.size(); ++head)
+    {
+        const int32_t v = st.order[head];
+        if (target >= 0 && st.dist[v] >= st.dist[target])
+            break;
+        const double next = st.dist[v] + 1;
+        for (int32_t i = bg.offsets[v]; i < bg.offsets[v + 1]; ++i)
+        {
+            const int32_t w = bg.targets[i];
+            if (st.dist[w] == INFINITY)
+            {
+                st.dist[w] = next;
+                st.order.push_back(w);
+            }
+            if (st.dist[w] == next)
+                st.sigma[w] += st.sigma[v];
+        }
+    }
+}
+
+static void weighted_paths(const EdgeRows &bg, int32_t s, BrandesState &st, int32_t target = -1)
+{
+    typedef std::pair<double, int32_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+
+    st.dist[s] = 0;
+    st.sigma[s] = 1;
+    st.discovered.push_back(s);
+    heap.push(Entry(0, s));
+    while (!heap.empty())
+    {
+        const int32_t v = heap.top().second;
+        heap.pop();
+        if (st.settled[v])
+            continue;
+        st.settled[v] = 1;
+        st.order.push_back(v);
+        if (v == target)
+            break;
+
+        for (int32_t i = bg.offsets[v]; i < bg.offsets[v + 1]; ++i)
+        {
+            const int32_t w = bg.targets[i];
+            if (st.settled[w])
+                continue;
+            const double alt = st.dist[v] + bg.weights[i];
+            const int cmp = st.dist[w] == INFINITY ? -1 : cmp_epsilon(alt, st.dist[w]);
+            if (st.dist[w] == INFINITY)
+                st.discovered.push_back(w);
+            if (cmp < 0)
+            {
+                st.dist[w] = alt;
+                st.sigma[w] = st.sigma[v];
+                heap.push(Entry(alt, w));
+            }
+            else if (cmp == 0)
+            {
+                st.sigma[w] += st.sigma[v];
+            }
+        }
+    }
+}
+
+// Only the reached vertices were touched
+static void reset_paths(BrandesState &st)
+{
+    for (const std::vector<int32_t> *touched : {&st.order, &st.discovered})
+    {
+        for (int32_t v : *touched)
+        {
+            st.dist[v] = INFINITY;
+            st.sigma[v] = 0;
+            st.delta[v] = 0;
+            st.settled[v] = 0;
+        }
+    }
+    st.order.clear();
+    st.discovered.clear();
+}
+
+// Adds the dependencies of source s to st.score. Vertices are visited in
+// reverse settling order, so every successor w of v (dist[w] = dist[v] +
+// weight) is final before v is.
+static void accumulate_source(const EdgeRows &bg, int32_t s, BrandesState &st)
+{
+    const bool weighted = !bg.weights.empty();
+    if (weighted)
+        weighted_paths(bg, s, st);
+    else
+        unweighted_paths(bg, s, st);
+
+    for (size_t k = st.order.size(); k-- > 0;)
+    {
+        const int32_t v = st.order[k];
+        double dependency = 0;
+        for (int32_t i = bg.offsets[v]; i < bg.offsets[v + 1]; ++i)
+        {
+            const int32_t w = bg.targets[i];
+            if (st.dist[w] == INFINITY)
+                continue;
+            const bool successor = weighted ? cmp_epsilon(st.dist[v] + bg.weights[i], st.dist[w]) == 0
+                                            : st.dist[w] == st.dist[v] + 1;
+            if (successor)
+                dependency += st.sigma[v] / st.sigma[w] * (1 + st.delta[w]);
+        }
+        st.delta[v] = dependency;
+        if (v != s)
+            st.score[v] += dependency;
+    }
+
+    reset_paths(st);
+}
+
+// Betweenness of every vertex of the snapshot, weighted if it is. The
+// weights must be positive (csr.positiveWeights); callers hand other graphs
+// to igraph_betweenness so that it reports the error.
+std::vector<double> parallel_betweenness(const CsrGraph &csr)
+{
+    const int32_t n = csr.vertices;
+    const EdgeRows &bg = csr.out();
+    TaskPool &pool = TaskPool::instance();
+    std::vector<BrandesState> states(pool.size());
+    ProgressCounter progress(n);
+
+    const size_t grain = std::max<size_t>(1, n / (16 * pool.size()));
+    pool.parallel_for(0, n, grain, [&](size_t lo, size_t hi, unsigned thread)
+                      {
+        BrandesState &st = states[thread];
+        if (st.score.empty())
+            st.init(n);
+        for (size_t s = lo; s < hi; ++s)
+        {
+            accumulate_source(bg, s, st);
+            progress.add(1);
+        } });
+
+    // Undirected paths are found from both ends
+    const double scale = csr.directed ? 1.0 : 0.5;
+    std::vector<double> scores(n, 0);
+    for (const BrandesState &st : states)
+    {
+        if (st.score.empty())
+            continue;
+        for (int32_t v = 0; v < n; ++v)
+            scores[v] += st.score[v];
+    }
+    for (double &score : scores)
+        score *= scale;
+    return csr.to_original(std::move(scores));
+}
+
+// SAMPLED BETWEENNESS
+// Riondato and Kornaropoulos, "Fast approximation of betweenness centrality
+// through sampling" (WSDM 2014): r shortest paths between random vertex
+// pairs are drawn uniformly, with r chosen from the vertex diameter so that
+// every normalized score (fraction of ordered pairs whose shortest paths run
+// through the vertex) is within epsilon with probability 1 - delta.
+
+// Universal constant of the sample size bound, as suggested in the paper
+#define SAMPLE_BOUND_C 0.5
+
+static uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Upper bound on the number of vertices on a shortest path: 2 * eccentricity
+// + 1 per component for undirected unweighted graphs, the size of the
+// largest (weakly) connected component otherwise
+static size_t vertex_diameter_bound(const EdgeRows &out, const EdgeRows &in, bool hops)
+{
+    const size_t n = out.offsets.size() - 1;
+    std::vector<int32_t> level(n, -1), queue;
+    size_t bound = 0;
+    for (size_t root = 0; root < n; ++root)
+    {
+        if (level[root] >= 0)
+            continue;
+        queue.assign(1, root);
+        level[root] = 0;
+        int32_t depth = 0;
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            const int32_t v = queue[head];
+            depth = std::max(depth, level[v]);
+            for (const EdgeRows *bg : {&out, &in})
+            {
+                for (int32_t i = bg->offsets[v]; i < bg->offsets[v + 1]; ++i)
+                {
+                    const int32_t w = bg->targets[i];
+                    if (level[w] < 0)
+                    {
+                        level[w] = level[v] + 1;
+                        queue.push_back(w);
+                    }
+                }
+            }
+        }
+        bound = std::max(bound, hops ? 2 * static_cast<size_t>(depth) + 1 : queue.size());
+    }
+    return bound;
+}
+
+// Walks back from t to s (st holds the paths from s) choosing each
+// predecessor with probability sigma[p] / sigma[w], which picks one of the
+// shortest s-t paths uniformly, and counts its interior vertices
+static void sample_path(const EdgeRows &in, int32_t s, int32_t t, BrandesState &st, std::mt19937_64 &rng, std::vector<uint32_t> &hits)
+{
+    const bool weighted = !in.weights.empty();
+    int32_t w = t;
+    while (w != s)
+    {
+        double pick = std::uniform_real_distribution<double>(0, st.sigma[w])(rng);
+        int32_t chosen = -1;
+        for (int32_t i = in.offsets[w]; i < in.offsets[w + 1]; ++i)
+        {
+            const int32_t p = in.targets[i];
+            const bool predecessor = weighted ? st.settled[p] && cmp_epsilon(st.dist[p] + in.weights[i], st.dist[w]) == 0
+                                              : st.dist[p] + 1 == st.dist[w];
+            if (!predecessor)
+                continue;
+            chosen = p;
+            pick -= st.sigma[p];
+            if (pick < 0)
+                break;
+        }
+        w = chosen;
+        if (w != s)
+            hits[w]++;
+    }
+}
+
+// Approximate betweenness of every vertex of the snapshot, on the same scale as
+// parallel_betweenness(). Sample i draws its pair from its own generator
+// seeded with (seed, i), so the scores depend on the seed only, not on the
+// number of threads. When the bound asks for at least as many samples as
+// there are vertices the exact scores are cheaper and returned instead.
+std::vector<double> sampled_betweenness(const CsrGraph &csr, double epsilon, double delta, uint64_t seed, BetweennessSample &info)
+{
+    if (!(epsilon > 0 && epsilon < 1) || !(delta > 0 && delta < 1))
+    {
+        throw std::runtime_error("Epsilon and delta must both lie strictly between 0 and 1");
+    }
+    if (!csr.positiveWeights)
+    {
+        throw std::runtime_error("Approximate betweenness needs positive edge weights");
+    }
+
+    const int32_t n = csr.vertices;
+    const bool directed = csr.directed;
+    const EdgeRows &out = csr.out();
+    const EdgeRows &in = csr.in();
+
+    info.vertexDiameter = vertex_diameter_bound(out, in, !directed && !csr.weighted);
+    const double logVD = info.vertexDiameter > 3 ? std::floor(std::log2(info.vertexDiameter - 2)) : 0;
+    const double numerator = SAMPLE_BOUND_C * (logVD + 1 + std::log(1 / delta));
+    info.samples = static_cast<size_t>(std::ceil(numerator / (epsilon * epsilon)));
+
+    if (n < 2 || info.samples >= static_cast<size_t>(n))
+    {
+        info.exact = true;
+        info.samples = 0;
+        info.errorBound = 0;
+        return parallel_betweenness(csr);
+    }
+    info.exact = false;
+    info.errorBound = std::sqrt(numerator / info.samples);
+
+    TaskPool &pool = TaskPool::instance();
+    std::vector<BrandesState> states(pool.size());
+    std::vector<std::vector<uint32_t>> hits(pool.size());
+    ProgressCounter progress(info.samples);
+
+    const size_t grain = std::max<size_t>(1, info.samples / (16 * pool.size()));
+    pool.parallel_for(0, info.samples, grain, [&](size_t lo, size_t hi, unsigned thread)
+                      {
+        BrandesState &st = states[thread];
+        if (st.dist.empty())
+        {
+            st.init(n);
+            hits[thread].assign(n, 0);
+        }
+        for (size_t i = lo; i < hi; ++i)
+        {
+            std::mt19937_64 rng(splitmix64(seed ^ splitmix64(i)));
+            const int32_t s = std::uniform_int_distribution<int32_t>(0, n - 1)(rng);
+            int32_t t = std::uniform_int_distribution<int32_t>(0, n - 2)(rng);
+            if (t >= s)
+                t++;
+
+            if (out.weights.empty())
+                unweighted_paths(out, s, st, t);
+            else
+                weighted_paths(out, s, st, t);
+            if (st.dist[t] != INFINITY)
+                sample_path(in, s, t, st, rng, hits[thread]);
+            reset_paths(st);
+            progress.add(1);
+        } });
+
+    // Each sample stands for n(n - 1) ordered pairs; undirected pairs are
+    // counted from both ends as in the exact scores
+    const double scale = static_cast<double>(n) * (n - 1) / info.samples * (directed ? 1.0 : 0.5);
+    std::vector<double> scores(n, 0);
+    for (const std::vector<uint32_t> &counts : hits)
+    {
+        for (size_t v = 0; v < counts.size(); ++v)
+            scores[v] += counts[v];
+    }
+    for (double &score : scores)
+        score *= scale;
+    return csr.to_original(std::move(scores));
+}
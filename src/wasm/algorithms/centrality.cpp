@@ -1,6 +1,10 @@
 #include "../graph.h"
 #include <iostream>
 #include <string>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 // For rendering on the frontend
 #define MIN_SCALE 5
@@ -8,31 +12,66 @@
 
 double scaleCentrality(double centrality, double max_centrality)
 {
+    // All-zero scores (e.g. eigenvector centrality on a DAG) have no scale
+    if (!(max_centrality > 0))
+        return MIN_SCALE;
     double scaled = MIN_SCALE + (MAX_SCALE - MIN_SCALE) * (centrality / max_centrality);
     return scaled;
 }
 
-val betweenness_centrality(void)
+// Builds the result shared by all centrality algorithms from one score per
+// vertex. The default layout keys sizeMap/colorMap by vertex and lists one
+// {node, centrality} object per vertex, rounded to `precision` digits. The
+// columnar layout instead returns the unrounded scores and scaled sizes as
+// Float64Arrays indexed by vertex, plus summary scalars, and leaves rounding
+// to the caller for the rows it displays.
+static val centrality_result(const std::vector<double> &scores, double max_centrality, int precision, bool columnar, val data)
 {
-    IGraphVector betweenness;
-    igraph_betweenness(&globalGraph, betweenness.vec(), igraph_vss_all(), true, igraph_weights());
-
-    double max_centrality = betweenness.max();
+    const size_t count = scores.size();
     val result = val::object();
+
+    if (columnar)
+    {
+        std::vector<double> sizes(count);
+        double min = INFINITY, max = -INFINITY, sum = 0;
+        size_t finite = 0;
+        for (size_t v = 0; v < count; ++v)
+        {
+            double centrality = scores[v];
+            sizes[v] = scaleCentrality(isnan(centrality) ? 0 : centrality, max_centrality);
+            if (isnan(centrality))
+                continue;
+            min = std::min(min, centrality);
+            max = std::max(max, centrality);
+            sum += centrality;
+            finite++;
+        }
+
+        data.set("scores", val::global("Float64Array").new_(typed_memory_view(count, scores.data())));
+        data.set("sizes", val::global("Float64Array").new_(typed_memory_view(count, sizes.data())));
+        data.set("count", count);
+        data.set("min", finite ? min : NAN);
+        data.set("max", finite ? max : NAN);
+        data.set("mean", finite ? sum / finite : NAN);
+        data.set("precision", precision);
+
+        result.set("colorMap", val::object());
+        result.set("mode", MODE_SIZE_SCALAR);
+        result.set("data", data);
+        return result;
+    }
+
     val sizeMap = val::object();
     val colorMap = val::object();
-    val data = val::object();
-    data.set("algorithm", "Betweenness Centrality");
-
     val centralities = val::array();
-    for (igraph_integer_t v = 0; v < igraph_vcount(&globalGraph); ++v)
+    for (size_t v = 0; v < count; ++v)
     {
         val c = val::object();
-        double centrality = betweenness.at(v);
-        double scaled_centrality = scaleCentrality(centrality, max_centrality);
+        double centrality = scores[v];
+        double scaled_centrality = scaleCentrality(isnan(centrality) ? 0 : centrality, max_centrality);
 
         std::stringstream stream;
-        stream << std::fixed << std::setprecision(2) << centrality;
+        stream << std::fixed << std::setprecision(precision) << centrality;
 
         sizeMap.set(v, scaled_centrality);
         colorMap.set(v, 1);
@@ -49,242 +88,333 @@ val betweenness_centrality(void)
     return result;
 }
 
-val closeness_centrality(void)
+static std::vector<double> to_scores(IGraphVector &vec)
 {
-    IGraphVector closeness;
+    return std::vector<double>(VECTOR(*vec.vec()), VECTOR(*vec.vec()) + vec.size());
+}
 
-    igraph_closeness(&globalGraph, closeness.vec(), NULL, NULL, igraph_vss_all(), IGRAPH_OUT, NULL, true);
+val betweenness_centrality(bool columnar)
+{
+    // Parallel Brandes, see betweenness.cpp; igraph reports invalid weights
+    const CsrGraph &csr = graph_csr();
+    std::vector<double> scores;
+    if (csr.positiveWeights)
+    {
+        KernelTimer timer(csr, "parallel_betweenness");
+        scores = parallel_betweenness(csr);
+    }
+    else
+    {
+        IGraphVector betweenness;
+        igraph_betweenness(&currentGraph->graph, betweenness.vec(), igraph_vss_all(), true, igraph_weights());
+        throw_if_cancelled();
+        scores = to_scores(betweenness);
+    }
+    double max = scores.empty() ? 0 : *std::max_element(scores.begin(), scores.end());
 
-    double max_centrality = closeness.max_nonan();
-    val result = val::object();
-    val sizeMap = val::object();
-    val colorMap = val::object();
     val data = val::object();
-    data.set("algorithm", "Closeness Centrality");
+    data.set("algorithm", "Betweenness Centrality");
+    return centrality_result(scores, max, 2, columnar, data);
+}
 
-    val centralities = val::array();
-    for (igraph_integer_t v = 0; v < igraph_vcount(&globalGraph); ++v)
+// Sampled betweenness for graphs too large for the exact scores. Every score
+// is within errorBound * n(n - 1) (halved for undirected graphs) of the exact
+// one with probability 1 - delta; the seed makes runs reproducible.
+val approximate_betweenness(double epsilon, double delta, double seed, bool columnar)
+{
+    BetweennessSample info;
+    const CsrGraph &csr = graph_csr();
+    std::vector<double> scores;
     {
-        val c = val::object();
-        double centrality = closeness.at(v);
-        double scaled_centrality = scaleCentrality(isnan(centrality) ? 0 : centrality, max_centrality);
+        KernelTimer timer(csr, "sampled_betweenness");
+        scores = sampled_betweenness(csr, epsilon, delta, static_cast<uint64_t>(seed), info);
+    }
+    double max = scores.empty() ? 0 : *std::max_element(scores.begin(), scores.end());
 
-        std::stringstream stream;
-        stream << std::fixed << std::setprecision(4) << centrality;
+    const double n = scores.size();
+    const double pairs = n * (n - 1) * (igraph_is_directed(&currentGraph->graph) ? 1.0 : 0.5);
 
-        sizeMap.set(v, scaled_centrality);
-        colorMap.set(v, 1);
-        c.set("node", v);
-        c.set("centrality", std::stod(stream.str()));
-        centralities.set(v, c);
+    val data = val::object();
+    data.set("algorithm", "Approximate Betweenness Centrality");
+    data.set("epsilon", epsilon);
+    data.set("delta", delta);
+    data.set("seed", seed);
+    data.set("exact", info.exact);
+    data.set("samples", static_cast<double>(info.samples));
+    data.set("vertexDiameterBound", static_cast<double>(info.vertexDiameter));
+    data.set("errorBound", info.errorBound);
+    data.set("scoreErrorBound", info.errorBound * pairs);
+    return centrality_result(scores, max, 2, columnar, data);
+}
+
+// Normalized like igraph_closeness(): the inverse mean distance to the
+// reached vertices, NaN for vertices that reach nothing
+val closeness_centrality(bool columnar)
+{
+    const CsrGraph &csr = graph_csr();
+    DistanceSums sums;
+    {
+        KernelTimer timer(csr, "bfs_distance_sums");
+        sums = bfs_distance_sums(csr);
     }
-    data.set("centralities", centralities);
 
-    result.set("sizeMap", sizeMap);
-    result.set("colorMap", colorMap);
-    result.set("mode", MODE_SIZE_SCALAR);
-    result.set("data", data);
-    return result;
+    std::vector<double> scores(sums.total.size());
+    double max = NEGINF;
+    for (size_t v = 0; v < scores.size(); ++v)
+    {
+        scores[v] = sums.total[v] == 0 ? NAN : (sums.reached[v] - 1) / sums.total[v];
+        if (!std::isnan(scores[v]) && scores[v] > max)
+            max = scores[v];
+    }
+
+    val data = val::object();
+    data.set("algorithm", "Closeness Centrality");
+    return centrality_result(scores, max, 4, columnar, data);
 }
 
-val degree_centrality(void)
+val degree_centrality(bool columnar)
 {
     IGraphVectorInt degrees;
 
-    igraph_degree(&globalGraph, degrees.vec(), igraph_vss_all(), IGRAPH_OUT, IGRAPH_NO_LOOPS);
+    igraph_degree(&currentGraph->graph, degrees.vec(), igraph_vss_all(), IGRAPH_OUT, IGRAPH_NO_LOOPS);
+
+    std::vector<double> scores(degrees.size());
+    for (size_t v = 0; v < scores.size(); ++v)
+    {
+        scores[v] = degrees.at(v);
+    }
 
-    double max_centrality = degrees.max();
-    val result = val::object();
-    val sizeMap = val::object();
-    val colorMap = val::object();
     val data = val::object();
     data.set("algorithm", "Degree Centrality");
+    return centrality_result(scores, degrees.max(), 2, columnar, data);
+}
 
-    val centralities = val::array();
-
-    for (igraph_integer_t v = 0; v < degrees.size(); ++v)
+// Reads the optional {tolerance, maxIterations, start} of the power
+// iteration kernels; undefined or null keeps the defaults
+static SpectralOptions spectral_options(val options)
+{
+    SpectralOptions parsed;
+    if (options.isUndefined() || options.isNull())
+        return parsed;
+    if (!options["tolerance"].isUndefined())
+        parsed.tolerance = options["tolerance"].as<double>();
+    if (!options["maxIterations"].isUndefined())
+        parsed.maxIterations = options["maxIterations"].as<int>();
+    if (!options["start"].isUndefined() && !options["start"].isNull())
+        parsed.start = convertJSArrayToNumberVector<double>(options["start"]);
+
+    if (!(parsed.tolerance >= 0) || parsed.maxIterations < 1)
     {
-        val c = val::object();
-        double centrality = degrees.at(v);
-        double scaled_centrality = scaleCentrality(centrality, max_centrality);
-
-        std::stringstream stream;
-        stream << std::fixed << std::setprecision(2) << centrality;
-
-        sizeMap.set(v, scaled_centrality);
-        colorMap.set(v, 1);
-        c.set("node", v);
-        c.set("centrality", std::stod(stream.str()));
-        centralities.set(v, c);
+        throw std::runtime_error("Power iteration needs a non-negative tolerance and at least one iteration");
     }
-    data.set("centralities", centralities);
-
-    result.set("sizeMap", sizeMap);
-    result.set("colorMap", colorMap);
-    result.set("mode", MODE_SIZE_SCALAR);
-    result.set("data", data);
-    return result;
+    return parsed;
 }
 
-val eigenvector_centrality(void)
+static void set_iteration_data(val &data, const SpectralResult &result)
 {
-    IGraphVector evs;
-    igraph_real_t value;
-
-    igraph_eigenvector_centrality(&globalGraph, evs.vec(), &value, IGRAPH_DIRECTED, false, igraph_weights(), NULL);
-
-    double max_centrality = evs.max();
-    val result = val::object();
-    val sizeMap = val::object();
-    val colorMap = val::object();
-    val data = val::object();
-    data.set("algorithm", "Eigenvector Centrality");
+    data.set("iterations", result.iterations);
+    data.set("residual", result.residual);
+    data.set("converged", result.converged);
+    data.set("warmStarted", result.warmStarted);
+    if (!result.warning.empty())
+        data.set("warning", result.warning);
+}
 
+static std::string rounded(double value)
+{
     std::stringstream stream;
     stream << std::fixed << std::setprecision(2) << value;
-    data.set("eigenvalue", std::stod(stream.str()));
+    return stream.str();
+}
 
-    val centralities = val::array();
-    for (igraph_integer_t v = 0; v < evs.size(); ++v)
+// Power iteration on the CSR snapshot (spectral.cpp); igraph's ARPACK solver
+// handles weights that are not all positive
+val eigenvector_centrality(bool columnar, val options)
+{
+    const SpectralOptions parsed = spectral_options(options);
+    const CsrGraph &csr = graph_csr();
+    SpectralResult result;
+    if (csr.positiveWeights)
     {
-        val c = val::object();
-        double centrality = evs.at(v);
-        double scaled_centrality = scaleCentrality(centrality, max_centrality);
-
-        std::stringstream stream;
-        stream << std::fixed << std::setprecision(4) << centrality;
-
-        sizeMap.set(v, scaled_centrality);
-        colorMap.set(v, 1);
-        c.set("node", v);
-        c.set("centrality", std::stod(stream.str()));
-        centralities.set(v, c);
+        KernelTimer timer(csr, "spectral_eigenvector");
+        result = spectral_eigenvector(csr, parsed);
     }
-    data.set("centralities", centralities);
+    else
+    {
+        IGraphVector evs;
+        igraph_eigenvector_centrality(&currentGraph->graph, evs.vec(), &result.value, IGRAPH_DIRECTED, false, igraph_weights(), NULL);
+        result.scores = to_scores(evs);
+        result.converged = true;
+    }
+    double max = result.scores.empty() ? 0 : *std::max_element(result.scores.begin(), result.scores.end());
 
-    result.set("sizeMap", sizeMap);
-    result.set("colorMap", colorMap);
-    result.set("mode", MODE_SIZE_SCALAR);
-    result.set("data", data);
-    return result;
+    val data = val::object();
+    data.set("algorithm", "Eigenvector Centrality");
+    data.set("eigenvalue", std::stod(rounded(result.value)));
+    set_iteration_data(data, result);
+    return centrality_result(result.scores, max, 4, columnar, data);
 }
 
-val harmonic_centrality(void)
+// Katz centrality, alpha A x + beta with A taken along in-edges. Needs alpha
+// below 1 / the largest eigenvalue of A.
+val katz_centrality(double alpha, double beta, bool columnar, val options)
 {
-    IGraphVector scores;
-
-    igraph_harmonic_centrality(&globalGraph, scores.vec(), igraph_vss_all(), IGRAPH_OUT, igraph_weights(), true);
+    const SpectralOptions parsed = spectral_options(options);
+    const CsrGraph &csr = graph_csr();
+    if (!csr.positiveWeights)
+    {
+        throw std::runtime_error("Katz centrality needs positive edge weights");
+    }
+    SpectralResult result;
+    {
+        KernelTimer timer(csr, "spectral_katz");
+        result = spectral_katz(csr, alpha, beta, parsed);
+    }
+    double max = result.scores.empty() ? 0 : *std::max_element(result.scores.begin(), result.scores.end());
 
-    double max_centrality = scores.max();
-    val result = val::object();
-    val sizeMap = val::object();
-    val colorMap = val::object();
     val data = val::object();
-    data.set("algorithm", "Harmonic Centrality");
+    data.set("algorithm", "Katz Centrality");
+    data.set("alpha", alpha);
+    data.set("beta", beta);
+    set_iteration_data(data, result);
+    return centrality_result(result.scores, max, 4, columnar, data);
+}
 
-    val centralities = val::array();
-    for (igraph_integer_t v = 0; v < igraph_vcount(&globalGraph); ++v)
+// Kleinberg's hubs and authorities. Sizes follow the authority scores; the
+// hub scores come along in data.hubs, by vertex like the scores.
+val hits(bool columnar, val options)
+{
+    const SpectralOptions parsed = spectral_options(options);
+    const CsrGraph &csr = graph_csr();
+    SpectralResult result;
+    if (csr.positiveWeights)
     {
-        val c = val::object();
-        double centrality = scores.at(v);
-        double scaled_centrality = scaleCentrality(isnan(centrality) ? 0 : centrality, max_centrality);
+        KernelTimer timer(csr, "spectral_hits");
+        result = spectral_hits(csr, parsed);
+    }
+    else
+    {
+        IGraphVector hubs, authorities;
+        igraph_hub_and_authority_scores(&currentGraph->graph, hubs.vec(), authorities.vec(), &result.value, true, igraph_weights(), NULL);
+        result.scores = to_scores(authorities);
+        result.hubs = to_scores(hubs);
+        result.converged = true;
+    }
 
-        std::stringstream stream;
-        stream << std::fixed << std::setprecision(4) << centrality;
+    val data = val::object();
+    data.set("algorithm", "HITS");
+    data.set("eigenvalue", std::stod(rounded(result.value)));
+    data.set("hubs", val::global("Float64Array").new_(typed_memory_view(result.hubs.size(), result.hubs.data())));
+    set_iteration_data(data, result);
+    return centrality_result(result.scores, 1, 4, columnar, data);
+}
 
-        sizeMap.set(v, scaled_centrality);
-        colorMap.set(v, 1);
-        c.set("node", v);
-        c.set("centrality", std::stod(stream.str()));
-        centralities.set(v, c);
+val harmonic_centrality(bool columnar)
+{
+    std::vector<double> scores;
+    double max = 0;
+
+    if (igraph_weights() == NULL)
+    {
+        // Unweighted: multi-source BFS, normalized like igraph by n - 1
+        const CsrGraph &csr = graph_csr();
+        DistanceSums sums;
+        {
+            KernelTimer timer(csr, "bfs_distance_sums");
+            sums = bfs_distance_sums(csr);
+        }
+        const double scale = sums.inverse.size() > 1 ? 1.0 / (sums.inverse.size() - 1) : 1.0;
+        scores.resize(sums.inverse.size());
+        for (size_t v = 0; v < scores.size(); ++v)
+            scores[v] = sums.inverse[v] * scale;
+        if (!scores.empty())
+            max = *std::max_element(scores.begin(), scores.end());
+    }
+    else
+    {
+        IGraphVector harmonic;
+        igraph_harmonic_centrality(&currentGraph->graph, harmonic.vec(), igraph_vss_all(), IGRAPH_OUT, igraph_weights(), true);
+        scores = to_scores(harmonic);
+        max = harmonic.max();
     }
-    data.set("centralities", centralities);
 
-    result.set("sizeMap", sizeMap);
-    result.set("colorMap", colorMap);
-    result.set("mode", MODE_SIZE_SCALAR);
-    result.set("data", data);
-    return result;
+    val data = val::object();
+    data.set("algorithm", "Harmonic Centrality");
+    return centrality_result(scores, max, 4, columnar, data);
 }
 
-val strength(void)
+val strength(bool columnar)
 {
     IGraphVector strengths;
 
-    igraph_strength(&globalGraph, strengths.vec(), igraph_vss_all(), IGRAPH_OUT, IGRAPH_NO_LOOPS, igraph_weights());
+    igraph_strength(&currentGraph->graph, strengths.vec(), igraph_vss_all(), IGRAPH_OUT, IGRAPH_NO_LOOPS, igraph_weights());
 
-    double max_centrality = strengths.max();
-    val result = val::object();
-    val sizeMap = val::object();
-    val colorMap = val::object();
     val data = val::object();
     data.set("algorithm", "Strength Centrality");
-
-    val centralities = val::array();
-    for (igraph_integer_t v = 0; v < strengths.size(); ++v)
-    {
-        val c = val::object();
-        double centrality = strengths.at(v);
-        double scaled_centrality = scaleCentrality(centrality, max_centrality);
-
-        std::stringstream stream;
-        stream << std::fixed << std::setprecision(2) << centrality;
-
-        sizeMap.set(v, scaled_centrality);
-        colorMap.set(v, 1);
-        c.set("node", v);
-        c.set("centrality", std::stod(stream.str()));
-        centralities.set(v, c);
-    }
-    data.set("centralities", centralities);
-
-    result.set("sizeMap", sizeMap);
-    result.set("colorMap", colorMap);
-    result.set("mode", MODE_SIZE_SCALAR);
-    result.set("data", data);
-    return result;
+    return centrality_result(to_scores(strengths), strengths.max(), 2, columnar, data);
 }
 
-val pagerank(igraph_real_t damping)
+// Power iteration on the CSR snapshot (spectral.cpp); igraph's PRPACK
+// solver handles weights that are not all positive
+val pagerank(igraph_real_t damping, bool columnar, val options)
 {
-    igraph_real_t value;
-    IGraphVector vec;
-
-    std::stringstream stream;
-    stream << std::fixed << std::setprecision(2) << damping;
-
-    igraph_pagerank(&globalGraph, IGRAPH_PAGERANK_ALGO_PRPACK, vec.vec(), &value, igraph_vss_all(), IGRAPH_DIRECTED, damping, igraph_weights(), NULL);
+    const SpectralOptions parsed = spectral_options(options);
+    const CsrGraph &csr = graph_csr();
+    SpectralResult result;
+    if (csr.positiveWeights)
+    {
+        KernelTimer timer(csr, "spectral_pagerank");
+        result = spectral_pagerank(csr, damping, parsed);
+    }
+    else
+    {
+        IGraphVector vec;
+        igraph_pagerank(&currentGraph->graph, IGRAPH_PAGERANK_ALGO_PRPACK, vec.vec(), &result.value, igraph_vss_all(), IGRAPH_DIRECTED, damping, igraph_weights(), NULL);
+        result.scores = to_scores(vec);
+        result.converged = true;
+    }
+    double max = result.scores.empty() ? 0 : *std::max_element(result.scores.begin(), result.scores.end());
 
-    double max_centrality = vec.max();
-    val result = val::object();
-    val sizeMap = val::object();
-    val colorMap = val::object();
     val data = val::object();
     data.set("algorithm", "PageRank");
+    data.set("damping", rounded(damping));
+    set_iteration_data(data, result);
+    return centrality_result(result.scores, max, 4, columnar, data);
+}
 
-    data.set("damping", stream.str());
-
-    val centralities = val::array();
-    for (igraph_integer_t v = 0; v < vec.size(); ++v)
+// PageRank restarting at the seed vertices, estimated by forward push
+// (push.cpp) to within epsilon per unit of out-degree. Only the
+// neighbourhood the walk reaches is visited; the k best scores come back as
+// typed arrays (all touched vertices for k <= 0).
+val personalized_pagerank(val seeds_js, double damping, double epsilon, int k)
+{
+    std::vector<int32_t> seeds = convertJSArrayToNumberVector<int32_t>(seeds_js);
+    const CsrGraph &csr = graph_csr();
+    PushEstimate estimate;
     {
-        val c = val::object();
-        double centrality = vec.at(v);
-        double scaled_centrality = scaleCentrality(centrality, max_centrality);
+        KernelTimer timer(csr, "personalized_push");
+        estimate = personalized_push(csr, seeds, damping, epsilon, k > 0 ? k : 0);
+    }
 
-        std::stringstream stream;
-        stream << std::fixed << std::setprecision(4) << centrality;
+    HighlightBuffer highlight;
+    for (int32_t v : estimate.vertices)
+        highlight.vertex(v, 0.5);
+    for (int32_t v : seeds)
+        highlight.vertex(v, 1);
 
-        sizeMap.set(v, scaled_centrality);
-        colorMap.set(v, 1);
-        c.set("node", v);
-        c.set("centrality", std::stod(stream.str()));
-        centralities.set(v, c);
-    }
-    data.set("centralities", centralities);
+    val data = val::object();
+    data.set("algorithm", "Personalized PageRank");
+    data.set("damping", damping);
+    data.set("epsilon", epsilon);
+    data.set("vertices", val::global("Int32Array").new_(typed_memory_view(estimate.vertices.size(), estimate.vertices.data())));
+    data.set("scores", val::global("Float64Array").new_(typed_memory_view(estimate.scores.size(), estimate.scores.data())));
+    data.set("pushes", static_cast<double>(estimate.pushes));
+    data.set("touched", static_cast<double>(estimate.touched));
+    data.set("residual", estimate.residual);
 
-    result.set("sizeMap", sizeMap);
-    result.set("colorMap", colorMap);
-    result.set("mode", MODE_SIZE_SCALAR);
+    val result = val::object();
+    result.set("highlight", highlight.to_val());
+    result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     result.set("data", data);
     return result;
 }
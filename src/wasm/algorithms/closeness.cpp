@@ -0,0 +1,74 @@
+#include "../graph.h"
+#include "msbfs.h"
+#include <algorithm>
+#include <vector>
+
+// Unweighted distance sums for closeness and harmonic centrality, computed
+// for all sources with the multi-source BFS in msbfs.h. Batches of sources
+// are handed out to the pool threads; every thread keeps its own traversal
+// scratch and writes only the sums of the sources in its batch.
+
+// Scratch budget across all pool threads before falling back to 64-source
+// batches (three bitsets per vertex and thread)
+#define MSBFS_SCRATCH_BUDGET (256u << 20)
+
+template <size_t Words>
+static void batched_sums(const EdgeRows &rows, DistanceSums &sums)
+{
+    typedef MsBfs<Words> Bfs;
+    const size_t n = rows.offsets.size() - 1;
+    const size_t batches = (n + Bfs::BATCH - 1) / Bfs::BATCH;
+
+    std::vector<int32_t> sources(n);
+    for (size_t v = 0; v < n; ++v)
+        sources[v] = static_cast<int32_t>(v);
+
+    TaskPool &pool = TaskPool::instance();
+    std::vector<std::unique_ptr<Bfs>> scratch(pool.size());
+    ProgressCounter progress(n);
+    pool.parallel_for(0, batches, 1, [&](size_t lo, size_t hi, unsigned thread)
+                      {
+        if (!scratch[thread])
+            scratch[thread].reset(new Bfs(rows));
+        for (size_t b = lo; b < hi; ++b)
+        {
+            const size_t first = b * Bfs::BATCH;
+            const size_t count = std::min(Bfs::BATCH, n - first);
+            scratch[thread]->run(&sources[first], count, [&](int32_t, int32_t depth, const typename Bfs::Bits &reached)
+                                 { Bfs::for_each_source(reached, [&](size_t i)
+                                                        {
+                const size_t s = first + i;
+                sums.reached[s]++;
+                if (depth > 0)
+                {
+                    sums.total[s] += depth;
+                    sums.inverse[s] += 1.0 / depth;
+                } }); });
+            progress.add(count);
+        } });
+}
+
+DistanceSums bfs_distance_sums(const CsrGraph &csr)
+{
+    const size_t n = csr.vertices;
+    DistanceSums sums;
+    sums.total.assign(n, 0);
+    sums.inverse.assign(n, 0);
+    sums.reached.assign(n, 0);
+    if (n == 0)
+        return sums;
+
+    // Out-distances, following both directions in undirected graphs
+    const EdgeRows &rows = csr.out();
+
+    const size_t wide = 3 * n * sizeof(MsBfs<4>::Bits) * TaskPool::instance().size();
+    if (n > MsBfs<1>::BATCH && wide <= MSBFS_SCRATCH_BUDGET)
+        batched_sums<4>(rows, sums);
+    else
+        batched_sums<1>(rows, sums);
+
+    sums.total = csr.to_original(std::move(sums.total));
+    sums.inverse = csr.to_original(std::move(sums.inverse));
+    sums.reached = csr.to_original(std::move(sums.reached));
+    return sums;
+}
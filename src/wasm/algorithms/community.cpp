@@ -4,7 +4,7 @@
 
 void throw_error_if_directed(const std::string &algorithm)
 {
-    if (igraph_is_directed(&globalGraph))
+    if (igraph_is_directed(&currentGraph->graph))
     {
         std::string message = "The " + algorithm + " algorithm does not support directed graphs";
         throw std::runtime_error(message);
@@ -13,7 +13,7 @@ void throw_error_if_directed(const std::string &algorithm)
 
 void throw_error_if_undirected(const std::string &algorithm)
 {
-    if (!igraph_is_directed(&globalGraph))
+    if (!igraph_is_directed(&currentGraph->graph))
     {
         std::string message = "The " + algorithm + " algorithm does not support undirected graphs";
         throw std::runtime_error(message);
@@ -28,8 +28,9 @@ val louvain(igraph_real_t resolution)
     std::stringstream stream;
 
     throw_error_if_directed("Louvain");
-    igraph_community_multilevel(&globalGraph, igraph_weights(), resolution, membership.vec(), NULL, modularity.vec());
-    igraph_modularity(&globalGraph, membership.vec(), igraph_weights(), resolution, IGRAPH_DIRECTED, &modularity_metric);
+    igraph_community_multilevel(&currentGraph->graph, igraph_weights(), resolution, membership.vec(), NULL, modularity.vec());
+    throw_if_cancelled();
+    igraph_modularity(&currentGraph->graph, membership.vec(), igraph_weights(), resolution, IGRAPH_DIRECTED, &modularity_metric);
 
     val result = val::object();
     val colorMap = val::object();
@@ -39,12 +40,12 @@ val louvain(igraph_real_t resolution)
     stream << std::fixed << std::setprecision(2) << modularity_metric;
     data.set("modularity", std::stod(stream.str()));
 
-    std::map<int, std::vector<std::string>> communityMap;
+    std::map<int, std::vector<val>> communityMap;
     for (igraph_integer_t v = 0; v < membership.size(); ++v)
     {
         igraph_integer_t community = membership.at(v);
         colorMap.set(v, community);
-        communityMap[community].push_back(igraph_get_name(v));
+        communityMap[community].push_back(vertex_name(v));
     }
 
     val communities = val::array();
@@ -68,8 +69,8 @@ val leiden(igraph_real_t resolution)
     std::stringstream stream, stream2;
 
     throw_error_if_directed("Leiden");
-    igraph_community_leiden(&globalGraph, igraph_weights(), NULL, resolution, 0.01, false, n_iterations, membership.vec(), NULL, &quality);
-    igraph_modularity(&globalGraph, membership.vec(), igraph_weights(), resolution, IGRAPH_DIRECTED, &modularity_metric);
+    igraph_community_leiden(&currentGraph->graph, igraph_weights(), NULL, resolution, 0.01, false, n_iterations, membership.vec(), NULL, &quality);
+    igraph_modularity(&currentGraph->graph, membership.vec(), igraph_weights(), resolution, IGRAPH_DIRECTED, &modularity_metric);
 
     val result = val::object();
     val colorMap = val::object();
@@ -82,12 +83,12 @@ val leiden(igraph_real_t resolution)
     stream2 << std::fixed << std::setprecision(2) << quality;
     data.set("quality", std::stod(stream2.str()));
 
-    std::map<int, std::vector<std::string>> communityMap;
+    std::map<int, std::vector<val>> communityMap;
     for (igraph_integer_t v = 0; v < membership.size(); ++v)
     {
         igraph_integer_t community = membership.at(v);
         colorMap.set(v, community);
-        communityMap[community].push_back(igraph_get_name(v));
+        communityMap[community].push_back(vertex_name(v));
     }
 
     val communities = val::array();
@@ -110,7 +111,7 @@ val fast_greedy(void)
     std::stringstream stream;
 
     throw_error_if_directed("Fast-Greedy");
-    igraph_community_fastgreedy(&globalGraph, igraph_weights(), NULL, modularity.vec(), membership.vec());
+    igraph_community_fastgreedy(&currentGraph->graph, igraph_weights(), NULL, modularity.vec(), membership.vec());
 
     val result = val::object();
     val colorMap = val::object();
@@ -120,12 +121,12 @@ val fast_greedy(void)
     stream << std::fixed << std::setprecision(2) << modularity.max();
     data.set("modularity", std::stod(stream.str()));
 
-    std::map<int, std::vector<std::string>> communityMap;
+    std::map<int, std::vector<val>> communityMap;
     for (igraph_integer_t v = 0; v < membership.size(); ++v)
     {
         igraph_integer_t community = membership.at(v);
         colorMap.set(v, community);
-        communityMap[community].push_back(igraph_get_name(v));
+        communityMap[community].push_back(vertex_name(v));
     }
 
     val communities = val::array();
@@ -145,19 +146,19 @@ val label_propagation(void)
 {
     IGraphVectorInt membership;
 
-    igraph_community_label_propagation(&globalGraph, membership.vec(), IGRAPH_OUT, igraph_weights(), NULL, NULL);
+    igraph_community_label_propagation(&currentGraph->graph, membership.vec(), IGRAPH_OUT, igraph_weights(), NULL, NULL);
 
     val result = val::object();
     val colorMap = val::object();
     val data = val::object();
     data.set("algorithm", "Label Propagation");
 
-    std::map<int, std::vector<std::string>> communityMap;
+    std::map<int, std::vector<val>> communityMap;
     for (igraph_integer_t v = 0; v < membership.size(); ++v)
     {
         igraph_integer_t community = membership.at(v);
         colorMap.set(v, community);
-        communityMap[community].push_back(igraph_get_name(v));
+        communityMap[community].push_back(vertex_name(v));
     }
 
     val communities = val::array();
@@ -177,7 +178,7 @@ val local_clustering_coefficient(void)
 {
     IGraphVector res;
 
-    igraph_transitivity_local_undirected(&globalGraph, res.vec(), igraph_vss_all(), IGRAPH_TRANSITIVITY_ZERO);
+    igraph_transitivity_local_undirected(&currentGraph->graph, res.vec(), igraph_vss_all(), IGRAPH_TRANSITIVITY_ZERO);
 
     igraph_real_t global_transitivity = res.avg_ignore_zeros();
     double max_transitivity = res.max_nonan();
@@ -217,7 +218,7 @@ val local_clustering_coefficient(void)
 val k_core(int k)
 {
     IGraphVectorInt coreness, vertices_to_keep;
-    igraph_coreness(&globalGraph, coreness.vec(), IGRAPH_OUT);
+    igraph_coreness(&currentGraph->graph, coreness.vec(), IGRAPH_OUT);
 
     for (igraph_integer_t v = 0; v < coreness.size(); ++v)
     {
@@ -227,36 +228,21 @@ val k_core(int k)
         }
     }
 
-    // Create a map to store the original vertex IDs
-    std::map<igraph_integer_t, igraph_integer_t> original_ids;
-    for (int i = 0; i < vertices_to_keep.size(); i++)
-    {
-        original_ids[i] = vertices_to_keep.at(i);
-    }
-
-    // create induced subgraph
-    igraph_t subgraph;
-    igraph_vs_t vs;
-    igraph_vs_vector(&vs, vertices_to_keep.vec());
-    igraph_induced_subgraph(&globalGraph, &subgraph, vs, IGRAPH_SUBGRAPH_AUTO);
-
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "K-Core Detection");
 
-    for (igraph_integer_t e = 0; e < igraph_ecount(&subgraph); ++e)
+    // Edges of the induced subgraph, read straight from the CSR endpoints
+    const CsrGraph &csr = graph_csr();
+    for (int32_t e = 0; e < csr.edgeCount; ++e)
     {
-        igraph_integer_t from, to;
-        igraph_edge(&subgraph, e, &from, &to);
-
-        int from_id = original_ids[from];
-        int to_id = original_ids[to];
-
-        std::string linkId = std::to_string(from_id) + "-" + std::to_string(to_id);
-        colorMap.set(linkId, 1);
-        colorMap.set(from_id, 0.5);
-        colorMap.set(to_id, 0.5);
+        const int32_t from_id = csr.from[e], to_id = csr.to[e];
+        if (coreness.at(from_id) < k || coreness.at(to_id) < k)
+            continue;
+        highlight.edge(from_id, to_id, 1);
+        highlight.vertex(from_id, 0.5);
+        highlight.vertex(to_id, 0.5);
     }
 
     val cores = val::array();
@@ -268,12 +254,9 @@ val k_core(int k)
     data.set("cores", cores);
     data.set("k", k);
     data.set("max_coreness", coreness.max());
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     result.set("data", data);
-
-    igraph_destroy(&subgraph);
-    igraph_vs_destroy(&vs);
     return result;
 }
 
@@ -281,10 +264,10 @@ val triangles(void)
 {
     IGraphVectorInt res;
 
-    igraph_list_triangles(&globalGraph, res.vec());
+    igraph_list_triangles(&currentGraph->graph, res.vec());
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Triangle Count");
 
@@ -293,26 +276,22 @@ val triangles(void)
     for (igraph_integer_t v = 0; v < res.size(); v += 3)
     {
         val t = val::object();
-        t.set("node1", igraph_get_name(res.at(v)));
-        t.set("node2", igraph_get_name(res.at(v + 1)));
-        t.set("node3", igraph_get_name(res.at(v + 2)));
+        t.set("node1", vertex_name(res.at(v)));
+        t.set("node2", vertex_name(res.at(v + 1)));
+        t.set("node3", vertex_name(res.at(v + 2)));
         t.set("id", id++);
         triangles.call<void>("push", t);
 
-        colorMap.set(res.at(v), 0.5);
-        colorMap.set(res.at(v + 1), 0.5);
-        colorMap.set(res.at(v + 2), 0.5);
-
-        std::string linkId1 = std::to_string(res.at(v)) + "-" + std::to_string(res.at(v + 1));
-        std::string linkId2 = std::to_string(res.at(v + 1)) + "-" + std::to_string(res.at(v + 2));
-        std::string linkId3 = std::to_string(res.at(v + 2)) + "-" + std::to_string(res.at(v));
-        colorMap.set(linkId1, 1);
-        colorMap.set(linkId2, 1);
-        colorMap.set(linkId3, 1);
+        highlight.vertex(res.at(v), 0.5);
+        highlight.vertex(res.at(v + 1), 0.5);
+        highlight.vertex(res.at(v + 2), 0.5);
+        highlight.edge(res.at(v), res.at(v + 1), 1);
+        highlight.edge(res.at(v + 1), res.at(v + 2), 1);
+        highlight.edge(res.at(v + 2), res.at(v), 1);
     }
 
     data.set("triangles", triangles);
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     result.set("data", data);
     return result;
@@ -322,7 +301,7 @@ val connected_components(igraph_connectedness_t mode)
 {
     IGraphVectorInt membership;
 
-    igraph_connected_components(&globalGraph, membership.vec(), NULL, NULL, mode);
+    igraph_connected_components(&currentGraph->graph, membership.vec(), NULL, NULL, mode);
 
     val result = val::object();
     val colorMap = val::object();
@@ -336,12 +315,12 @@ val connected_components(igraph_connectedness_t mode)
         data.set("algorithm", "Weakly Connected Components");
     }
 
-    std::map<int, std::vector<std::string>> componentMap;
+    std::map<int, std::vector<val>> componentMap;
     for (igraph_integer_t v = 0; v < membership.size(); ++v)
     {
         igraph_integer_t component = membership.at(v);
         colorMap.set(v, component);
-        componentMap[component].push_back(igraph_get_name(v));
+        componentMap[component].push_back(vertex_name(v));
     }
 
     val components = val::array();
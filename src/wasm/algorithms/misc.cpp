@@ -4,35 +4,34 @@
 val vertices_are_adjacent(igraph_integer_t src, igraph_integer_t tar)
 {
     igraph_bool_t res;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
+    bool hasWeights = igraph_weights() != NULL;
 
-    igraph_are_connected(&globalGraph, src, tar, &res);
+    igraph_are_connected(&currentGraph->graph, src, tar, &res);
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Check Adjacency");
 
-    data.set("source", igraph_get_name(src));
-    data.set("target", igraph_get_name(tar));
-    colorMap.set(src, 1);
-    colorMap.set(tar, 1);
+    data.set("source", vertex_name(src));
+    data.set("target", vertex_name(tar));
+    highlight.vertex(src, 1);
+    highlight.vertex(tar, 1);
 
     if (res)
     {
-        std::string linkId = std::to_string(src) + '-' + std::to_string(tar);
-        colorMap.set(linkId, 1);
+        highlight.edge(src, tar, 1);
         if (hasWeights)
         {
             igraph_integer_t eid;
-            igraph_get_eid(&globalGraph, &eid, src, tar, true, 0);
-            double weight = VECTOR(globalWeights)[eid];
+            igraph_get_eid(&currentGraph->graph, &eid, src, tar, true, 0);
+            double weight = VECTOR(*igraph_weights())[eid];
             data.set("weight", weight);
         }
     }
 
     data.set("adjacent", res);
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     result.set("data", data);
     return result;
@@ -53,13 +52,13 @@ val jaccard_similarity(val js_vs_list)
     for (size_t i = 0; i < js_vs_list["length"].as<size_t>(); i++)
     {
         igraph_integer_t nodeId = js_vs_list[i].as<igraph_integer_t>();
-        nodes.set(i, igraph_get_name(nodeId));
+        nodes.set(i, vertex_name(nodeId));
         colorMap.set(nodeId, 1);
         vs_list.push_back(nodeId);
     }
 
     igraph_vs_vector(&vs, vs_list.vec());
-    igraph_similarity_jaccard(&globalGraph, m.mat(), vs, IGRAPH_OUT, false);
+    igraph_similarity_jaccard(&currentGraph->graph, m.mat(), vs, IGRAPH_OUT, false);
 
     val rows = val::array();
     double max_similarity = -1.0;
@@ -79,8 +78,8 @@ val jaccard_similarity(val js_vs_list)
                 max_similarity = similarity;
                 int nodeId1 = vs_list.at(i);
                 int nodeId2 = vs_list.at(j);
-                max_pair.set("node1", igraph_get_name(nodeId1));
-                max_pair.set("node2", igraph_get_name(nodeId2));
+                max_pair.set("node1", vertex_name(nodeId1));
+                max_pair.set("node2", vertex_name(nodeId2));
                 max_pair.set("similarity", similarity);
             }
         }
@@ -100,12 +99,12 @@ val jaccard_similarity(val js_vs_list)
 val topological_sort(void)
 {
     igraph_bool_t isDAG;
-    igraph_is_dag(&globalGraph, &isDAG);
+    igraph_is_dag(&currentGraph->graph, &isDAG);
     if (!isDAG)
         throw std::runtime_error("This graph is not a Directed Acyclic Graph (DAG) and cannot be topologically sorted.");
 
     IGraphVectorInt order;
-    igraph_topological_sorting(&globalGraph, order.vec(), IGRAPH_OUT);
+    igraph_topological_sorting(&currentGraph->graph, order.vec(), IGRAPH_OUT);
 
     val result = val::object();
     val colorMap = val::object();
@@ -137,16 +136,17 @@ val diameter(void)
     igraph_real_t diameter;
     igraph_integer_t src, tar;
     IGraphVectorInt vPath, ePath;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
-    igraph_diameter_dijkstra(&globalGraph, igraph_weights(), &diameter, &src, &tar, vPath.vec(), ePath.vec(), true, true);
+    bool hasWeights = igraph_weights() != NULL;
+    igraph_diameter_dijkstra(&currentGraph->graph, igraph_weights(), &diameter, &src, &tar, vPath.vec(), ePath.vec(), true, true);
+    throw_if_cancelled();
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Diameter");
 
-    data.set("source", igraph_get_name(src));
-    data.set("target", igraph_get_name(tar));
+    data.set("source", vertex_name(src));
+    data.set("target", vertex_name(tar));
     data.set("weighted", hasWeights);
     data.set("diameter", diameter);
 
@@ -154,30 +154,28 @@ val diameter(void)
     for (int i = 0; i < vPath.size(); ++i)
     {
         int node = vPath.at(i);
-        std::string nodeId = std::to_string(node);
-        colorMap.set(nodeId, 0.5);
+        highlight.vertex(node, 0.5);
 
         if (i > 0)
         {
-            std::string linkId = std::to_string(vPath.at(i - 1)) + '-' + nodeId;
-            colorMap.set(linkId, 1);
+            highlight.edge(vPath.at(i - 1), node, 1);
 
             val link = val::object();
-            link.set("from", igraph_get_name(vPath.at(i - 1)));
-            link.set("to", igraph_get_name(node));
+            link.set("from", vertex_name(vPath.at(i - 1)));
+            link.set("to", vertex_name(node));
 
             int weight_index = ePath.at(i - 1);
             if (hasWeights)
             {
-                link.set("weight", VECTOR(globalWeights)[weight_index]);
+                link.set("weight", VECTOR(*igraph_weights())[weight_index]);
             };
             path.set(i - 1, link);
         }
     }
-    colorMap.set(src, 1);
-    colorMap.set(tar, 1);
+    highlight.vertex(src, 1);
+    highlight.vertex(tar, 1);
 
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     data.set("path", path);
     result.set("data", data);
@@ -187,15 +185,15 @@ val diameter(void)
 val eulerian_path(void)
 {
     igraph_bool_t exists;
-    igraph_is_eulerian(&globalGraph, &exists, NULL);
+    igraph_is_eulerian(&currentGraph->graph, &exists, NULL);
     if (!exists)
         throw std::runtime_error("This graph does not have an Eulerian path.");
 
     IGraphVectorInt vPath;
-    igraph_eulerian_path(&globalGraph, NULL, vPath.vec());
+    igraph_eulerian_path(&currentGraph->graph, NULL, vPath.vec());
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Eulerian Path");
 
@@ -204,20 +202,19 @@ val eulerian_path(void)
     {
         int src = vPath.at(i);
         int tar = vPath.at(i + 1);
-        std::string linkId = std::to_string(src) + '-' + std::to_string(tar);
-        colorMap.set(linkId, 1);
+        highlight.edge(src, tar, 1);
 
         val link = val::object();
-        link.set("from", igraph_get_name(src));
-        link.set("to", igraph_get_name(tar));
+        link.set("from", vertex_name(src));
+        link.set("to", vertex_name(tar));
         path.set(i, link);
     }
-    colorMap.set(vPath.at(0), 1);
-    colorMap.set(vPath.at(vPath.size() - 1), 1);
-    data.set("start", igraph_get_name(vPath.at(0)));
-    data.set("end", igraph_get_name(vPath.at(vPath.size() - 1)));
+    highlight.vertex(vPath.at(0), 1);
+    highlight.vertex(vPath.at(vPath.size() - 1), 1);
+    data.set("start", vertex_name(vPath.at(0)));
+    data.set("end", vertex_name(vPath.at(vPath.size() - 1)));
 
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     data.set("path", path);
     result.set("data", data);
@@ -227,7 +224,7 @@ val eulerian_path(void)
 val eulerian_circuit(void)
 {
     igraph_bool_t pathExists, circuitExists;
-    igraph_is_eulerian(&globalGraph, &pathExists, &circuitExists);
+    igraph_is_eulerian(&currentGraph->graph, &pathExists, &circuitExists);
     if (!circuitExists)
     {
         if (pathExists)
@@ -241,10 +238,10 @@ val eulerian_circuit(void)
     }
 
     IGraphVectorInt vPath;
-    igraph_eulerian_cycle(&globalGraph, NULL, vPath.vec());
+    igraph_eulerian_cycle(&currentGraph->graph, NULL, vPath.vec());
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Eulerian Circuit");
 
@@ -253,16 +250,15 @@ val eulerian_circuit(void)
     {
         int src = vPath.at(i);
         int tar = vPath.at(i + 1);
-        std::string linkId = std::to_string(src) + '-' + std::to_string(tar);
-        colorMap.set(linkId, 1);
+        highlight.edge(src, tar, 1);
 
         val link = val::object();
-        link.set("from", igraph_get_name(src));
-        link.set("to", igraph_get_name(tar));
+        link.set("from", vertex_name(src));
+        link.set("to", vertex_name(tar));
         path.set(i, link);
     }
 
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     data.set("path", path);
     result.set("data", data);
@@ -271,8 +267,8 @@ val eulerian_circuit(void)
 
 val missing_edge_prediction_default_values(void)
 {
-    int num_nodes = igraph_vcount(&globalGraph);
-    int num_edges = igraph_ecount(&globalGraph);
+    int num_nodes = igraph_vcount(&currentGraph->graph);
+    int num_edges = igraph_ecount(&currentGraph->graph);
     int num_samples, num_bins;
     val result = val::object();
 
@@ -302,19 +298,20 @@ val missing_edge_prediction_default_values(void)
 
 val missing_edge_prediction(int numSamples, int numBins)
 {
-    igraph_hrg_t hrg;
+    IGraphHrg hrg;
     IGraphVectorInt predicted_edges;
     IGraphVector probabilties;
 
     // fit the hrg model to the global graph
-    igraph_hrg_init(&hrg, 0);
-    igraph_hrg_fit(&globalGraph, &hrg, false, 0);
+    igraph_hrg_fit(&currentGraph->graph, hrg.hrg(), false, 0);
+    throw_if_cancelled();
 
     // predict missing edges
-    igraph_hrg_predict(&globalGraph, predicted_edges.vec(), probabilties.vec(), &hrg, false, numSamples, numBins);
+    igraph_hrg_predict(&currentGraph->graph, predicted_edges.vec(), probabilties.vec(), hrg.hrg(), false, numSamples, numBins);
+    throw_if_cancelled();
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "HRG Missing Edge Prediction");
 
@@ -325,16 +322,15 @@ val missing_edge_prediction(int numSamples, int numBins)
     {
         int src = predicted_edges.at(i);
         int tar = predicted_edges.at(i + 1);
-        std::string linkId = std::to_string(src) + '-' + std::to_string(tar);
         igraph_real_t prob = probabilties.at(edgeIndex);
 
         // Only record edges with probability > 0.5
         if (prob < 0.5)
             break;
 
-        colorMap.set(src, 0.5);
-        colorMap.set(tar, 0.5);
-        colorMap.set(linkId, 0);
+        highlight.vertex(src, 0.5);
+        highlight.vertex(tar, 0.5);
+        highlight.edge(src, tar, 0);
 
         // add to graph render object (used by Cosmograph)
         val e = val::object();
@@ -345,19 +341,18 @@ val missing_edge_prediction(int numSamples, int numBins)
         // add to data object
         std::stringstream stream;
         val link = val::object();
-        link.set("from", igraph_get_name(src));
-        link.set("to", igraph_get_name(tar));
+        link.set("from", vertex_name(src));
+        link.set("to", vertex_name(tar));
 
         stream << std::fixed << std::setprecision(3) << prob * 100;
         link.set("probability", stream.str() + "%");
         edgesData.set(edgeIndex++, link);
     }
 
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     data.set("predictedEdges", edgesData);
     result.set("data", data);
     result.set("edges", edges);
-    igraph_hrg_destroy(&hrg);
     return result;
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+#ifndef MSBFS_H
+#define MSBFS_H
+
+#include "../graph.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// MULTI-SOURCE BFS
+// Then et al., "The More the Merrier: Efficient Multi-Source Graph Traversal"
+// (VLDB 2014). Up to 64 * Words unweighted BFS traversals share one pass over
+// the rows per level: every vertex carries one bit per source, and a level
+// ORs each frontier vertex's bits into its neighbours, Words 64-bit lanes at
+// a time. The fixed-size lane loops are what the compiler vectorizes.
+//
+// Usage, e.g. for an all-sources algorithm:
+//
+//   MsBfs<4> bfs(rows);                  // scratch for rows' vertex count
+//   bfs.run(sources, count, [&](int32_t v, int32_t depth, const MsBfs<4>::Bits &reached) {
+//       // reached has bit i set for every source i whose BFS first
+//       // reaches v at this depth (depth 0 is the source itself)
+//   });
+//
+// The visitor is called once per vertex and level at which at least one
+// source reaches it. An instance is not thread-safe; give each pool thread
+// its own and split the sources into batches of MsBfs<Words>::BATCH.
+template <size_t Words>
+class MsBfs
+{
+public:
+    static const size_t BATCH = 64 * Words;
+    typedef std::array<uint64_t, Words> Bits;
+
+    explicit MsBfs(const EdgeRows &rows)
+        : rows(rows), n(rows.offsets.size() - 1), seen(n), frontier(n), next(n)
+    {
+    }
+
+    template <typename Visit>
+    void run(const int32_t *sources, size_t count, Visit visit)
+    {
+        const Bits none = {};
+        std::fill(seen.begin(), seen.end(), none);
+        std::fill(frontier.begin(), frontier.end(), none);
+
+        for (size_t i = 0; i < count && i < BATCH; ++i)
+        {
+            const int32_t s = sources[i];
+            seen[s][i / 64] |= uint64_t(1) << (i % 64);
+            frontier[s][i / 64] |= uint64_t(1) << (i % 64);
+        }
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (any(frontier[v]))
+                visit(static_cast<int32_t>(v), 0, frontier[v]);
+        }
+
+        for (int32_t depth = 1;; ++depth)
+        {
+            std::fill(next.begin(), next.end(), none);
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (!any(frontier[v]))
+                    continue;
+                const Bits &bits = frontier[v];
+                for (int32_t i = rows.offsets[v]; i < rows.offsets[v + 1]; ++i)
+                {
+                    Bits &out = next[rows.targets[i]];
+                    for (size_t k = 0; k < Words; ++k)
+                        out[k] |= bits[k];
+                }
+            }
+
+            bool reachedAny = false;
+            for (size_t v = 0; v < n; ++v)
+            {
+                Bits fresh;
+                for (size_t k = 0; k < Words; ++k)
+                {
+                    fresh[k] = next[v][k] & ~seen[v][k];
+                    seen[v][k] |= fresh[k];
+                }
+                frontier[v] = fresh;
+                if (any(fresh))
+                {
+                    reachedAny = true;
+                    visit(static_cast<int32_t>(v), depth, fresh);
+                }
+            }
+            if (!reachedAny)
+                break;
+        }
+    }
+
+    // Calls f(i) for every source index i set in bits
+    template <typename F>
+    static void for_each_source(const Bits &bits, F f)
+    {
+        for (size_t k = 0; k < Words; ++k)
+        {
+            for (uint64_t word = bits[k]; word != 0; word &= word - 1)
+                f(64 * k + __builtin_ctzll(word));
+        }
+    }
+
+private:
+    static bool any(const Bits &bits)
+    {
+        uint64_t acc = 0;
+        for (size_t k = 0; k < Words; ++k)
+            acc |= bits[k];
+        return acc != 0;
+    }
+
+    const EdgeRows &rows;
+    size_t n;
+    std::vector<Bits> seen, frontier, next;
+};
+
+#endif
@@ -1,57 +1,264 @@
 #include "../graph.h"
 #include <iostream>
 #include <string>
+#include <vector>
+#include <cmath>
+
+// SHORTEST-PATH TREES
+
+// Builds the O(V) result of a single-source query from its shortest-path tree
+// instead of one materialized path per target: predecessor vertex, predecessor
+// edge and distance of every vertex as typed arrays (-1 and Infinity where
+// there is none). The highlight matches the per-path result: tree edges are
+// highlighted and each vertex is shaded by the number of paths through it,
+// which is the size of its subtree.
+static val shortest_path_tree(igraph_integer_t src, IGraphVectorInt &parents, IGraphVectorInt &inbound, const char *algorithm)
+{
+    const igraph_integer_t n = igraph_vcount(&currentGraph->graph);
+    const igraph_vector_t *weights = igraph_weights();
+
+    std::vector<int32_t> pred(n, -1), predEdge(n, -1);
+    std::vector<double> dist(n, INFINITY);
+    for (igraph_integer_t v = 0; v < n; ++v)
+    {
+        if (v != src && parents.at(v) >= 0)
+        {
+            pred[v] = parents.at(v);
+            predEdge[v] = inbound.at(v);
+        }
+    }
+
+    // Order the reached vertices parents first, so that distances and
+    // subtree sizes each take a single pass
+    std::vector<igraph_integer_t> order, chain;
+    std::vector<char> placed(n, 0);
+    order.reserve(n);
+    dist[src] = 0;
+    placed[src] = 1;
+    for (igraph_integer_t v = 0; v < n; ++v)
+    {
+        chain.clear();
+        for (igraph_integer_t u = v; !placed[u] && pred[u] >= 0; u = pred[u])
+            chain.push_back(u);
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            igraph_integer_t u = *it;
+            dist[u] = dist[pred[u]] + (weights ? VECTOR(*weights)[predEdge[u]] : 1);
+            placed[u] = 1;
+            order.push_back(u);
+        }
+    }
+
+    std::vector<int> through(n, 0);
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        igraph_integer_t u = *it;
+        through[u]++;
+        if (pred[u] != src)
+            through[pred[u]] += through[u];
+    }
+
+    val result = val::object();
+    HighlightBuffer highlight;
+    val data = val::object();
+    data.set("algorithm", algorithm);
+
+    data.set("source", vertex_name(src));
+    data.set("weighted", weights != NULL);
+    data.set("reached", order.size());
+
+    std::unordered_map<int, int> fm;
+    for (igraph_integer_t u : order)
+    {
+        highlight.edge(pred[u], u, 1);
+        fm[u] = through[u];
+    }
+    frequenciesToColorMap(fm, highlight);
+    highlight.vertex(src, 1);
+    result.set("highlight", highlight.to_val());
+    result.set("mode", MODE_COLOR_SHADE_ERROR);
+
+    data.set("predecessors", val::global("Int32Array").new_(typed_memory_view(pred.size(), pred.data())));
+    data.set("predecessorEdges", val::global("Int32Array").new_(typed_memory_view(predEdge.size(), predEdge.data())));
+    data.set("distances", val::global("Float64Array").new_(typed_memory_view(dist.size(), dist.data())));
+    result.set("data", data);
+    return result;
+}
+
+// POINT-TO-POINT
+
+// Result of a single-path query answered by the routing kernels, laid out
+// like the igraph-backed ones
+static val path_search_result(const char *algorithm, igraph_integer_t src, igraph_integer_t tar, const PathSearch &search, val data)
+{
+    const igraph_vector_t *weights = igraph_weights();
+
+    val result = val::object();
+    HighlightBuffer highlight;
+    data.set("algorithm", algorithm);
+    data.set("source", vertex_name(src));
+    data.set("target", vertex_name(tar));
+    data.set("weighted", weights != NULL);
+    data.set("settled", static_cast<double>(search.settled));
+
+    val path = val::array();
+    for (size_t i = 0; i < search.vertices.size(); ++i)
+    {
+        highlight.vertex(search.vertices[i], 0.5);
+        if (i == 0)
+            continue;
+        highlight.edge(search.vertices[i - 1], search.vertices[i], 1);
+
+        val link = val::object();
+        link.set("from", vertex_name(search.vertices[i - 1]));
+        link.set("to", vertex_name(search.vertices[i]));
+        if (weights != NULL)
+            link.set("weight", VECTOR(*weights)[search.edges[i - 1]]);
+        path.set(i - 1, link);
+    }
+    highlight.vertex(src, 1);
+    highlight.vertex(tar, 1);
+
+    result.set("highlight", highlight.to_val());
+    result.set("mode", MODE_COLOR_SHADE_DEFAULT);
+    data.set("path", path);
+    if (weights != NULL)
+        data.set("totalWeight", search.vertices.empty() ? 0.0 : search.distance);
+    result.set("data", data);
+    return result;
+}
+
+// SHORTEST-PATH INDEX
+
+// Builds the contraction hierarchy (routing.cpp) for the current graph and
+// weights unless it exists. Point-to-point Dijkstra and Bellman-Ford queries
+// use it until the graph or its weights change.
+val build_shortest_path_index(void)
+{
+    const CsrGraph &csr = graph_csr();
+    bool built = false;
+    const ContractionHierarchy &hierarchy = graph_hierarchy(csr, built);
+
+    val result = val::object();
+    result.set("built", built);
+    result.set("buildMs", hierarchy.buildMs);
+    result.set("bytes", static_cast<double>(hierarchy.bytes()));
+    result.set("shortcuts", static_cast<double>(hierarchy.shortcuts));
+    result.set("arcs", static_cast<double>(hierarchy.arcs.size()));
+    return result;
+}
+
+// Answers a query from the index if one is built, marking the result
+static bool indexed_search(const CsrGraph &csr, const char *algorithm, igraph_integer_t src, igraph_integer_t tar, val &result)
+{
+    if (!csr.hierarchy || !csr.positiveWeights)
+        return false;
+    PathSearch search;
+    {
+        KernelTimer timer(csr, "hierarchy_search");
+        search = hierarchy_search(csr, *csr.hierarchy, src, tar);
+    }
+    val data = val::object();
+    data.set("indexed", true);
+    result = path_search_result(algorithm, src, tar, search, data);
+    return true;
+}
+
+// BATCHES
+
+// Shortest paths for pairs (sources[i], targets[i]) with one search per
+// distinct source (routing.cpp). Returns typed arrays instead of a highlight.
+val shortest_path_pairs(val sources_js, val targets_js, bool paths)
+{
+    std::vector<int32_t> sources = convertJSArrayToNumberVector<int32_t>(sources_js);
+    std::vector<int32_t> targets = convertJSArrayToNumberVector<int32_t>(targets_js);
+    const CsrGraph &csr = graph_csr();
+    PairPaths found;
+    {
+        KernelTimer timer(csr, "many_pairs");
+        found = many_pairs(csr, sources, targets, paths);
+    }
+
+    val result = val::object();
+    result.set("algorithm", "Batched Shortest Paths");
+    result.set("pairs", static_cast<double>(sources.size()));
+    result.set("sources", static_cast<double>(found.sources));
+    result.set("settled", static_cast<double>(found.settled));
+    result.set("distances", val::global("Float64Array").new_(typed_memory_view(found.distances.size(), found.distances.data())));
+    if (paths)
+    {
+        result.set("vertexOffsets", val::global("Int32Array").new_(typed_memory_view(found.vertexOffsets.size(), found.vertexOffsets.data())));
+        result.set("vertices", val::global("Int32Array").new_(typed_memory_view(found.vertices.size(), found.vertices.data())));
+        result.set("edgeOffsets", val::global("Int32Array").new_(typed_memory_view(found.edgeOffsets.size(), found.edgeOffsets.data())));
+        result.set("edges", val::global("Int32Array").new_(typed_memory_view(found.edges.size(), found.edges.data())));
+    }
+    return result;
+}
 
 // DIJKSTRA
 
+// Bidirectional Dijkstra on the CSR snapshot (routing.cpp), or the
+// shortest-path index when built; igraph reports negative weights
 val dijkstra_source_to_target(igraph_integer_t src, igraph_integer_t tar)
 {
+    const CsrGraph &csr = graph_csr();
+    val indexed = val::undefined();
+    if (indexed_search(csr, "Dijkstra Single Path", src, tar, indexed))
+        return indexed;
+    if (csr.positiveWeights)
+    {
+        PathSearch search;
+        {
+            KernelTimer timer(csr, "bidirectional_dijkstra");
+            search = bidirectional_dijkstra(csr, src, tar);
+        }
+        return path_search_result("Dijkstra Single Path", src, tar, search, val::object());
+    }
+
     IGraphVectorInt vertices, edges;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
+    bool hasWeights = igraph_weights() != NULL;
     int edges_count = 0;
-    int total_weight = 0;
+    double total_weight = 0;
 
-    igraph_get_shortest_path_dijkstra(&globalGraph, vertices.vec(), edges.vec(), src, tar, igraph_weights(), IGRAPH_OUT);
+    igraph_get_shortest_path_dijkstra(&currentGraph->graph, vertices.vec(), edges.vec(), src, tar, igraph_weights(), IGRAPH_OUT);
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Dijkstra Single Path");
 
-    data.set("source", igraph_get_name(src));
-    data.set("target", igraph_get_name(tar));
+    data.set("source", vertex_name(src));
+    data.set("target", vertex_name(tar));
     data.set("weighted", hasWeights);
 
     val path = val::array();
     for (int i = 0; i < vertices.size(); ++i)
     {
         int node = vertices.at(i);
-        std::string nodeId = std::to_string(node);
-        colorMap.set(nodeId, 0.5);
+        highlight.vertex(node, 0.5);
 
         if (i > 0)
         {
-            std::string linkId = std::to_string(vertices.at(i - 1)) + '-' + nodeId;
-            colorMap.set(linkId, 1);
+            highlight.edge(vertices.at(i - 1), node, 1);
 
             val link = val::object();
-            link.set("from", igraph_get_name(vertices.at(i - 1)));
-            link.set("to", igraph_get_name(node));
+            link.set("from", vertex_name(vertices.at(i - 1)));
+            link.set("to", vertex_name(node));
 
             int weight_index = edges.at(edges_count++);
             if (hasWeights)
             {
-                link.set("weight", VECTOR(globalWeights)[weight_index]);
-                total_weight += VECTOR(globalWeights)[weight_index];
+                link.set("weight", VECTOR(*igraph_weights())[weight_index]);
+                total_weight += VECTOR(*igraph_weights())[weight_index];
             };
 
             path.set(i - 1, link);
         }
     }
-    colorMap.set(src, 1);
-    colorMap.set(tar, 1);
+    highlight.vertex(src, 1);
+    highlight.vertex(tar, 1);
 
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     data.set("path", path);
     if (hasWeights)
@@ -60,19 +267,47 @@ val dijkstra_source_to_target(igraph_integer_t src, igraph_integer_t tar)
     return result;
 }
 
-val dijkstra_source_to_all(igraph_integer_t src)
+// The tree form runs parallel delta-stepping on the CSR snapshot (sssp.cpp)
+// when all weights are positive; igraph reports negative weights
+val dijkstra_source_to_all(igraph_integer_t src, bool tree)
 {
+    const CsrGraph &csr = graph_csr();
+    if (tree && csr.positiveWeights)
+    {
+        SourceTree found;
+        {
+            KernelTimer timer(csr, "delta_stepping");
+            found = delta_stepping(csr, src, 0);
+        }
+        IGraphVectorInt parents, inbound;
+        for (int32_t v = 0; v < csr.vertices; ++v)
+        {
+            parents.push_back(found.pred[v]);
+            inbound.push_back(found.predEdge[v]);
+        }
+        val result = shortest_path_tree(src, parents, inbound, "Dijkstra Single Source");
+        result["data"].set("delta", found.delta);
+        result["data"].set("phases", static_cast<double>(found.phases));
+        return result;
+    }
+    if (tree)
+    {
+        IGraphVectorInt parents, inbound;
+        igraph_get_shortest_paths_dijkstra(&currentGraph->graph, NULL, NULL, src, igraph_vss_all(), igraph_weights(), IGRAPH_OUT, parents.vec(), inbound.vec());
+        return shortest_path_tree(src, parents, inbound, "Dijkstra Single Source");
+    }
+
     IGraphVectorIntList paths, edges;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
+    bool hasWeights = igraph_weights() != NULL;
 
-    igraph_get_shortest_paths_dijkstra(&globalGraph, paths.vec(), edges.vec(), src, igraph_vss_all(), igraph_weights(), IGRAPH_OUT, NULL, NULL);
+    igraph_get_shortest_paths_dijkstra(&currentGraph->graph, paths.vec(), edges.vec(), src, igraph_vss_all(), igraph_weights(), IGRAPH_OUT, NULL, NULL);
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Dijkstra Single Source");
 
-    data.set("source", igraph_get_name(src));
+    data.set("source", vertex_name(src));
     data.set("weighted", hasWeights);
 
     val pathsArray = val::array();
@@ -93,27 +328,25 @@ val dijkstra_source_to_all(igraph_integer_t src)
         if (dest == src || pLength == 0)
             continue;
 
-        pathDetails.set("target", igraph_get_name(dest));
+        pathDetails.set("target", vertex_name(dest));
         val pathArray = val::array();
         for (long j = 0; j < pLength; ++j)
         {
             int node = VECTOR(p)[j];
-            std::string nodeId = std::to_string(node);
 
             if (j > 0)
             {
-                std::string linkId = std::to_string(VECTOR(p)[j - 1]) + '-' + nodeId;
-                colorMap.set(linkId, 1);
+                highlight.edge(VECTOR(p)[j - 1], node, 1);
 
                 int weight_index = VECTOR(e)[edges_count++];
                 if (hasWeights)
                 {
-                    path_weight += VECTOR(globalWeights)[weight_index];
+                    path_weight += VECTOR(*igraph_weights())[weight_index];
                 }
             }
             if (node != src)
                 fm[node]++;
-            pathArray.set(j, igraph_get_name(node));
+            pathArray.set(j, vertex_name(node));
         }
 
         if (hasWeights)
@@ -121,9 +354,9 @@ val dijkstra_source_to_all(igraph_integer_t src)
         pathDetails.set("path", pathArray);
         pathsArray.set(paths_count++, pathDetails);
     }
-    frequenciesToColorMap(fm, colorMap);
-    colorMap.set(src, 1);
-    result.set("colorMap", colorMap);
+    frequenciesToColorMap(fm, highlight);
+    highlight.vertex(src, 1);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_ERROR);
 
     data.set("paths", pathsArray);
@@ -132,22 +365,48 @@ val dijkstra_source_to_all(igraph_integer_t src)
 }
 
 // A*
-// ??
+
+// ALT: A* guided by landmark distance bounds. The landmark tables are built
+// by the first query with a given landmark count and reused until the graph
+// or its weights change.
+val astar_source_to_target(igraph_integer_t src, igraph_integer_t tar, int landmarks)
+{
+    const CsrGraph &csr = graph_csr();
+    if (!csr.positiveWeights)
+    {
+        return dijkstra_source_to_target(src, tar);
+    }
+
+    bool built = false;
+    const Landmarks &tables = graph_landmarks(csr, landmarks, built);
+    PathSearch search;
+    {
+        KernelTimer timer(csr, "alt_search");
+        search = alt_search(csr, tables, src, tar);
+    }
+
+    val data = val::object();
+    data.set("landmarks", tables.count);
+    data.set("landmarksBuilt", built);
+    data.set("landmarkMs", tables.buildMs);
+    data.set("landmarkBytes", static_cast<double>(tables.bytes()));
+    return path_search_result("A* Single Path", src, tar, search, data);
+}
 
 // Yen
 val yen_source_to_target(igraph_integer_t src, igraph_integer_t tar, igraph_integer_t k)
 {
     IGraphVectorIntList paths, edges;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
+    bool hasWeights = igraph_weights() != NULL;
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Yen's k Shortest Paths");
 
-    igraph_get_k_shortest_paths(&globalGraph, igraph_weights(), paths.vec(), edges.vec(), k, src, tar, IGRAPH_OUT);
+    igraph_get_k_shortest_paths(&currentGraph->graph, igraph_weights(), paths.vec(), edges.vec(), k, src, tar, IGRAPH_OUT);
 
-    data.set("source", igraph_get_name(src));
-    data.set("target", igraph_get_name(tar));
+    data.set("source", vertex_name(src));
+    data.set("target", vertex_name(tar));
     data.set("k", k);
     data.set("weighted", hasWeights);
 
@@ -164,21 +423,19 @@ val yen_source_to_target(igraph_integer_t src, igraph_integer_t tar, igraph_inte
         for (long j = 0; j < igraph_vector_int_size(&p); ++j)
         {
             int node = VECTOR(p)[j];
-            std::string nodeId = std::to_string(node);
 
             if (j > 0)
             {
-                std::string linkId = std::to_string(VECTOR(p)[j - 1]) + '-' + nodeId;
-                colorMap.set(linkId, 1);
+                highlight.edge(VECTOR(p)[j - 1], node, 1);
 
                 int weight_index = VECTOR(e)[j - 1];
                 if (hasWeights)
                 {
-                    path_weight += VECTOR(globalWeights)[weight_index];
+                    path_weight += VECTOR(*igraph_weights())[weight_index];
                 }
             }
-            colorMap.set(nodeId, 0.5);
-            pathArray.set(j, igraph_get_name(node));
+            highlight.vertex(node, 0.5);
+            pathArray.set(j, vertex_name(node));
         }
         if (hasWeights)
             pathDetails.set("weight", path_weight);
@@ -186,9 +443,9 @@ val yen_source_to_target(igraph_integer_t src, igraph_integer_t tar, igraph_inte
         pathsArray.set(i, pathDetails);
     }
 
-    colorMap.set(src, 1);
-    colorMap.set(tar, 1);
-    result.set("colorMap", colorMap);
+    highlight.vertex(src, 1);
+    highlight.vertex(tar, 1);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
 
     data.set("paths", pathsArray);
@@ -198,54 +455,57 @@ val yen_source_to_target(igraph_integer_t src, igraph_integer_t tar, igraph_inte
 
 // BELLMAN-FORD
 
+// With positive weights the shortest-path index answers the query when built
 val bf_source_to_target(igraph_integer_t src, igraph_integer_t tar)
 {
+    val indexed = val::undefined();
+    if (indexed_search(graph_csr(), "Bellman-Ford Single Path", src, tar, indexed))
+        return indexed;
+
     IGraphVectorInt vertices, edges;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
+    bool hasWeights = igraph_weights() != NULL;
     int edges_count = 0;
-    int total_weight = 0;
+    double total_weight = 0;
 
-    igraph_get_shortest_path_bellman_ford(&globalGraph, vertices.vec(), edges.vec(), src, tar, igraph_weights(), IGRAPH_OUT);
+    igraph_get_shortest_path_bellman_ford(&currentGraph->graph, vertices.vec(), edges.vec(), src, tar, igraph_weights(), IGRAPH_OUT);
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Bellman-Ford Single Path");
 
-    data.set("source", igraph_get_name(src));
-    data.set("target", igraph_get_name(tar));
+    data.set("source", vertex_name(src));
+    data.set("target", vertex_name(tar));
     data.set("weighted", hasWeights);
 
     val path = val::array();
     for (int i = 0; i < vertices.size(); ++i)
     {
         int node = vertices.at(i);
-        std::string nodeId = std::to_string(node);
-        colorMap.set(nodeId, 0.5);
+        highlight.vertex(node, 0.5);
 
         if (i > 0)
         {
-            std::string linkId = std::to_string(vertices.at(i - 1)) + '-' + nodeId;
-            colorMap.set(linkId, 1);
+            highlight.edge(vertices.at(i - 1), node, 1);
 
             val link = val::object();
-            link.set("from", igraph_get_name(vertices.at(i - 1)));
-            link.set("to", igraph_get_name(node));
+            link.set("from", vertex_name(vertices.at(i - 1)));
+            link.set("to", vertex_name(node));
 
             int weight_index = edges.at(edges_count++);
             if (hasWeights)
             {
-                link.set("weight", VECTOR(globalWeights)[weight_index]);
-                total_weight += VECTOR(globalWeights)[weight_index];
+                link.set("weight", VECTOR(*igraph_weights())[weight_index]);
+                total_weight += VECTOR(*igraph_weights())[weight_index];
             };
 
             path.set(i - 1, link);
         }
     }
-    colorMap.set(src, 1);
-    colorMap.set(tar, 1);
+    highlight.vertex(src, 1);
+    highlight.vertex(tar, 1);
 
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     data.set("path", path);
     if (hasWeights)
@@ -254,19 +514,26 @@ val bf_source_to_target(igraph_integer_t src, igraph_integer_t tar)
     return result;
 }
 
-val bf_source_to_all(igraph_integer_t src)
+val bf_source_to_all(igraph_integer_t src, bool tree)
 {
+    if (tree)
+    {
+        IGraphVectorInt parents, inbound;
+        igraph_get_shortest_paths_bellman_ford(&currentGraph->graph, NULL, NULL, src, igraph_vss_all(), igraph_weights(), IGRAPH_OUT, parents.vec(), inbound.vec());
+        return shortest_path_tree(src, parents, inbound, "Bellman-Ford Single Source");
+    }
+
     IGraphVectorIntList paths, edges;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
+    bool hasWeights = igraph_weights() != NULL;
 
-    igraph_get_shortest_paths_bellman_ford(&globalGraph, paths.vec(), edges.vec(), src, igraph_vss_all(), igraph_weights(), IGRAPH_OUT, NULL, NULL);
+    igraph_get_shortest_paths_bellman_ford(&currentGraph->graph, paths.vec(), edges.vec(), src, igraph_vss_all(), igraph_weights(), IGRAPH_OUT, NULL, NULL);
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Bellman-Ford Single Source");
 
-    data.set("source", igraph_get_name(src));
+    data.set("source", vertex_name(src));
     data.set("weighted", hasWeights);
 
     val pathsArray = val::array();
@@ -286,36 +553,34 @@ val bf_source_to_all(igraph_integer_t src)
         if (dest == src || pLength == 0)
             continue;
 
-        pathDetails.set("target", igraph_get_name(dest));
+        pathDetails.set("target", vertex_name(dest));
         val pathArray = val::array();
         for (long j = 0; j < pLength; ++j)
         {
             int node = VECTOR(p)[j];
-            std::string nodeId = std::to_string(node);
 
             if (j > 0)
             {
-                std::string linkId = std::to_string(VECTOR(p)[j - 1]) + '-' + nodeId;
-                colorMap.set(linkId, 1);
+                highlight.edge(VECTOR(p)[j - 1], node, 1);
 
                 int weight_index = VECTOR(e)[edges_count++];
                 if (hasWeights)
                 {
-                    path_weight += VECTOR(globalWeights)[weight_index];
+                    path_weight += VECTOR(*igraph_weights())[weight_index];
                 }
             }
             if (node != src)
                 fm[node]++;
-            pathArray.set(j, igraph_get_name(node));
+            pathArray.set(j, vertex_name(node));
         }
         if (hasWeights)
             pathDetails.set("weight", path_weight);
         pathDetails.set("path", pathArray);
         pathsArray.set(paths_count++, pathDetails);
     }
-    frequenciesToColorMap(fm, colorMap);
-    colorMap.set(src, 1);
-    result.set("colorMap", colorMap);
+    frequenciesToColorMap(fm, highlight);
+    highlight.vertex(src, 1);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_ERROR);
 
     data.set("paths", pathsArray);
@@ -324,63 +589,51 @@ val bf_source_to_all(igraph_integer_t src)
 }
 
 // BFS
+// Direction-optimizing BFS on the CSR snapshot (traversal.cpp). Vertices
+// are listed by igraph ID within a layer, and each layer reports whether it
+// was found top-down or bottom-up.
 val bfs(igraph_integer_t src)
 {
-    IGraphVectorInt order, layers;
-    int N, nodes_remaining, orderLength;
-
-    igraph_bfs_simple(&globalGraph, src, IGRAPH_OUT, order.vec(), layers.vec(), NULL);
+    const CsrGraph &csr = graph_csr();
+    BfsLayers levels;
+    {
+        KernelTimer timer(csr, "direction_optimizing_bfs");
+        levels = direction_optimizing_bfs(csr, src);
+    }
 
     val result = val::object();
     val colorMap = val::object();
     val data = val::object();
     data.set("algorithm", "Breadth-First Search");
 
-    data.set("source", igraph_get_name(src));
-
-    N = igraph_vcount(&globalGraph);
-    nodes_remaining = N;
-    bool new_iteration = true;
-    orderLength = order.size();
-    igraph_integer_t current_layer = 0;
-    int nodes_found = 0;
+    data.set("source", vertex_name(src));
 
+    const int N = csr.vertices;
     val layersArray = val::array();
     std::unordered_map<int, int> fm;
-
-    val layerArray = val::array();
-    int layer_index;
-    for (igraph_integer_t i = 0; i < orderLength; ++i)
+    for (size_t k = 0; k + 1 < levels.layerStarts.size(); ++k)
     {
-        if (new_iteration)
+        // Vertices not found before this layer
+        const int nodes_remaining = N - levels.layerStarts[k];
+        val layerArray = val::array();
+        for (int32_t i = levels.layerStarts[k]; i < levels.layerStarts[k + 1]; ++i)
         {
-            layerArray = val::array();
-            layer_index = 0;
-            new_iteration = false;
+            const int32_t nodeId = levels.order[i];
+            layerArray.set(i - levels.layerStarts[k], vertex_name(nodeId));
+            fm[nodeId] = nodes_remaining;
         }
 
-        int nodeId = order.at(i);
-        layerArray.set(layer_index++, igraph_get_name(nodeId));
-        fm[nodeId] = nodes_remaining;
-        nodes_found++;
-
-        int layer = layers.at(current_layer + 1);
-        if (i + 1 == layer || i + 1 == orderLength)
-        {
-            val l = val::object();
-            l.set("layer", layerArray);
-            l.set("index", current_layer);
-            layersArray.set(current_layer++, l);
-
-            nodes_remaining = N - i - 1;
-            new_iteration = true;
-        }
+        val l = val::object();
+        l.set("layer", layerArray);
+        l.set("index", static_cast<int>(k));
+        l.set("direction", levels.bottomUp[k] ? "bottom-up" : "top-down");
+        layersArray.set(k, l);
     }
     frequenciesToColorMap(fm, colorMap);
     result.set("colorMap", colorMap);
     result.set("mode", MODE_COLOR_SHADE_ERROR);
 
-    data.set("nodesFound", nodes_found);
+    data.set("nodesFound", static_cast<int>(levels.order.size()));
     data.set("layers", layersArray);
     result.set("data", data);
     return result;
@@ -390,14 +643,14 @@ val dfs(igraph_integer_t src)
 {
     IGraphVectorInt order, dist, order_out;
 
-    igraph_dfs(&globalGraph, src, IGRAPH_OUT, false, order.vec(), order_out.vec(), NULL, dist.vec(), NULL, NULL, NULL);
+    igraph_dfs(&currentGraph->graph, src, IGRAPH_OUT, false, order.vec(), order_out.vec(), NULL, dist.vec(), NULL, NULL, NULL);
 
     val result = val::object();
     val colorMap = val::object();
     val data = val::object();
     data.set("algorithm", "Depth-First Search");
 
-    data.set("source", igraph_get_name(src));
+    data.set("source", vertex_name(src));
 
     val subtrees = val::array();
     std::unordered_set<int> visited;
@@ -421,7 +674,7 @@ val dfs(igraph_integer_t src)
 
                 visited.insert(orderNode);
                 fm[orderNode] = subtree_index;
-                tree.set(tree_index++, igraph_get_name(orderNode));
+                tree.set(tree_index++, vertex_name(orderNode));
                 if (orderNode == node)
                     break;
             }
@@ -453,16 +706,16 @@ val dfs(igraph_integer_t src)
 val randomWalk(igraph_integer_t start, int steps)
 {
     IGraphVectorInt vertices, edges;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
+    bool hasWeights = igraph_weights() != NULL;
 
-    igraph_random_walk(&globalGraph, NULL, vertices.vec(), edges.vec(), start, IGRAPH_OUT, steps, IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    igraph_random_walk(&currentGraph->graph, NULL, vertices.vec(), edges.vec(), start, IGRAPH_OUT, steps, IGRAPH_RANDOM_WALK_STUCK_RETURN);
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Random Walk");
 
-    data.set("source", igraph_get_name(start));
+    data.set("source", vertex_name(start));
     data.set("steps", steps);
     data.set("weighted", hasWeights);
 
@@ -480,31 +733,28 @@ val randomWalk(igraph_integer_t start, int steps)
             highestFrequencyNode = node;
         }
 
-        std::string nodeId = std::to_string(node);
-
         if (i > 0)
         {
-            std::string linkId = std::to_string(vertices.at(i - 1)) + '-' + nodeId;
-            colorMap.set(linkId, 1);
+            highlight.edge(vertices.at(i - 1), node, 1);
 
             val link = val::object();
             link.set("step", i);
-            link.set("from", igraph_get_name(vertices.at(i - 1)));
-            link.set("to", igraph_get_name(node));
+            link.set("from", vertex_name(vertices.at(i - 1)));
+            link.set("to", vertex_name(node));
             if (hasWeights)
             {
                 int weight_index = edges.at(i - 1);
-                link.set("weight", VECTOR(globalWeights)[weight_index]);
+                link.set("weight", VECTOR(*igraph_weights())[weight_index]);
             }
             path.set(i - 1, link);
         }
     }
 
-    data.set("maxFrequencyNode", igraph_get_name(highestFrequencyNode));
+    data.set("maxFrequencyNode", vertex_name(highestFrequencyNode));
     data.set("maxFrequency", highestFrequency);
 
-    frequenciesToColorMap(fm, colorMap);
-    result.set("colorMap", colorMap);
+    frequenciesToColorMap(fm, highlight);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_DEFAULT);
     data.set("path", path);
     result.set("data", data);
@@ -514,39 +764,37 @@ val randomWalk(igraph_integer_t start, int steps)
 val min_spanning_tree(void)
 {
     IGraphVectorInt edges;
-    bool hasWeights = VECTOR(globalWeights) != NULL;
+    bool hasWeights = igraph_weights() != NULL;
 
-    igraph_minimum_spanning_tree(&globalGraph, edges.vec(), igraph_weights());
+    igraph_minimum_spanning_tree(&currentGraph->graph, edges.vec(), igraph_weights());
 
     val result = val::object();
-    val colorMap = val::object();
+    HighlightBuffer highlight;
     val data = val::object();
     data.set("algorithm", "Minimum Spanning Tree");
 
     data.set("weighted", hasWeights);
-    data.set("maxEdges", igraph_ecount(&globalGraph));
+    data.set("maxEdges", igraph_ecount(&currentGraph->graph));
 
     int total_weight = 0;
     val edgesArray = val::array();
+    const CsrGraph &csr = graph_csr();
     for (int i = 0; i < edges.size(); ++i)
     {
         val link = val::object();
         int edge = edges.at(i);
-        igraph_integer_t from, to;
-        igraph_edge(&globalGraph, edge, &from, &to);
-
-        std::string linkId = std::to_string(from) + '-' + std::to_string(to);
-        colorMap.set(from, 0.5);
-        colorMap.set(to, 0.5);
-        colorMap.set(linkId, 1);
+        const int32_t from = csr.from[edge], to = csr.to[edge];
+        highlight.vertex(from, 0.5);
+        highlight.vertex(to, 0.5);
+        highlight.edge(from, to, 1);
 
         link.set("num", i + 1);
-        link.set("from", igraph_get_name(from));
-        link.set("to", igraph_get_name(to));
+        link.set("from", vertex_name(from));
+        link.set("to", vertex_name(to));
         if (hasWeights)
         {
-            link.set("weight", VECTOR(globalWeights)[edge]);
-            total_weight += VECTOR(globalWeights)[edge];
+            link.set("weight", VECTOR(*igraph_weights())[edge]);
+            total_weight += VECTOR(*igraph_weights())[edge];
         }
 
         edgesArray.set(i, link);
@@ -554,7 +802,7 @@ val min_spanning_tree(void)
     if (hasWeights)
         data.set("totalWeight", total_weight);
 
-    result.set("colorMap", colorMap);
+    result.set("highlight", highlight.to_val());
     result.set("mode", MODE_COLOR_SHADE_ERROR);
     data.set("edges", edgesArray);
     result.set("data", data);
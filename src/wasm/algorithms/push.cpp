@@ -0,0 +1,171 @@
+#include "../graph.h"
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+
+// Personalized PageRank by forward push (Andersen, Chung and Lang). Every
+// vertex holds an estimate and a residual, the probability mass that still
+// has to be spread; the seeds start with all of it. Pushing a vertex keeps
+// the teleport share (1 - damping) of its residual as estimate and passes
+// the rest along its out-edges, split by weight. A vertex is pushed while its
+// residual exceeds epsilon times its out-degree, so the work depends on
+// epsilon and the neighbourhood reached, not on the size of the graph.
+// Vertices without out-edges, or whose out-edges all weigh 0, return their
+// mass to the seeds, matching a random surfer who restarts there.
+
+// Pushes between cancellation checks
+#define PUSH_CHECK_INTERVAL 4096
+
+// Per-vertex state reused across queries so a query only touches the
+// entries it sets; they are zeroed again through the touched list
+struct PushScratch
+{
+    std::vector<double> estimate, residual;
+    std::vector<char> queued, seen;
+    std::vector<int32_t> touched;
+
+    void reserve(size_t n)
+    {
+        if (estimate.size() < n)
+        {
+            estimate.resize(n, 0);
+            residual.resize(n, 0);
+            queued.resize(n, 0);
+            seen.resize(n, 0);
+        }
+    }
+
+    void touch(int32_t v)
+    {
+        if (!seen[v])
+        {
+            seen[v] = 1;
+            touched.push_back(v);
+        }
+    }
+
+    void clear(void)
+    {
+        for (int32_t v : touched)
+        {
+            estimate[v] = residual[v] = 0;
+            queued[v] = seen[v] = 0;
+        }
+        touched.clear();
+    }
+};
+
+static PushScratch scratch;
+
+PushEstimate personalized_push(const CsrGraph &csr, const std::vector<int32_t> &seeds, double damping, double epsilon, size_t k)
+{
+    if (seeds.empty())
+    {
+        throw std::runtime_error("Personalized PageRank needs at least one seed vertex");
+    }
+    if (!(damping >= 0 && damping < 1) || !(epsilon > 0))
+    {
+        throw std::runtime_error("Personalized PageRank needs a damping factor in [0, 1) and a positive epsilon");
+    }
+    if (!csr.nonNegativeWeights)
+    {
+        throw std::runtime_error("Personalized PageRank needs non-negative edge weights");
+    }
+
+    std::vector<int32_t> starts(seeds.size());
+    for (size_t i = 0; i < seeds.size(); ++i)
+    {
+        if (seeds[i] < 0 || seeds[i] >= csr.vertices)
+        {
+            throw std::runtime_error("Seed vertex " + std::to_string(seeds[i]) + " is not in the graph");
+        }
+        starts[i] = csr.to_internal(seeds[i]);
+    }
+
+    const EdgeRows &rows = csr.out();
+    const double share = 1.0 / starts.size();
+    auto threshold = [&](int32_t v)
+    {
+        return epsilon * std::max(rows.offsets[v + 1] - rows.offsets[v], 1);
+    };
+
+    scratch.reserve(csr.vertices);
+    PushEstimate result;
+    std::deque<int32_t> queue;
+    auto add_residual = [&](int32_t v, double mass)
+    {
+        scratch.touch(v);
+        scratch.residual[v] += mass;
+        if (!scratch.queued[v] && scratch.residual[v] > threshold(v))
+        {
+            scratch.queued[v] = 1;
+            queue.push_back(v);
+        }
+    };
+
+    try
+    {
+        for (int32_t s : starts)
+            add_residual(s, share);
+
+        while (!queue.empty())
+        {
+            const int32_t u = queue.front();
+            queue.pop_front();
+            scratch.queued[u] = 0;
+            const double mass = scratch.residual[u];
+            scratch.residual[u] = 0;
+            scratch.estimate[u] += (1 - damping) * mass;
+
+            const double passed = damping * mass;
+            const int32_t begin = rows.offsets[u], end = rows.offsets[u + 1];
+            double strength = end - begin;
+            if (csr.weighted)
+            {
+                strength = 0;
+                for (int32_t i = begin; i < end; ++i)
+                    strength += rows.weights[i];
+            }
+            if (passed > 0 && strength > 0)
+            {
+                for (int32_t i = begin; i < end; ++i)
+                    add_residual(rows.targets[i], passed * (csr.weighted ? rows.weights[i] : 1) / strength);
+            }
+            else if (passed > 0)
+            {
+                for (int32_t s : starts)
+                    add_residual(s, passed * share);
+            }
+
+            if (++result.pushes % PUSH_CHECK_INTERVAL == 0)
+                throw_if_cancelled();
+        }
+    }
+    catch (...)
+    {
+        scratch.clear();
+        throw;
+    }
+
+    std::vector<int32_t> found;
+    for (int32_t v : scratch.touched)
+    {
+        result.residual += scratch.residual[v];
+        if (scratch.estimate[v] > 0)
+            found.push_back(v);
+    }
+    result.touched = scratch.touched.size();
+
+    const size_t count = k > 0 ? std::min(k, found.size()) : found.size();
+    std::partial_sort(found.begin(), found.begin() + count, found.end(), [&](int32_t a, int32_t b)
+                      { return scratch.estimate[a] > scratch.estimate[b] || (scratch.estimate[a] == scratch.estimate[b] && a < b); });
+    result.vertices.resize(count);
+    result.scores.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.vertices[i] = csr.original.empty() ? found[i] : csr.original[found[i]];
+        result.scores[i] = scratch.estimate[found[i]];
+    }
+    scratch.clear();
+    return result;
+}
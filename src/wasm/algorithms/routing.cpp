@@ -0,0 +1,872 @@
+#include "../graph.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+// Point-to-point shortest paths over the CSR snapshot: bidirectional Dijkstra,
+// ALT (A* with landmark lower bounds and the triangle inequality) and
+// contraction hierarchies, which callers only run on positive weights and
+// otherwise hand to igraph. Batched pairs run plain Dijkstra and also accept
+// zero-weight edges; only negative weights are rejected.
+//
+// Per-vertex search state is kept between queries and reset through the list
+// of vertices a query touched, so a query that settles a few hundred
+// vertices does not pay for clearing arrays sized to the graph.
+
+typedef std::pair<double, int32_t> QueueEntry;
+typedef std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> MinQueue;
+
+static inline double slot_weight(const EdgeRows &rows, int32_t i)
+{
+    return rows.weights.empty() ? 1.0 : rows.weights[i];
+}
+
+// One direction of a search: tentative distances with the vertex and edge
+// slot each was reached through
+struct SearchSide
+{
+    std::vector<double> dist;
+    std::vector<int32_t> pred, predEdge;
+    std::vector<char> done;
+    std::vector<int32_t> touched;
+    MinQueue queue;
+
+    void reset(size_t n)
+    {
+        for (int32_t v : touched)
+        {
+            dist[v] = INFINITY;
+            done[v] = 0;
+        }
+        touched.clear();
+        queue = MinQueue();
+        if (dist.size() != n)
+        {
+            dist.assign(n, INFINITY);
+            pred.assign(n, -1);
+            predEdge.assign(n, -1);
+            done.assign(n, 0);
+        }
+    }
+
+    bool relax(int32_t v, double d, int32_t from, int32_t edge)
+    {
+        if (!(d < dist[v]))
+            return false;
+        if (dist[v] == INFINITY)
+            touched.push_back(v);
+        dist[v] = d;
+        pred[v] = from;
+        predEdge[v] = edge;
+        return true;
+    }
+};
+
+static SearchSide forwardSide, backwardSide;
+
+// Queue pops between cancellation checks
+#define SEARCH_CHECK_INTERVAL 4096
+
+static void check_vertex(const CsrGraph &csr, int32_t v)
+{
+    if (v < 0 || v >= csr.vertices)
+    {
+        throw std::runtime_error("Vertex " + std::to_string(v) + " is not in the graph");
+    }
+}
+
+static inline int32_t original_id(const CsrGraph &csr, int32_t v)
+{
+    return csr.original.empty() ? v : csr.original[v];
+}
+
+// Appends the forward tree path source..v in igraph IDs
+static void forward_path(const CsrGraph &csr, const SearchSide &side, int32_t v, PathSearch &path)
+{
+    std::vector<int32_t> vertices, edges;
+    for (int32_t u = v; u >= 0; u = side.pred[u])
+    {
+        vertices.push_back(original_id(csr, u));
+        if (side.pred[u] >= 0)
+            edges.push_back(side.predEdge[u]);
+    }
+    path.vertices.insert(path.vertices.end(), vertices.rbegin(), vertices.rend());
+    path.edges.insert(path.edges.end(), edges.rbegin(), edges.rend());
+}
+
+void dijkstra_distances(const EdgeRows &rows, int32_t source, double *dist)
+{
+    const size_t n = rows.offsets.size() - 1;
+    std::fill(dist, dist + n, INFINITY);
+    MinQueue queue;
+    dist[source] = 0;
+    queue.push(QueueEntry(0, source));
+    while (!queue.empty())
+    {
+        const QueueEntry top = queue.top();
+        queue.pop();
+        const int32_t u = top.second;
+        if (top.first > dist[u])
+            continue;
+        for (int32_t i = rows.offsets[u]; i < rows.offsets[u + 1]; ++i)
+        {
+            const int32_t v = rows.targets[i];
+            const double d = top.first + slot_weight(rows, i);
+            if (d < dist[v])
+            {
+                dist[v] = d;
+                queue.push(QueueEntry(d, v));
+            }
+        }
+    }
+}
+
+// Alternates between a forward search from the source over out-rows and a
+// backward one from the target over in-rows, always advancing the side with
+// the smaller queue head, and stops once the two heads together reach the
+// best source-target distance seen where the searches meet
+PathSearch bidirectional_dijkstra(const CsrGraph &csr, int32_t source, int32_t target)
+{
+    check_vertex(csr, source);
+    check_vertex(csr, target);
+    const int32_t s = csr.to_internal(source), t = csr.to_internal(target);
+
+    SearchSide &fw = forwardSide, &bw = backwardSide;
+    fw.reset(csr.vertices);
+    bw.reset(csr.vertices);
+    fw.relax(s, 0, -1, -1);
+    fw.queue.push(QueueEntry(0, s));
+    bw.relax(t, 0, -1, -1);
+    bw.queue.push(QueueEntry(0, t));
+
+    PathSearch path;
+    int32_t meet = s == t ? s : -1;
+    if (s == t)
+        path.distance = 0;
+
+    while (!fw.queue.empty() && !bw.queue.empty())
+    {
+        if (fw.queue.top().first + bw.queue.top().first >= path.distance)
+            break;
+
+        const bool forward = fw.queue.top().first <= bw.queue.top().first;
+        SearchSide &side = forward ? fw : bw;
+        const SearchSide &other = forward ? bw : fw;
+        const EdgeRows &rows = forward ? csr.out() : csr.in();
+
+        const QueueEntry top = side.queue.top();
+        side.queue.pop();
+        const int32_t u = top.second;
+        if (side.done[u] || top.first > side.dist[u])
+            continue;
+        side.done[u] = 1;
+        if (++path.settled % SEARCH_CHECK_INTERVAL == 0)
+            throw_if_cancelled();
+
+        for (int32_t i = rows.offsets[u]; i < rows.offsets[u + 1]; ++i)
+        {
+            const int32_t v = rows.targets[i];
+            if (side.relax(v, top.first + slot_weight(rows, i), u, rows.edges[i]))
+                side.queue.push(QueueEntry(side.dist[v], v));
+            if (other.dist[v] < INFINITY && side.dist[v] + other.dist[v] < path.distance)
+            {
+                path.distance = side.dist[v] + other.dist[v];
+                meet = v;
+            }
+        }
+    }
+
+    if (meet < 0)
+        return path;
+    forward_path(csr, fw, meet, path);
+    for (int32_t u = meet; bw.pred[u] >= 0; u = bw.pred[u])
+    {
+        path.vertices.push_back(original_id(csr, bw.pred[u]));
+        path.edges.push_back(bw.predEdge[u]);
+    }
+    return path;
+}
+
+// Farthest-point selection: the first landmark is the vertex farthest from
+// the highest-degree vertex, each next one the vertex farthest (in either
+// direction) from all landmarks chosen so far. Vertices no landmark reaches
+// are left out, so isolated vertices do not use up landmarks; searches there
+// fall back to plain Dijkstra order. Forward and backward tables of a
+// landmark are filled in parallel.
+const Landmarks &graph_landmarks(const CsrGraph &csr, int count, bool &built)
+{
+    const size_t n = csr.vertices;
+    if (n == 0)
+    {
+        throw std::runtime_error("The graph has no vertices");
+    }
+    count = std::max(1, std::min<int>(count, n));
+    built = false;
+    if (csr.landmarks && csr.landmarks->count == count)
+        return *csr.landmarks;
+
+    const auto started = std::chrono::steady_clock::now();
+    std::unique_ptr<Landmarks> landmarks(new Landmarks());
+    landmarks->count = count;
+    landmarks->from.resize(n * count);
+    if (csr.directed)
+        landmarks->to.resize(n * count);
+
+    // Index of the largest finite value, 0 if there is none
+    auto farthest = [&](const std::vector<double> &values)
+    {
+        int32_t best = 0;
+        double max = -1;
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (values[v] < INFINITY && values[v] > max)
+            {
+                max = values[v];
+                best = v;
+            }
+        }
+        return best;
+    };
+
+    const EdgeRows &out = csr.out();
+    int32_t hub = 0;
+    for (size_t v = 1; v < n; ++v)
+    {
+        if (out.offsets[v + 1] - out.offsets[v] > out.offsets[hub + 1] - out.offsets[hub])
+            hub = v;
+    }
+    std::vector<double> dist[2] = {std::vector<double>(n), std::vector<double>(n)};
+    dijkstra_distances(out, hub, dist[0].data());
+    int32_t pick = farthest(dist[0]);
+
+    // Distance to the nearest landmark in either direction
+    std::vector<double> nearest(n, INFINITY);
+    ProgressCounter progress(count);
+    for (int l = 0; l < count; ++l)
+    {
+        if (l > 0)
+            pick = farthest(nearest);
+        landmarks->vertices.push_back(pick);
+
+        TaskPool::instance().parallel_for(0, csr.directed ? 2 : 1, 1, [&](size_t lo, size_t hi, unsigned)
+                                          {
+            for (size_t side = lo; side < hi; ++side)
+                dijkstra_distances(side ? csr.in() : csr.out(), pick, dist[side].data()); });
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            landmarks->from[v * count + l] = dist[0][v];
+            double d = dist[0][v];
+            if (csr.directed)
+            {
+                landmarks->to[v * count + l] = dist[1][v];
+                d = std::min(d, dist[1][v]);
+            }
+            nearest[v] = std::min(nearest[v], d);
+        }
+        progress.add(1);
+    }
+
+    landmarks->buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    csr.landmarks = std::move(landmarks);
+    built = true;
+    return *csr.landmarks;
+}
+
+// Lower bound on d(v, t) from the landmark tables:
+//   d(v, t) >= d(L, t) - d(L, v)  and  d(v, t) >= d(v, L) - d(t, L).
+// Reachability gives more: if L reaches v but not t, or t reaches L but v
+// does not, v cannot reach t and the bound is INFINITY.
+static double landmark_bound(const Landmarks &landmarks, int32_t v, int32_t t)
+{
+    const int k = landmarks.count;
+    const std::vector<double> &to = landmarks.to.empty() ? landmarks.from : landmarks.to;
+    const double *fromV = &landmarks.from[size_t(v) * k], *fromT = &landmarks.from[size_t(t) * k];
+    const double *toV = &to[size_t(v) * k], *toT = &to[size_t(t) * k];
+    double bound = 0;
+    for (int l = 0; l < k; ++l)
+    {
+        if (fromT[l] < INFINITY)
+        {
+            if (fromV[l] < INFINITY)
+                bound = std::max(bound, fromT[l] - fromV[l]);
+        }
+        else if (fromV[l] < INFINITY)
+        {
+            return INFINITY;
+        }
+
+        if (toV[l] < INFINITY)
+        {
+            if (toT[l] < INFINITY)
+                bound = std::max(bound, toV[l] - toT[l]);
+        }
+        else if (toT[l] < INFINITY)
+        {
+            return INFINITY;
+        }
+    }
+    return bound;
+}
+
+// A* from the source ordered by distance plus landmark bound. The bound is
+// consistent, so a vertex is final when it leaves the queue and the search
+// ends when the target does; vertices that cannot reach the target are never
+// queued.
+PathSearch alt_search(const CsrGraph &csr, const Landmarks &landmarks, int32_t source, int32_t target)
+{
+    check_vertex(csr, source);
+    check_vertex(csr, target);
+    const int32_t s = csr.to_internal(source), t = csr.to_internal(target);
+    const EdgeRows &rows = csr.out();
+
+    PathSearch path;
+    SearchSide &side = forwardSide;
+    side.reset(csr.vertices);
+    const double startBound = landmark_bound(landmarks, s, t);
+    if (startBound == INFINITY)
+        return path;
+    side.relax(s, 0, -1, -1);
+    side.queue.push(QueueEntry(startBound, s));
+
+    while (!side.queue.empty())
+    {
+        const int32_t u = side.queue.top().second;
+        side.queue.pop();
+        if (side.done[u])
+            continue;
+        side.done[u] = 1;
+        if (++path.settled % SEARCH_CHECK_INTERVAL == 0)
+            throw_if_cancelled();
+        if (u == t)
+            break;
+
+        for (int32_t i = rows.offsets[u]; i < rows.offsets[u + 1]; ++i)
+        {
+            const int32_t v = rows.targets[i];
+            const double d = side.dist[u] + slot_weight(rows, i);
+            if (side.done[v] || !(d < side.dist[v]))
+                continue;
+            const double bound = landmark_bound(landmarks, v, t);
+            if (bound == INFINITY)
+                continue;
+            side.relax(v, d, u, rows.edges[i]);
+            side.queue.push(QueueEntry(d + bound, v));
+        }
+    }
+
+    if (!side.done[t])
+        return path;
+    path.distance = side.dist[t];
+    forward_path(csr, side, t, path);
+    return path;
+}
+
+// CONTRACTION HIERARCHY
+// Vertices are contracted one at a time, least important first. Contracting
+// v removes it from the remaining graph and, for every pair of remaining
+// neighbours u -> v -> w, adds a shortcut u -> w unless a witness search
+// from u that avoids v finds a path at most as short. The contraction order
+// is the vertex rank. Any shortest path then has an equally short form that
+// only climbs in rank from the source and only descends towards the target,
+// so a query is a bidirectional Dijkstra that follows upward arcs on both
+// sides and settles a few hundred vertices on road-like graphs. Shortcuts
+// remember the two arcs they replace and are unpacked into edges of the
+// graph after the search.
+//
+// The order is chosen lazily: the priority of a vertex is its edge
+// difference (shortcuts contracting it would add minus arcs it removes) plus
+// the number of its neighbours already contracted, which spreads
+// contraction evenly over the graph. A popped vertex is re-evaluated and put
+// back if its priority got worse than the next one's.
+
+// Vertices a witness search may settle before giving up; a missed witness
+// only costs a superfluous shortcut. Priority estimates use the lower limit.
+#define WITNESS_SETTLE_LIMIT 500
+#define ESTIMATE_SETTLE_LIMIT 25
+
+namespace
+{
+    struct Contraction
+    {
+        std::vector<ChArc> &arcs;
+        std::vector<std::vector<int32_t>> out, in; // arc indices, pruned lazily
+        std::vector<char> contracted, target;
+        std::vector<char> replaced; // per arc: superseded by a shorter shortcut
+        std::vector<int32_t> contractedNeighbours;
+        SearchSide witness;
+
+        Contraction(size_t n, std::vector<ChArc> &arcs)
+            : arcs(arcs), out(n), in(n), contracted(n, 0), target(n, 0), contractedNeighbours(n, 0) {}
+
+        void prune(std::vector<int32_t> &list, bool outgoing)
+        {
+            list.erase(std::remove_if(list.begin(), list.end(), [&](int32_t a)
+                                      { return contracted[outgoing ? arcs[a].to : arcs[a].from]; }),
+                       list.end());
+        }
+
+        // Dijkstra from u over remaining vertices other than v, up to limit
+        // or until v's out-neighbours are settled, settling at most
+        // settleLimit vertices
+        void witness_search(int32_t u, int32_t v, double limit, int settleLimit)
+        {
+            int targets = 0;
+            for (int32_t b : out[v])
+            {
+                if (!target[arcs[b].to])
+                {
+                    target[arcs[b].to] = 1;
+                    ++targets;
+                }
+            }
+
+            witness.reset(contracted.size());
+            witness.relax(u, 0, -1, -1);
+            witness.queue.push(QueueEntry(0, u));
+            int settled = 0;
+            while (!witness.queue.empty())
+            {
+                const QueueEntry top = witness.queue.top();
+                witness.queue.pop();
+                const int32_t x = top.second;
+                if (witness.done[x] || top.first > witness.dist[x])
+                    continue;
+                if (top.first > limit || ++settled > settleLimit)
+                    break;
+                witness.done[x] = 1;
+                if (target[x] && --targets == 0)
+                    break;
+                for (int32_t a : out[x])
+                {
+                    const int32_t y = arcs[a].to;
+                    if (y != v && !contracted[y] && witness.relax(y, top.first + arcs[a].weight, x, a))
+                        witness.queue.push(QueueEntry(witness.dist[y], y));
+                }
+            }
+            for (int32_t b : out[v])
+                target[arcs[b].to] = 0;
+        }
+
+        // A shortcut replaces a longer arc between the same vertices in the
+        // adjacency lists (the arc keeps its index but is marked replaced) and
+        // is dropped if there is a shorter one
+        void add_shortcut(int32_t u, int32_t w, double weight, int32_t first, int32_t second)
+        {
+            auto parallel = std::find_if(out[u].begin(), out[u].end(), [&](int32_t a)
+                                         { return arcs[a].to == w; });
+            if (parallel != out[u].end() && arcs[*parallel].weight <= weight)
+                return;
+            const int32_t arc = arcs.size();
+            arcs.push_back(ChArc{u, w, weight, -1, first, second});
+            replaced.resize(arcs.size(), 0);
+            if (parallel == out[u].end())
+            {
+                out[u].push_back(arc);
+                in[w].push_back(arc);
+                return;
+            }
+            std::replace(in[w].begin(), in[w].end(), *parallel, arc);
+            replaced[*parallel] = 1;
+            *parallel = arc;
+        }
+
+        // Shortcuts needed to contract v; added to the graph if apply is set
+        int contract(int32_t v, bool apply)
+        {
+            prune(out[v], true);
+            prune(in[v], false);
+            double maxOut = 0;
+            for (int32_t b : out[v])
+                maxOut = std::max(maxOut, arcs[b].weight);
+
+            int shortcuts = 0;
+            for (size_t i = 0; i < in[v].size(); ++i)
+            {
+                const int32_t a = in[v][i];
+                const int32_t u = arcs[a].from;
+                witness_search(u, v, arcs[a].weight + maxOut, apply ? WITNESS_SETTLE_LIMIT : ESTIMATE_SETTLE_LIMIT);
+                for (size_t j = 0; j < out[v].size(); ++j)
+                {
+                    const int32_t b = out[v][j];
+                    const int32_t w = arcs[b].to;
+                    const double d = arcs[a].weight + arcs[b].weight;
+                    if (w == u || witness.dist[w] <= d)
+                        continue;
+                    ++shortcuts;
+                    if (apply)
+                        add_shortcut(u, w, d, a, b);
+                }
+            }
+            return shortcuts;
+        }
+
+        int priority(int32_t v)
+        {
+            const int shortcuts = contract(v, false);
+            return shortcuts - int(in[v].size() + out[v].size()) + contractedNeighbours[v];
+        }
+    };
+}
+
+const ContractionHierarchy &graph_hierarchy(const CsrGraph &csr, bool &built)
+{
+    built = false;
+    if (csr.hierarchy)
+        return *csr.hierarchy;
+    if (!csr.positiveWeights)
+    {
+        throw std::runtime_error("The shortest-path index needs positive edge weights");
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    const size_t n = csr.vertices;
+    std::unique_ptr<ContractionHierarchy> hierarchy(new ContractionHierarchy());
+    std::vector<ChArc> &arcs = hierarchy->arcs;
+    Contraction contraction(n, arcs);
+
+    // Undirected snapshots list every edge in both endpoints' rows, which
+    // gives the arcs in both directions
+    const EdgeRows &rows = csr.out();
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (int32_t i = rows.offsets[u]; i < rows.offsets[u + 1]; ++i)
+        {
+            const int32_t v = rows.targets[i];
+            if (v == int32_t(u))
+                continue;
+            contraction.out[u].push_back(arcs.size());
+            contraction.in[v].push_back(arcs.size());
+            arcs.push_back(ChArc{int32_t(u), v, slot_weight(rows, i), rows.edges[i], -1, -1});
+        }
+    }
+    const size_t edgeArcs = arcs.size();
+    contraction.replaced.assign(edgeArcs, 0);
+
+    // Queue entries older than a vertex's current priority are skipped
+    typedef std::pair<int, int32_t> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> order;
+    std::vector<int> priority(n);
+    for (size_t v = 0; v < n; ++v)
+    {
+        priority[v] = contraction.priority(v);
+        order.push(Candidate(priority[v], v));
+        if ((v + 1) % SEARCH_CHECK_INTERVAL == 0)
+            throw_if_cancelled();
+    }
+
+    hierarchy->rank.assign(n, -1);
+    ProgressCounter progress(n);
+    int32_t next = 0;
+    std::vector<int32_t> neighbours;
+    while (!order.empty())
+    {
+        const Candidate top = order.top();
+        order.pop();
+        const int32_t v = top.second;
+        if (contraction.contracted[v] || top.first != priority[v])
+            continue;
+
+        // Contractions elsewhere may have changed v's witnesses since it was
+        // queued; if it now ranks behind the next candidate, requeue it
+        priority[v] = contraction.priority(v);
+        if (!order.empty() && priority[v] > order.top().first)
+        {
+            order.push(Candidate(priority[v], v));
+            continue;
+        }
+
+        contraction.contract(v, true);
+        contraction.contracted[v] = 1;
+        hierarchy->rank[v] = next++;
+
+        neighbours.clear();
+        for (int32_t a : contraction.out[v])
+            neighbours.push_back(arcs[a].to);
+        for (int32_t a : contraction.in[v])
+            neighbours.push_back(arcs[a].from);
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        for (int32_t u : neighbours)
+        {
+            ++contraction.contractedNeighbours[u];
+            priority[u] = contraction.priority(u);
+            order.push(Candidate(priority[u], u));
+        }
+        progress.add(1);
+    }
+    const std::vector<char> &replaced = contraction.replaced;
+    hierarchy->shortcuts = std::count(replaced.begin() + edgeArcs, replaced.end(), 0);
+
+    // Arcs by the lower-ranked end: upward ones from their tail, downward
+    // ones at their head, which is where the backward search starts them.
+    // Replaced arcs are never on a shortest path and are left out.
+    std::vector<int32_t> &rank = hierarchy->rank;
+    hierarchy->upOffsets.assign(n + 1, 0);
+    hierarchy->downOffsets.assign(n + 1, 0);
+    for (size_t a = 0; a < arcs.size(); ++a)
+    {
+        const ChArc &arc = arcs[a];
+        if (replaced[a])
+            continue;
+        if (rank[arc.from] < rank[arc.to])
+            ++hierarchy->upOffsets[arc.from + 1];
+        else
+            ++hierarchy->downOffsets[arc.to + 1];
+    }
+    for (size_t v = 0; v < n; ++v)
+    {
+        hierarchy->upOffsets[v + 1] += hierarchy->upOffsets[v];
+        hierarchy->downOffsets[v + 1] += hierarchy->downOffsets[v];
+    }
+    hierarchy->up.resize(hierarchy->upOffsets[n]);
+    hierarchy->down.resize(hierarchy->downOffsets[n]);
+    std::vector<int32_t> upFill(hierarchy->upOffsets.begin(), hierarchy->upOffsets.end() - 1);
+    std::vector<int32_t> downFill(hierarchy->downOffsets.begin(), hierarchy->downOffsets.end() - 1);
+    for (size_t a = 0; a < arcs.size(); ++a)
+    {
+        if (replaced[a])
+            continue;
+        if (rank[arcs[a].from] < rank[arcs[a].to])
+            hierarchy->up[upFill[arcs[a].from]++] = a;
+        else
+            hierarchy->down[downFill[arcs[a].to]++] = a;
+    }
+
+    hierarchy->buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    csr.hierarchy = std::move(hierarchy);
+    built = true;
+    return *csr.hierarchy;
+}
+
+// Appends the edges a hierarchy arc stands for, and the vertex each one
+// reaches, in path order
+static void unpack_arc(const CsrGraph &csr, const ContractionHierarchy &hierarchy, int32_t arc, PathSearch &path)
+{
+    std::vector<int32_t> stack(1, arc);
+    while (!stack.empty())
+    {
+        const ChArc &a = hierarchy.arcs[stack.back()];
+        stack.pop_back();
+        if (a.first < 0)
+        {
+            path.vertices.push_back(original_id(csr, a.to));
+            path.edges.push_back(a.edge);
+        }
+        else
+        {
+            stack.push_back(a.second);
+            stack.push_back(a.first);
+        }
+    }
+}
+
+// Both sides only relax arcs towards higher ranks, so neither can stop when
+// the other's frontier is met; a side stops once its queue head reaches the
+// best distance found
+PathSearch hierarchy_search(const CsrGraph &csr, const ContractionHierarchy &hierarchy, int32_t source, int32_t target)
+{
+    check_vertex(csr, source);
+    check_vertex(csr, target);
+    const int32_t s = csr.to_internal(source), t = csr.to_internal(target);
+
+    SearchSide &fw = forwardSide, &bw = backwardSide;
+    fw.reset(csr.vertices);
+    bw.reset(csr.vertices);
+    fw.relax(s, 0, -1, -1);
+    fw.queue.push(QueueEntry(0, s));
+    bw.relax(t, 0, -1, -1);
+    bw.queue.push(QueueEntry(0, t));
+
+    PathSearch path;
+    int32_t meet = -1;
+    while (true)
+    {
+        const double fwHead = fw.queue.empty() ? INFINITY : fw.queue.top().first;
+        const double bwHead = bw.queue.empty() ? INFINITY : bw.queue.top().first;
+        if (std::min(fwHead, bwHead) >= path.distance)
+            break;
+
+        const bool forward = fwHead <= bwHead;
+        SearchSide &side = forward ? fw : bw;
+        const SearchSide &other = forward ? bw : fw;
+        const QueueEntry top = side.queue.top();
+        side.queue.pop();
+        const int32_t u = top.second;
+        if (side.done[u] || top.first > side.dist[u])
+            continue;
+        side.done[u] = 1;
+        ++path.settled;
+        if (other.dist[u] < INFINITY && top.first + other.dist[u] < path.distance)
+        {
+            path.distance = top.first + other.dist[u];
+            meet = u;
+        }
+
+        const std::vector<int32_t> &offsets = forward ? hierarchy.upOffsets : hierarchy.downOffsets;
+        const std::vector<int32_t> &list = forward ? hierarchy.up : hierarchy.down;
+        for (int32_t i = offsets[u]; i < offsets[u + 1]; ++i)
+        {
+            const ChArc &arc = hierarchy.arcs[list[i]];
+            const int32_t v = forward ? arc.to : arc.from;
+            if (side.relax(v, top.first + arc.weight, u, list[i]))
+                side.queue.push(QueueEntry(side.dist[v], v));
+        }
+    }
+
+    if (meet < 0)
+        return path;
+
+    std::vector<int32_t> up;
+    for (int32_t u = meet; fw.pred[u] >= 0; u = fw.pred[u])
+        up.push_back(fw.predEdge[u]);
+    path.vertices.push_back(original_id(csr, s));
+    for (auto arc = up.rbegin(); arc != up.rend(); ++arc)
+        unpack_arc(csr, hierarchy, *arc, path);
+    for (int32_t u = meet; bw.pred[u] >= 0; u = bw.pred[u])
+        unpack_arc(csr, hierarchy, bw.predEdge[u], path);
+    return path;
+}
+
+// MANY PAIRS
+// Pairs are grouped by source and each distinct source gets one Dijkstra,
+// which stops once every target asked for with that source is settled.
+// Sources are spread over the task pool, each thread with its own search
+// state.
+
+struct PairScratch
+{
+    SearchSide side;
+    std::vector<char> wanted;
+};
+
+static std::vector<PairScratch> pairScratch;
+
+PairPaths many_pairs(const CsrGraph &csr, const std::vector<int32_t> &sources, const std::vector<int32_t> &targets, bool paths)
+{
+    if (sources.size() != targets.size())
+    {
+        throw std::runtime_error("Every source needs a target");
+    }
+    if (!csr.nonNegativeWeights)
+    {
+        throw std::runtime_error("Batched shortest paths need non-negative edge weights");
+    }
+    const size_t pairs = sources.size(), n = csr.vertices;
+    std::vector<int32_t> s(pairs), t(pairs);
+    for (size_t i = 0; i < pairs; ++i)
+    {
+        check_vertex(csr, sources[i]);
+        check_vertex(csr, targets[i]);
+        s[i] = csr.to_internal(sources[i]);
+        t[i] = csr.to_internal(targets[i]);
+    }
+
+    // Pair indices by source, and where each source's run starts
+    std::vector<int32_t> order(pairs);
+    for (size_t i = 0; i < pairs; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int32_t a, int32_t b)
+                     { return s[a] < s[b]; });
+    std::vector<size_t> groups;
+    for (size_t i = 0; i < pairs; ++i)
+    {
+        if (i == 0 || s[order[i]] != s[order[i - 1]])
+            groups.push_back(i);
+    }
+    groups.push_back(pairs);
+
+    PairPaths result;
+    result.sources = groups.size() - 1;
+    result.distances.assign(pairs, INFINITY);
+    std::vector<std::vector<int32_t>> pathVertices(paths ? pairs : 0), pathEdges(paths ? pairs : 0);
+
+    pairScratch.resize(TaskPool::instance().size());
+    std::vector<size_t> settled(pairScratch.size(), 0);
+    const EdgeRows &rows = csr.out();
+    ProgressCounter progress(result.sources);
+    TaskPool::instance().parallel_for(0, result.sources, 1, [&](size_t lo, size_t hi, unsigned thread)
+                                      {
+        PairScratch &scratch = pairScratch[thread];
+        SearchSide &side = scratch.side;
+        if (scratch.wanted.size() != n)
+            scratch.wanted.assign(n, 0);
+        for (size_t g = lo; g < hi; ++g)
+        {
+            const size_t begin = groups[g], end = groups[g + 1];
+            const int32_t source = s[order[begin]];
+            size_t pending = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (!scratch.wanted[t[order[i]]])
+                {
+                    scratch.wanted[t[order[i]]] = 1;
+                    ++pending;
+                }
+            }
+
+            side.reset(n);
+            side.relax(source, 0, -1, -1);
+            side.queue.push(QueueEntry(0, source));
+            while (pending > 0 && !side.queue.empty())
+            {
+                const QueueEntry top = side.queue.top();
+                side.queue.pop();
+                const int32_t u = top.second;
+                if (side.done[u] || top.first > side.dist[u])
+                    continue;
+                side.done[u] = 1;
+                if (++settled[thread] % SEARCH_CHECK_INTERVAL == 0 && cancel_requested())
+                {
+                    for (size_t i = begin; i < end; ++i)
+                        scratch.wanted[t[order[i]]] = 0;
+                    throw Cancelled();
+                }
+                if (scratch.wanted[u])
+                    --pending;
+                for (int32_t i = rows.offsets[u]; i < rows.offsets[u + 1]; ++i)
+                {
+                    const int32_t v = rows.targets[i];
+                    if (side.relax(v, top.first + slot_weight(rows, i), u, rows.edges[i]))
+                        side.queue.push(QueueEntry(side.dist[v], v));
+                }
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                const int32_t pair = order[i], target = t[pair];
+                scratch.wanted[target] = 0;
+                if (!side.done[target])
+                    continue;
+                result.distances[pair] = side.dist[target];
+                if (!paths)
+                    continue;
+                for (int32_t u = target; u >= 0; u = side.pred[u])
+                {
+                    pathVertices[pair].push_back(original_id(csr, u));
+                    if (side.pred[u] >= 0)
+                        pathEdges[pair].push_back(side.predEdge[u]);
+                }
+                std::reverse(pathVertices[pair].begin(), pathVertices[pair].end());
+                std::reverse(pathEdges[pair].begin(), pathEdges[pair].end());
+            }
+            progress.add(1);
+        } });
+
+    for (size_t count : settled)
+        result.settled += count;
+    if (!paths)
+        return result;
+
+    result.vertexOffsets.assign(1, 0);
+    result.edgeOffsets.assign(1, 0);
+    for (size_t i = 0; i < pairs; ++i)
+    {
+        result.vertices.insert(result.vertices.end(), pathVertices[i].begin(), pathVertices[i].end());
+        result.edges.insert(result.edges.end(), pathEdges[i].begin(), pathEdges[i].end());
+        result.vertexOffsets.push_back(result.vertices.size());
+        result.edgeOffsets.push_back(result.edges.size());
+    }
+    return result;
+}
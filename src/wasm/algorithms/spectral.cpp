@@ -0,0 +1,410 @@
+#include "spectral.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+// Rows per task in spmv()
+#define SPMV_GRAIN 2048
+
+#ifdef __wasm_simd128__
+static inline double lane_sum(v128_t v)
+{
+    return wasm_f64x2_extract_lane(v, 0) + wasm_f64x2_extract_lane(v, 1);
+}
+#endif
+
+// Row sum of spmv(). The x values of a row are scattered, so each lane pair
+// is gathered with two scalar loads; weights are contiguous and loaded whole.
+static inline double row_sum(const EdgeRows &rows, const double *x, int32_t i, int32_t end)
+{
+    const int32_t *t = rows.targets.data();
+    const double *w = rows.weights.empty() ? NULL : rows.weights.data();
+    double sum = 0;
+#ifdef __wasm_simd128__
+    v128_t acc = wasm_f64x2_splat(0);
+    if (w == NULL)
+    {
+        for (; i + 2 <= end; i += 2)
+            acc = wasm_f64x2_add(acc, wasm_f64x2_make(x[t[i]], x[t[i + 1]]));
+    }
+    else
+    {
+        for (; i + 2 <= end; i += 2)
+            acc = wasm_f64x2_add(acc, wasm_f64x2_mul(wasm_f64x2_make(x[t[i]], x[t[i + 1]]), wasm_v128_load(w + i)));
+    }
+    sum = lane_sum(acc);
+#endif
+    if (w == NULL)
+    {
+        for (; i < end; ++i)
+            sum += x[t[i]];
+    }
+    else
+    {
+        for (; i < end; ++i)
+            sum += x[t[i]] * w[i];
+    }
+    return sum;
+}
+
+void spmv(const EdgeRows &rows, const double *x, double *y)
+{
+    const size_t n = rows.offsets.size() - 1;
+    const int32_t *offsets = rows.offsets.data();
+    TaskPool::instance().parallel_for(0, n, SPMV_GRAIN, [&](size_t lo, size_t hi, unsigned)
+                                      {
+        for (size_t v = lo; v < hi; ++v)
+            y[v] = row_sum(rows, x, offsets[v], offsets[v + 1]); });
+}
+
+double l1_norm(const double *x, size_t n)
+{
+    size_t i = 0;
+    double sum = 0;
+#ifdef __wasm_simd128__
+    v128_t acc = wasm_f64x2_splat(0);
+    for (; i + 2 <= n; i += 2)
+        acc = wasm_f64x2_add(acc, wasm_f64x2_abs(wasm_v128_load(x + i)));
+    sum = lane_sum(acc);
+#endif
+    for (; i < n; ++i)
+        sum += std::fabs(x[i]);
+    return sum;
+}
+
+double vector_norm2(const double *x, size_t n)
+{
+    size_t i = 0;
+    double sum = 0;
+#ifdef __wasm_simd128__
+    v128_t acc = wasm_f64x2_splat(0);
+    for (; i + 2 <= n; i += 2)
+    {
+        const v128_t v = wasm_v128_load(x + i);
+        acc = wasm_f64x2_add(acc, wasm_f64x2_mul(v, v));
+    }
+    sum = lane_sum(acc);
+#endif
+    for (; i < n; ++i)
+        sum += x[i] * x[i];
+    return std::sqrt(sum);
+}
+
+double vector_max(const double *x, size_t n)
+{
+    size_t i = 0;
+    double max = -INFINITY;
+#ifdef __wasm_simd128__
+    v128_t acc = wasm_f64x2_splat(-INFINITY);
+    for (; i + 2 <= n; i += 2)
+        acc = wasm_f64x2_max(acc, wasm_v128_load(x + i));
+    max = std::max(wasm_f64x2_extract_lane(acc, 0), wasm_f64x2_extract_lane(acc, 1));
+#endif
+    for (; i < n; ++i)
+        max = std::max(max, x[i]);
+    return max;
+}
+
+double l1_distance(const double *a, const double *b, size_t n)
+{
+    size_t i = 0;
+    double sum = 0;
+#ifdef __wasm_simd128__
+    v128_t acc = wasm_f64x2_splat(0);
+    for (; i + 2 <= n; i += 2)
+        acc = wasm_f64x2_add(acc, wasm_f64x2_abs(wasm_f64x2_sub(wasm_v128_load(a + i), wasm_v128_load(b + i))));
+    sum = lane_sum(acc);
+#endif
+    for (; i < n; ++i)
+        sum += std::fabs(a[i] - b[i]);
+    return sum;
+}
+
+void scale_vector(double *x, size_t n, double factor)
+{
+    size_t i = 0;
+#ifdef __wasm_simd128__
+    const v128_t f = wasm_f64x2_splat(factor);
+    for (; i + 2 <= n; i += 2)
+        wasm_v128_store(x + i, wasm_f64x2_mul(wasm_v128_load(x + i), f));
+#endif
+    for (; i < n; ++i)
+        x[i] *= factor;
+}
+
+PowerResult power_iterate(size_t n, DenseVector start, const std::function<void(const double *x, double *y)> &step, const SpectralOptions &options)
+{
+    PowerResult result;
+    result.x = std::move(start);
+    if (n == 0)
+    {
+        result.converged = true;
+        return result;
+    }
+
+    DenseVector next(n);
+    ProgressCounter progress(options.maxIterations);
+    while (result.iterations < options.maxIterations)
+    {
+        step(result.x.data(), next.data());
+        result.iterations++;
+        const double norm = l1_norm(next.data(), n);
+        if (norm == 0)
+        {
+            throw std::runtime_error("The iteration reached the zero vector, try another start vector");
+        }
+        result.residual = l1_distance(result.x.data(), next.data(), n) / norm;
+        result.x.swap(next);
+        if (!std::isfinite(result.residual))
+            break;
+        if (result.residual < options.tolerance)
+        {
+            result.converged = true;
+            break;
+        }
+        progress.add(1);
+    }
+    return result;
+}
+
+// The start of a kernel's run in internal IDs: options.start if given, else
+// the kernel's last result on this snapshot, else `fallback` everywhere
+static DenseVector start_vector(const CsrGraph &csr, const std::string &key, const SpectralOptions &options, double fallback, bool &warm)
+{
+    const size_t n = csr.vertices;
+    DenseVector x(n, fallback);
+    warm = false;
+    if (!options.start.empty())
+    {
+        if (options.start.size() != n)
+        {
+            throw std::runtime_error("The start vector needs one value per vertex");
+        }
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i] = options.start[csr.original.empty() ? i : csr.original[i]];
+            if (!(x[i] >= 0) || !std::isfinite(x[i]))
+            {
+                throw std::runtime_error("The start vector must be finite and non-negative");
+            }
+            sum += x[i];
+        }
+        if (sum == 0)
+        {
+            throw std::runtime_error("The start vector must not be zero");
+        }
+        return x;
+    }
+
+    auto found = csr.warmStarts.find(key);
+    if (found != csr.warmStarts.end())
+    {
+        std::copy(found->second.begin(), found->second.end(), x.begin());
+        warm = true;
+    }
+    return x;
+}
+
+// Keeps the final vector as the next warm start and maps it to igraph IDs
+static void finish(const CsrGraph &csr, const std::string &key, const PowerResult &power, SpectralResult &result)
+{
+    csr.warmStarts[key].assign(power.x.begin(), power.x.end());
+    result.scores = csr.to_original(std::vector<double>(power.x.begin(), power.x.end()));
+    result.iterations = power.iterations;
+    result.residual = power.residual;
+    result.converged = power.converged;
+}
+
+// Every vertex scores `value`, as igraph reports graphs without edges
+static SpectralResult uniform_result(const CsrGraph &csr, double value)
+{
+    SpectralResult result;
+    result.scores.assign(csr.vertices, value);
+    result.converged = true;
+    return result;
+}
+
+// Pulls rank along in-edges: every vertex passes its rank divided by its
+// out-strength, and dangling vertices spread theirs over all vertices like
+// the teleport share. Ranks sum to 1.
+SpectralResult spectral_pagerank(const CsrGraph &csr, double damping, const SpectralOptions &options)
+{
+    if (!(damping >= 0 && damping <= 1))
+    {
+        throw std::runtime_error("The damping factor must be between 0 and 1");
+    }
+    const size_t n = csr.vertices;
+    const EdgeRows &out = csr.out();
+
+    // Reciprocal out-strength, 0 for dangling vertices
+    DenseVector inverse(n);
+    for (size_t v = 0; v < n; ++v)
+    {
+        double strength = out.offsets[v + 1] - out.offsets[v];
+        if (csr.weighted)
+        {
+            strength = 0;
+            for (int32_t i = out.offsets[v]; i < out.offsets[v + 1]; ++i)
+                strength += out.weights[i];
+        }
+        inverse[v] = strength > 0 ? 1 / strength : 0;
+    }
+
+    SpectralResult result;
+    DenseVector start = start_vector(csr, "pagerank", options, 1.0, result.warmStarted);
+    if (n > 0)
+        scale_vector(start.data(), n, 1 / l1_norm(start.data(), n));
+
+    DenseVector shares(n);
+    PowerResult power = power_iterate(n, std::move(start), [&](const double *x, double *y)
+                                      {
+        double dangling = 0;
+        for (size_t v = 0; v < n; ++v)
+        {
+            shares[v] = x[v] * inverse[v];
+            if (inverse[v] == 0)
+                dangling += x[v];
+        }
+        spmv(csr.in(), shares.data(), y);
+        const double teleport = (1 - damping + damping * dangling) / n;
+        for (size_t v = 0; v < n; ++v)
+            y[v] = damping * y[v] + teleport;
+        scale_vector(y, n, 1 / l1_norm(y, n)); }, options);
+
+    finish(csr, "pagerank", power, result);
+    result.value = 1;
+    return result;
+}
+
+// Kahn's algorithm over the out-rows. A self-loop keeps its vertex from ever
+// being freed, so it counts as a cycle, as in igraph_is_dag().
+static bool is_acyclic(const CsrGraph &csr)
+{
+    const EdgeRows &rows = csr.out();
+    const size_t n = csr.vertices;
+    std::vector<int32_t> indegree(n, 0), ready;
+    for (int32_t target : rows.targets)
+        ++indegree[target];
+    for (size_t v = 0; v < n; ++v)
+    {
+        if (indegree[v] == 0)
+            ready.push_back(v);
+    }
+    size_t freed = 0;
+    while (!ready.empty())
+    {
+        const int32_t u = ready.back();
+        ready.pop_back();
+        ++freed;
+        for (int32_t i = rows.offsets[u]; i < rows.offsets[u + 1]; ++i)
+        {
+            if (--indegree[rows.targets[i]] == 0)
+                ready.push_back(rows.targets[i]);
+        }
+    }
+    return freed == n;
+}
+
+// Iterates with A + I instead of A: the same eigenvectors, but the shift
+// keeps bipartite graphs from oscillating between their two sides. Scores
+// have unit 2-norm like igraph's without scaling.
+//
+// A directed graph without cycles has no eigenvalue but 0, and A + I would
+// converge to a shifted iterate instead; like igraph, every vertex then
+// scores 0 with a warning.
+SpectralResult spectral_eigenvector(const CsrGraph &csr, const SpectralOptions &options)
+{
+    const size_t n = csr.vertices;
+    if (csr.edgeCount == 0)
+        return uniform_result(csr, 1);
+    if (csr.directed && is_acyclic(csr))
+    {
+        SpectralResult zeros = uniform_result(csr, 0);
+        zeros.warning = "Graph is directed and acyclic; eigenvector centralities will be zeros.";
+        return zeros;
+    }
+
+    SpectralResult result;
+    DenseVector start = start_vector(csr, "eigenvector", options, 1.0, result.warmStarted);
+    scale_vector(start.data(), n, 1 / vector_norm2(start.data(), n));
+
+    double value = 0;
+    PowerResult power = power_iterate(n, std::move(start), [&](const double *x, double *y)
+                                      {
+        spmv(csr.in(), x, y);
+        value = l1_norm(y, n) / l1_norm(x, n);
+        for (size_t v = 0; v < n; ++v)
+            y[v] += x[v];
+        scale_vector(y, n, 1 / vector_norm2(y, n)); }, options);
+
+    finish(csr, "eigenvector", power, result);
+    result.value = value;
+    return result;
+}
+
+// x <- alpha A x + beta, converging when alpha is below 1 / the dominant
+// eigenvalue. Scores are left unscaled.
+SpectralResult spectral_katz(const CsrGraph &csr, double alpha, double beta, const SpectralOptions &options)
+{
+    if (!(alpha > 0) || !(beta > 0))
+    {
+        throw std::runtime_error("Katz centrality needs positive alpha and beta");
+    }
+    const size_t n = csr.vertices;
+
+    SpectralResult result;
+    DenseVector start = start_vector(csr, "katz", options, beta, result.warmStarted);
+    PowerResult power = power_iterate(n, std::move(start), [&](const double *x, double *y)
+                                      {
+        spmv(csr.in(), x, y);
+        for (size_t v = 0; v < n; ++v)
+            y[v] = alpha * y[v] + beta; }, options);
+
+    if (!std::isfinite(power.residual) || !std::isfinite(l1_norm(power.x.data(), n)))
+    {
+        throw std::runtime_error("Katz centrality diverges, alpha must be below 1 / the largest eigenvalue");
+    }
+    finish(csr, "katz", power, result);
+    result.value = 1;
+    return result;
+}
+
+// Authorities are iterated as a <- A^T A a, both products taken row-wise
+// (hubs from out-rows, authorities from in-rows); hubs follow from the final
+// authorities. Both are scaled to a maximum of 1 like igraph's.
+SpectralResult spectral_hits(const CsrGraph &csr, const SpectralOptions &options)
+{
+    const size_t n = csr.vertices;
+    if (csr.edgeCount == 0)
+    {
+        SpectralResult result = uniform_result(csr, 1);
+        result.hubs = result.scores;
+        return result;
+    }
+
+    SpectralResult result;
+    DenseVector start = start_vector(csr, "hits", options, 1.0, result.warmStarted);
+    DenseVector hubs(n);
+    double value = 0;
+    PowerResult power = power_iterate(n, std::move(start), [&](const double *a, double *y)
+                                      {
+        spmv(csr.out(), a, hubs.data());
+        spmv(csr.in(), hubs.data(), y);
+        value = vector_max(y, n) / vector_max(a, n);
+        const double max = vector_max(y, n);
+        if (max > 0)
+            scale_vector(y, n, 1 / max); }, options);
+
+    finish(csr, "hits", power, result);
+    spmv(csr.out(), power.x.data(), hubs.data());
+    const double max = vector_max(hubs.data(), n);
+    if (max > 0)
+        scale_vector(hubs.data(), n, 1 / max);
+    result.hubs = csr.to_original(std::vector<double>(hubs.begin(), hubs.end()));
+    result.value = value;
+    return result;
+}
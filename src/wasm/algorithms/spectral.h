@@ -0,0 +1,48 @@
+#ifndef SPECTRAL_H
+#define SPECTRAL_H
+
+#include "../graph.h"
+#include <functional>
+
+// SPARSE MATRIX-VECTOR ENGINE
+// Power iterations over the rows of a CSR snapshot, shared by PageRank,
+// eigenvector, Katz and HITS centrality (spectral.cpp). Vectors are dense,
+// one entry per vertex in the snapshot's internal order, and 64-byte aligned
+// like the row weights. With -msimd128 (see the Dockerfile) the row sums and
+// the vector reductions run two doubles per WASM SIMD instruction; other
+// builds use the scalar loops.
+//
+// Usage, e.g. for an iteration x <- A x / |A x|:
+//
+//   PowerResult r = power_iterate(n, start, [&](const double *x, double *y) {
+//       spmv(csr.in(), x, y);
+//       scale_vector(y, n, 1 / vector_norm2(y, n));
+//   }, options);
+
+typedef AlignedVector<double> DenseVector;
+
+// y[v] = sum over v's row of weight * x[target], the weight being 1 for
+// unweighted snapshots. Rows are split over the task pool.
+void spmv(const EdgeRows &rows, const double *x, double *y);
+
+double l1_norm(const double *x, size_t n);
+double vector_norm2(const double *x, size_t n);
+double vector_max(const double *x, size_t n);
+double l1_distance(const double *a, const double *b, size_t n);
+void scale_vector(double *x, size_t n, double factor);
+
+struct PowerResult
+{
+    DenseVector x;
+    int iterations = 0;
+    double residual = 0; // relative L1 change of the last iteration
+    bool converged = false;
+};
+
+// Runs x <- step(x) from start until the L1 change of an iteration, relative
+// to the L1 norm of the new vector, falls below options.tolerance. Checks for
+// cancellation between iterations and reports progress against
+// options.maxIterations; options.start is left to the caller.
+PowerResult power_iterate(size_t n, DenseVector start, const std::function<void(const double *x, double *y)> &step, const SpectralOptions &options);
+
+#endif
@@ -0,0 +1,191 @@
+#include "../graph.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+// PARALLEL SINGLE-SOURCE SHORTEST PATHS
+// Delta-stepping (Meyer and Sanders), in the frontier form of the GAP
+// benchmark suite. Tentative distances fall into buckets of width delta;
+// the lowest non-empty bucket is the frontier, and its vertices relax all
+// their out-edges in parallel, lowering distances with a compare-and-swap.
+// A lowered vertex goes into its new bucket in the relaxing thread's own
+// bins, so the only shared writes are the distances. Vertices that land in
+// the current bucket again (over edges lighter than delta) make the bucket
+// the next frontier once more; a frontier vertex whose distance has dropped
+// below the bucket was already relaxed from there and is skipped.
+//
+// Small deltas approach Dijkstra, large ones Bellman-Ford: the default is
+// the mean weight scaled down by the average degree, so that a bucket holds
+// around DELTA_SCALE times the vertices one Dijkstra step would, never below
+// the lightest edge.
+//
+// Distances equal Dijkstra's to the bit, being the same minimum over the
+// same sums. Every reached vertex then takes as predecessor the tight
+// in-edge (dist[u] + w == dist[v]) with the lowest edge ID, which does not
+// depend on thread timing.
+
+#define DELTA_SCALE 4
+
+// Frontier vertices per task
+#define FRONTIER_GRAIN 256
+
+// Highest bucket index. Farther distances share this bucket, which then runs
+// as Bellman-Ford, and the index stays defined where d / delta > SIZE_MAX.
+#define MAX_BUCKET (size_t(1) << 20)
+
+static inline bool lower_to(std::atomic<double> &slot, double value)
+{
+    double current = slot.load(std::memory_order_relaxed);
+    while (value < current)
+    {
+        if (slot.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+static inline size_t bucket_of(double distance, double delta)
+{
+    const double b = distance / delta;
+    return b < MAX_BUCKET ? size_t(b) : MAX_BUCKET;
+}
+
+double delta_stepping_width(const CsrGraph &csr)
+{
+    const EdgeRows &rows = csr.out();
+    const size_t slots = rows.targets.size();
+    if (!csr.weighted || slots == 0)
+        return 1;
+    double sum = 0, lightest = INFINITY;
+    for (double w : rows.weights)
+    {
+        sum += w;
+        lightest = std::min(lightest, w);
+    }
+    const double averageDegree = double(slots) / csr.vertices;
+    return std::max(lightest, sum / slots * DELTA_SCALE / averageDegree);
+}
+
+SourceTree delta_stepping(const CsrGraph &csr, int32_t source, double delta)
+{
+    if (source < 0 || source >= csr.vertices)
+    {
+        throw std::runtime_error("Vertex " + std::to_string(source) + " is not in the graph");
+    }
+    if (!csr.positiveWeights)
+    {
+        throw std::runtime_error("Delta-stepping needs positive edge weights");
+    }
+    const size_t n = csr.vertices;
+    const EdgeRows &rows = csr.out();
+    SourceTree tree;
+    tree.delta = delta > 0 ? delta : delta_stepping_width(csr);
+
+    std::unique_ptr<std::atomic<double>[]> dist(new std::atomic<double>[n]);
+    TaskPool &pool = TaskPool::instance();
+    pool.parallel_for(0, n, 4096, [&](size_t lo, size_t hi, unsigned)
+                      {
+        for (size_t v = lo; v < hi; ++v)
+            dist[v].store(INFINITY, std::memory_order_relaxed); });
+
+    // bins[thread][b] holds vertices lowered into bucket b by that thread
+    std::vector<std::vector<std::vector<int32_t>>> bins(pool.size());
+    std::vector<size_t> relaxed(pool.size(), 0);
+    const int32_t s = csr.to_internal(source);
+    dist[s].store(0, std::memory_order_relaxed);
+    std::vector<int32_t> frontier(1, s);
+    size_t bucket = 0;
+
+    while (!frontier.empty())
+    {
+        pool.parallel_for(0, frontier.size(), FRONTIER_GRAIN, [&](size_t lo, size_t hi, unsigned thread)
+                          {
+            std::vector<std::vector<int32_t>> &local = bins[thread];
+            for (size_t i = lo; i < hi; ++i)
+            {
+                const int32_t u = frontier[i];
+                const double du = dist[u].load(std::memory_order_relaxed);
+                if (bucket_of(du, tree.delta) < bucket)
+                    continue;
+                for (int32_t j = rows.offsets[u]; j < rows.offsets[u + 1]; ++j)
+                {
+                    const int32_t v = rows.targets[j];
+                    const double dv = du + (rows.weights.empty() ? 1.0 : rows.weights[j]);
+                    if (!lower_to(dist[v], dv))
+                        continue;
+                    const size_t b = bucket_of(dv, tree.delta);
+                    if (b >= local.size())
+                        local.resize(b + 1);
+                    local[b].push_back(v);
+                }
+                relaxed[thread] += rows.offsets[u + 1] - rows.offsets[u];
+            } });
+        ++tree.phases;
+        throw_if_cancelled();
+
+        // Lowest bucket any thread filled, at or after the current one
+        size_t next = SIZE_MAX;
+        for (const auto &local : bins)
+        {
+            for (size_t b = bucket; b < local.size() && b < next; ++b)
+            {
+                if (!local[b].empty())
+                {
+                    next = b;
+                    break;
+                }
+            }
+        }
+        frontier.clear();
+        if (next == SIZE_MAX)
+            break;
+        for (auto &local : bins)
+        {
+            if (next < local.size())
+            {
+                frontier.insert(frontier.end(), local[next].begin(), local[next].end());
+                local[next].clear();
+            }
+        }
+        bucket = next;
+    }
+    for (size_t count : relaxed)
+        tree.relaxed += count;
+
+    // Predecessors from tight in-edges, in igraph IDs
+    const EdgeRows &in = csr.in();
+    tree.distances.assign(n, INFINITY);
+    tree.pred.assign(n, -1);
+    tree.predEdge.assign(n, -1);
+    std::vector<size_t> reached(pool.size(), 0);
+    pool.parallel_for(0, n, 4096, [&](size_t lo, size_t hi, unsigned thread)
+                      {
+        for (size_t v = lo; v < hi; ++v)
+        {
+            const double dv = dist[v].load(std::memory_order_relaxed);
+            if (dv == INFINITY)
+                continue;
+            const int32_t original = csr.original.empty() ? v : csr.original[v];
+            tree.distances[original] = dv;
+            ++reached[thread];
+            if (int32_t(v) == s)
+                continue;
+            int32_t pred = -1, edge = -1;
+            for (int32_t j = in.offsets[v]; j < in.offsets[v + 1]; ++j)
+            {
+                const int32_t u = in.targets[j];
+                const double w = in.weights.empty() ? 1.0 : in.weights[j];
+                if (dist[u].load(std::memory_order_relaxed) + w == dv && (edge < 0 || in.edges[j] < edge))
+                {
+                    pred = u;
+                    edge = in.edges[j];
+                }
+            }
+            tree.pred[original] = csr.original.empty() ? pred : csr.original[pred];
+            tree.predEdge[original] = edge;
+        } });
+    for (size_t count : reached)
+        tree.reached += count;
+    return tree;
+}
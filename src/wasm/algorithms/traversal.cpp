@@ -0,0 +1,131 @@
+#include "../graph.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+// DIRECTION-OPTIMIZING BFS
+// Beamer, Asanovic and Patterson, "Direction-Optimizing Breadth-First
+// Search" (SC 2012). A top-down step scans the out-edges of the frontier and
+// claims unvisited neighbours; a bottom-up step lets every unvisited vertex
+// scan its in-edges for a frontier vertex and stop at the first one. On
+// low-diameter graphs the middle levels reach most vertices, and bottom-up
+// then skips most of their edges.
+//
+// Top-down keeps the frontier as a vertex list and claims vertices with a
+// compare-and-swap on their depth. Bottom-up reads it from a bitmap, and
+// each vertex is only written by the thread whose range holds it. The
+// switch follows the paper: go bottom-up once the frontier's out-edges
+// exceed the unvisited vertices' in-edges / ALPHA, and back once the
+// frontier shrinks below n / BETA vertices.
+
+#define ALPHA 14
+#define BETA 24
+
+// Vertices per bottom-up task
+#define BFS_GRAIN 4096
+
+BfsLayers direction_optimizing_bfs(const CsrGraph &csr, int32_t source)
+{
+    if (source < 0 || source >= csr.vertices)
+    {
+        throw std::runtime_error("Vertex " + std::to_string(source) + " is not in the graph");
+    }
+    const size_t n = csr.vertices, words = (n + 63) / 64;
+    const EdgeRows &out = csr.out(), &in = csr.in();
+    TaskPool &pool = TaskPool::instance();
+
+    std::unique_ptr<std::atomic<int32_t>[]> depth(new std::atomic<int32_t>[n]);
+    pool.parallel_for(0, n, BFS_GRAIN, [&](size_t lo, size_t hi, unsigned)
+                      {
+        for (size_t v = lo; v < hi; ++v)
+            depth[v].store(-1, std::memory_order_relaxed); });
+
+    const int32_t s = csr.to_internal(source);
+    depth[s].store(0, std::memory_order_relaxed);
+    std::vector<int32_t> queue(1, s);
+    std::vector<uint64_t> frontier(words, 0);
+    std::vector<std::vector<int32_t>> found(pool.size());
+
+    BfsLayers result;
+    result.bottomUp.push_back(0);
+    std::vector<int32_t> layer(1, s);
+    size_t layerSize = 1;
+
+    // In-edges still to be checked by a bottom-up step, summed over the
+    // unvisited vertices
+    int64_t unexploredEdges = in.targets.size() - (in.offsets[s + 1] - in.offsets[s]);
+    bool bottomUp = false;
+    ProgressCounter progress(n);
+
+    for (int32_t level = 1; layerSize > 0; ++level)
+    {
+        for (int32_t v : layer)
+            result.order.push_back(csr.original.empty() ? v : csr.original[v]);
+        std::sort(result.order.end() - layer.size(), result.order.end());
+        result.layerStarts.push_back(result.order.size() - layer.size());
+        progress.add(layer.size());
+
+        int64_t frontierEdges = 0;
+        for (int32_t v : layer)
+            frontierEdges += out.offsets[v + 1] - out.offsets[v];
+        if (!bottomUp && frontierEdges > unexploredEdges / ALPHA)
+            bottomUp = true;
+        else if (bottomUp && layerSize < n / BETA)
+            bottomUp = false;
+
+        for (auto &list : found)
+            list.clear();
+        if (bottomUp)
+        {
+            std::fill(frontier.begin(), frontier.end(), 0);
+            for (int32_t v : layer)
+                frontier[v / 64] |= uint64_t(1) << (v % 64);
+            pool.parallel_for(0, n, BFS_GRAIN, [&](size_t lo, size_t hi, unsigned thread)
+                              {
+                for (size_t v = lo; v < hi; ++v)
+                {
+                    if (depth[v].load(std::memory_order_relaxed) >= 0)
+                        continue;
+                    for (int32_t j = in.offsets[v]; j < in.offsets[v + 1]; ++j)
+                    {
+                        const int32_t u = in.targets[j];
+                        if (frontier[u / 64] >> (u % 64) & 1)
+                        {
+                            depth[v].store(level, std::memory_order_relaxed);
+                            found[thread].push_back(v);
+                            break;
+                        }
+                    }
+                } });
+        }
+        else
+        {
+            pool.parallel_for(0, layer.size(), BFS_GRAIN / 16, [&](size_t lo, size_t hi, unsigned thread)
+                              {
+                for (size_t i = lo; i < hi; ++i)
+                {
+                    const int32_t u = layer[i];
+                    for (int32_t j = out.offsets[u]; j < out.offsets[u + 1]; ++j)
+                    {
+                        const int32_t v = out.targets[j];
+                        int32_t unseen = -1;
+                        if (depth[v].load(std::memory_order_relaxed) < 0 &&
+                            depth[v].compare_exchange_strong(unseen, level, std::memory_order_relaxed))
+                            found[thread].push_back(v);
+                    }
+                } });
+        }
+
+        layer.clear();
+        for (const auto &list : found)
+            layer.insert(layer.end(), list.begin(), list.end());
+        layerSize = layer.size();
+        if (layerSize > 0)
+            result.bottomUp.push_back(bottomUp);
+        for (int32_t v : layer)
+            unexploredEdges -= in.offsets[v + 1] - in.offsets[v];
+    }
+    result.layerStarts.push_back(result.order.size());
+    return result;
+}
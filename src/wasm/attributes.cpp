@@ -0,0 +1,412 @@
+#include "graph.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+// contains the typed attribute store of resident graphs: bulk import from
+// typed arrays, zero-copy views for JS and numeric access for algorithms
+
+static const double MISSING_NUMBER = std::numeric_limits<double>::quiet_NaN();
+
+size_t AttributeColumn::size(void) const
+{
+    switch (type)
+    {
+    case ATTRIBUTE_FLOAT:
+    case ATTRIBUTE_TIMESTAMP:
+        return numbers.size();
+    case ATTRIBUTE_BOOL:
+        return bools.size();
+    default:
+        return ints.size();
+    }
+}
+
+void AttributeColumn::resize(size_t n)
+{
+    switch (type)
+    {
+    case ATTRIBUTE_FLOAT:
+    case ATTRIBUTE_TIMESTAMP:
+        numbers.resize(n, MISSING_NUMBER);
+        break;
+    case ATTRIBUTE_BOOL:
+        bools.resize(n, 0);
+        break;
+    case ATTRIBUTE_INT:
+        ints.resize(n, 0);
+        break;
+    case ATTRIBUTE_STRING:
+        ints.resize(n, -1);
+        break;
+    }
+}
+
+template <typename T>
+static void compact_values(std::vector<T> &values, const std::vector<bool> &keep)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (keep[i])
+            values[out++] = values[i];
+    }
+    values.resize(out);
+}
+
+void AttributeColumn::compact(const std::vector<bool> &keep)
+{
+    compact_values(numbers, keep);
+    compact_values(ints, keep);
+    compact_values(bools, keep);
+}
+
+double AttributeColumn::number(size_t i) const
+{
+    switch (type)
+    {
+    case ATTRIBUTE_FLOAT:
+    case ATTRIBUTE_TIMESTAMP:
+        return numbers[i];
+    case ATTRIBUTE_BOOL:
+        return bools[i];
+    case ATTRIBUTE_INT:
+        return ints[i];
+    default:
+        throw std::runtime_error("String attributes have no numeric value");
+    }
+}
+
+static AttributeType attribute_type(const std::string &type)
+{
+    if (type == "int")
+        return ATTRIBUTE_INT;
+    if (type == "float")
+        return ATTRIBUTE_FLOAT;
+    if (type == "bool")
+        return ATTRIBUTE_BOOL;
+    if (type == "timestamp")
+        return ATTRIBUTE_TIMESTAMP;
+    if (type == "string")
+        return ATTRIBUTE_STRING;
+    throw std::runtime_error("Unknown attribute type \"" + type + "\"");
+}
+
+static const char *attribute_type_name(AttributeType type)
+{
+    switch (type)
+    {
+    case ATTRIBUTE_INT:
+        return "int";
+    case ATTRIBUTE_FLOAT:
+        return "float";
+    case ATTRIBUTE_BOOL:
+        return "bool";
+    case ATTRIBUTE_TIMESTAMP:
+        return "timestamp";
+    default:
+        return "string";
+    }
+}
+
+static ResidentGraph &initialized_graph(int handle)
+{
+    ResidentGraph &rg = resident_graph(handle);
+    if (!rg.initialized)
+    {
+        throw std::runtime_error("Graph handle " + std::to_string(handle) + " does not hold a graph yet");
+    }
+    return rg;
+}
+
+AttributeStore &attribute_store(ResidentGraph &rg, const std::string &kind)
+{
+    if (kind == "vertex")
+        return rg.vertexAttributes;
+    if (kind == "edge")
+        return rg.edgeAttributes;
+    throw std::runtime_error("Unknown attribute kind \"" + kind + "\", expected vertex or edge");
+}
+
+static size_t element_count(const ResidentGraph &rg, const std::string &kind)
+{
+    return kind == "vertex" ? igraph_vcount(&rg.graph) : igraph_ecount(&rg.graph);
+}
+
+static const AttributeColumn &find_column(const AttributeStore &store, const std::string &name)
+{
+    auto it = store.find(name);
+    if (it == store.end())
+    {
+        throw std::runtime_error("Unknown attribute \"" + name + "\"");
+    }
+    return it->second;
+}
+
+// The column called name with the given type, holding count elements. An
+// empty column takes the type; a column of another type holding values is an
+// error, since replacing it would drop them.
+AttributeColumn &typed_attribute(AttributeStore &store, const std::string &name, AttributeType type, size_t count)
+{
+    AttributeColumn &column = store[name];
+    if (column.size() == 0)
+    {
+        column = AttributeColumn();
+        column.type = type;
+    }
+    else if (column.type != type)
+    {
+        throw std::runtime_error("Attribute \"" + name + "\" holds " + attribute_type_name(column.type) + " values, not " + attribute_type_name(type));
+    }
+    column.resize(count);
+    return column;
+}
+
+// Keep every column of a store in step with igraph's vertex or edge IDs
+void resize_attributes(AttributeStore &store, size_t count)
+{
+    for (auto &entry : store)
+        entry.second.resize(count);
+}
+
+void compact_attributes(AttributeStore &store, const std::vector<bool> &keep)
+{
+    for (auto &entry : store)
+        entry.second.compact(keep);
+}
+
+static int32_t dictionary_code(AttributeColumn &column, const std::string &value)
+{
+    auto it = std::find(column.dictionary.begin(), column.dictionary.end(), value);
+    if (it != column.dictionary.end())
+        return it - column.dictionary.begin();
+    column.dictionary.push_back(value);
+    return column.dictionary.size() - 1;
+}
+
+// Stores one JS value; Dates are accepted for timestamps, and null or
+// undefined store the missing value
+void set_typed_attribute(AttributeColumn &column, size_t i, val value)
+{
+    if (value.isUndefined() || value.isNull())
+    {
+        switch (column.type)
+        {
+        case ATTRIBUTE_FLOAT:
+        case ATTRIBUTE_TIMESTAMP:
+            column.numbers[i] = MISSING_NUMBER;
+            break;
+        case ATTRIBUTE_BOOL:
+            column.bools[i] = 0;
+            break;
+        default:
+            column.ints[i] = column.type == ATTRIBUTE_STRING ? -1 : 0;
+        }
+        return;
+    }
+    switch (column.type)
+    {
+    case ATTRIBUTE_FLOAT:
+        column.numbers[i] = value.as<double>();
+        break;
+    case ATTRIBUTE_TIMESTAMP:
+        column.numbers[i] = value.instanceof(val::global("Date")) ? value.call<double>("getTime") : value.as<double>();
+        break;
+    case ATTRIBUTE_BOOL:
+        column.bools[i] = value.as<bool>() ? 1 : 0;
+        break;
+    case ATTRIBUTE_INT:
+        column.ints[i] = value.as<int32_t>();
+        break;
+    case ATTRIBUTE_STRING:
+        column.ints[i] = dictionary_code(column, value.as<std::string>());
+        break;
+    }
+}
+
+// Reads a { type: "string", values } column: one boundary crossing per
+// string, which JS strings cannot avoid, and a hash lookup to encode it
+static void import_strings(AttributeColumn &column, val values)
+{
+    const size_t n = values["length"].as<size_t>();
+    std::unordered_map<std::string, int32_t> codes;
+    column.ints.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        val value = values[i];
+        if (value.isUndefined() || value.isNull())
+        {
+            column.ints[i] = -1;
+            continue;
+        }
+
+        auto inserted = codes.emplace(value.as<std::string>(), column.dictionary.size());
+        if (inserted.second)
+            column.dictionary.push_back(inserted.first->first);
+        column.ints[i] = inserted.first->second;
+    }
+}
+
+// Replaces or adds the given attributes of every vertex (kind "vertex") or
+// edge ("edge") in one call. columns maps each name to
+//   { type: "int", values: Int32Array }
+//   { type: "float" | "timestamp", values: Float64Array } (timestamps in ms)
+//   { type: "bool", values: Uint8Array }
+//   { type: "string", codes: Int32Array, dictionary: string[] } or
+//   { type: "string", values: (string | null)[] }
+// Typed arrays are copied with a single TypedArray.set() each. Every column
+// is checked before any is stored, so a bad column leaves the store as it was.
+void import_attributes(int handle, std::string kind, val columns)
+{
+    ResidentGraph &rg = initialized_graph(handle);
+    AttributeStore &store = attribute_store(rg, kind);
+    const size_t count = element_count(rg, kind);
+
+    val keys = val::global("Object").call<val>("keys", columns);
+    const unsigned len = keys["length"].as<unsigned>();
+    std::vector<std::pair<std::string, AttributeColumn>> imported(len);
+    for (unsigned i = 0; i < len; ++i)
+    {
+        const std::string name = keys[i].as<std::string>();
+        val spec = columns[name];
+        AttributeColumn &column = imported[i].second;
+        imported[i].first = name;
+        column.type = attribute_type(spec["type"].as<std::string>());
+
+        switch (column.type)
+        {
+        case ATTRIBUTE_FLOAT:
+        case ATTRIBUTE_TIMESTAMP:
+            column.numbers = convertJSArrayToNumberVector<double>(spec["values"]);
+            break;
+        case ATTRIBUTE_BOOL:
+            column.bools = convertJSArrayToNumberVector<uint8_t>(spec["values"]);
+            break;
+        case ATTRIBUTE_INT:
+            column.ints = convertJSArrayToNumberVector<int32_t>(spec["values"]);
+            break;
+        case ATTRIBUTE_STRING:
+            if (spec["dictionary"].isUndefined())
+            {
+                import_strings(column, spec["values"]);
+                break;
+            }
+            column.ints = convertJSArrayToNumberVector<int32_t>(spec["codes"]);
+            column.dictionary = vecFromJSArray<std::string>(spec["dictionary"]);
+            for (int32_t code : column.ints)
+            {
+                if (code < -1 || code >= static_cast<int32_t>(column.dictionary.size()))
+                {
+                    throw std::runtime_error("Attribute \"" + name + "\" has a code outside its dictionary");
+                }
+            }
+            break;
+        }
+
+        if (column.size() != count)
+        {
+            throw std::runtime_error("Attribute \"" + name + "\" has " + std::to_string(column.size()) +
+                                     " values for " + std::to_string(count) + " elements");
+        }
+    }
+
+    for (auto &entry : imported)
+    {
+        if (kind == "edge" && entry.first == rg.weightAttribute)
+            rg.csr.reset();
+        store[entry.first] = std::move(entry.second);
+    }
+}
+
+// { type, values } with values a typed array view over the column itself
+// (plus dictionary for strings). No copy is made: the view is detached if
+// WASM memory grows and stale once the column changes, so read it right away.
+val attribute_column(int handle, std::string kind, std::string name)
+{
+    ResidentGraph &rg = initialized_graph(handle);
+    const AttributeColumn &column = find_column(attribute_store(rg, kind), name);
+
+    val result = val::object();
+    result.set("type", attribute_type_name(column.type));
+    switch (column.type)
+    {
+    case ATTRIBUTE_FLOAT:
+    case ATTRIBUTE_TIMESTAMP:
+        result.set("values", val(typed_memory_view(column.numbers.size(), column.numbers.data())));
+        break;
+    case ATTRIBUTE_BOOL:
+        result.set("values", val(typed_memory_view(column.bools.size(), column.bools.data())));
+        break;
+    case ATTRIBUTE_INT:
+        result.set("values", val(typed_memory_view(column.ints.size(), column.ints.data())));
+        break;
+    case ATTRIBUTE_STRING:
+        result.set("codes", val(typed_memory_view(column.ints.size(), column.ints.data())));
+        result.set("dictionary", val::array(column.dictionary));
+        break;
+    }
+    return result;
+}
+
+void drop_attribute(int handle, std::string kind, std::string name)
+{
+    ResidentGraph &rg = initialized_graph(handle);
+    attribute_store(rg, kind).erase(name);
+    if (kind == "edge" && name == rg.weightAttribute)
+    {
+        rg.weightAttribute.clear();
+        rg.csr.reset();
+    }
+}
+
+// Makes algorithms on this graph read their weights from a float edge
+// attribute instead of the "weight" edge list column ("" switches back).
+// igraph sees the column through a vector view, so nothing is copied.
+void set_weight_attribute(int handle, std::string name)
+{
+    ResidentGraph &rg = initialized_graph(handle);
+    if (!name.empty() && find_column(rg.edgeAttributes, name).type != ATTRIBUTE_FLOAT)
+    {
+        throw std::runtime_error("Weight attribute \"" + name + "\" must be a float attribute");
+    }
+    rg.weightAttribute = name;
+    rg.csr.reset();
+}
+
+// Points weightView at the weight attribute again, as mutations may have
+// moved or resized the column since the last algorithm ran
+void refresh_weight_view(ResidentGraph &rg)
+{
+    if (rg.weightAttribute.empty())
+        return;
+
+    auto it = rg.edgeAttributes.find(rg.weightAttribute);
+    if (it == rg.edgeAttributes.end() || it->second.type != ATTRIBUTE_FLOAT)
+    {
+        throw std::runtime_error("Weight attribute \"" + rg.weightAttribute + "\" is no longer a float attribute");
+    }
+    const std::vector<double> &numbers = it->second.numbers;
+    igraph_vector_view(&rg.weightView, numbers.data(), numbers.size());
+}
+
+// IDs of the vertices or edges whose numeric attribute lies in [min, max],
+// as an Int32Array; missing (NaN) values never match
+val filter_by_attribute(int handle, std::string kind, std::string name, double min, double max)
+{
+    ResidentGraph &rg = initialized_graph(handle);
+    const AttributeColumn &column = find_column(attribute_store(rg, kind), name);
+    if (column.type == ATTRIBUTE_STRING)
+    {
+        throw std::runtime_error("Attribute \"" + name + "\" is not numeric");
+    }
+
+    std::vector<int32_t> ids;
+    const size_t n = column.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double v = column.number(i);
+        if (v >= min && v <= max)
+            ids.push_back(i);
+    }
+    return val::global("Int32Array").new_(typed_memory_view(ids.size(), ids.data()));
+}
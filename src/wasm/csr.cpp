@@ -0,0 +1,308 @@
+#include "graph.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+
+// Fills one direction by a counting sort over the edge list, so each row
+// keeps edge ID order. tails[e] gets edge e in its row, pointing at
+// heads[e]; undirected edges are entered in both rows.
+static void fill_rows(EdgeRows &rows, int32_t n, const std::vector<int32_t> &tails, const std::vector<int32_t> &heads, bool both, const double *weights)
+{
+    const int32_t m = tails.size();
+    rows.offsets.assign(n + 1, 0);
+    for (int32_t e = 0; e < m; ++e)
+    {
+        rows.offsets[tails[e] + 1]++;
+        if (both)
+            rows.offsets[heads[e] + 1]++;
+    }
+    for (int32_t v = 0; v < n; ++v)
+        rows.offsets[v + 1] += rows.offsets[v];
+
+    const int32_t slots = rows.offsets[n];
+    rows.targets.resize(slots);
+    rows.edges.resize(slots);
+    if (weights != NULL)
+        rows.weights.resize(slots);
+
+    std::vector<int32_t> fill(rows.offsets.begin(), rows.offsets.end() - 1);
+    for (int32_t e = 0; e < m; ++e)
+    {
+        for (int side = 0; side < (both ? 2 : 1); ++side)
+        {
+            const int32_t tail = side ? heads[e] : tails[e];
+            const int32_t slot = fill[tail]++;
+            rows.targets[slot] = side ? tails[e] : heads[e];
+            rows.edges[slot] = e;
+            if (weights != NULL)
+                rows.weights[slot] = weights[e];
+        }
+    }
+}
+
+static void fill_all_rows(CsrGraph &csr, const std::vector<int32_t> &from, const std::vector<int32_t> &to, const double *weights)
+{
+    fill_rows(csr.outRows, csr.vertices, from, to, !csr.directed, weights);
+    if (csr.directed)
+        fill_rows(csr.inRows, csr.vertices, to, from, false, weights);
+}
+
+// Mean distance between the IDs of a vertex and its row neighbours, a proxy
+// for how far apart in memory a traversal's accesses land
+static double mean_gap(const EdgeRows &rows)
+{
+    const size_t n = rows.offsets.size() - 1;
+    double sum = 0;
+    for (size_t v = 0; v < n; ++v)
+    {
+        for (int32_t i = rows.offsets[v]; i < rows.offsets[v + 1]; ++i)
+            sum += std::abs(static_cast<double>(rows.targets[i]) - v);
+    }
+    return rows.targets.empty() ? 0 : sum / rows.targets.size();
+}
+
+// Number of row entries of v in both directions
+static int32_t total_degree(const CsrGraph &csr, int32_t v)
+{
+    int32_t degree = csr.outRows.offsets[v + 1] - csr.outRows.offsets[v];
+    if (csr.directed)
+        degree += csr.inRows.offsets[v + 1] - csr.inRows.offsets[v];
+    return degree;
+}
+
+// Vertices sorted by decreasing degree, ties by ID
+static std::vector<int32_t> degree_order(const CsrGraph &csr)
+{
+    std::vector<int32_t> order(csr.vertices);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int32_t a, int32_t b)
+                     { return total_degree(csr, a) > total_degree(csr, b); });
+    return order;
+}
+
+// Reverse Cuthill-McKee on the undirected view of the graph: every component
+// is searched breadth-first from its lowest-degree vertex, neighbours being
+// enqueued by increasing degree, and the final sequence is reversed
+static std::vector<int32_t> rcm_order(const CsrGraph &csr)
+{
+    const int32_t n = csr.vertices;
+    std::vector<int32_t> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), [&](int32_t a, int32_t b)
+                     { return total_degree(csr, a) < total_degree(csr, b); });
+
+    std::vector<int32_t> order;
+    order.reserve(n);
+    std::vector<char> queued(n, 0);
+    std::vector<int32_t> neighbours;
+    for (int32_t start : starts)
+    {
+        if (queued[start])
+            continue;
+        queued[start] = 1;
+        order.push_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); ++head)
+        {
+            const int32_t v = order[head];
+            neighbours.clear();
+            for (const EdgeRows *rows : {&csr.outRows, &csr.inRows})
+            {
+                if (rows->offsets.empty())
+                    continue;
+                for (int32_t i = rows->offsets[v]; i < rows->offsets[v + 1]; ++i)
+                {
+                    const int32_t w = rows->targets[i];
+                    if (!queued[w])
+                    {
+                        queued[w] = 1;
+                        neighbours.push_back(w);
+                    }
+                }
+            }
+            std::stable_sort(neighbours.begin(), neighbours.end(), [&](int32_t a, int32_t b)
+                             { return total_degree(csr, a) < total_degree(csr, b); });
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// One bulk edge list export from igraph, then two counting sorts. With a
+// vertex order the rows are built in igraph IDs first, numbered from them and
+// rebuilt in internal IDs.
+std::unique_ptr<CsrGraph> build_csr(const igraph_t *g, const igraph_vector_t *weights, VertexOrder order)
+{
+    const igraph_integer_t n = igraph_vcount(g);
+    const igraph_integer_t m = igraph_ecount(g);
+    if (n > INT32_MAX || 2 * m > INT32_MAX)
+    {
+        throw std::runtime_error("Graph is too large for a 32-bit CSR snapshot");
+    }
+
+    std::unique_ptr<CsrGraph> csr(new CsrGraph());
+    csr->vertices = static_cast<int32_t>(n);
+    csr->edgeCount = static_cast<int32_t>(m);
+    csr->directed = igraph_is_directed(g);
+    csr->weighted = weights != NULL;
+
+    IGraphVectorInt edgelist;
+    igraph_get_edgelist(g, edgelist.vec(), 0);
+    const igraph_integer_t *ends = VECTOR(*edgelist.vec());
+    csr->from.resize(m);
+    csr->to.resize(m);
+    for (igraph_integer_t e = 0; e < m; ++e)
+    {
+        csr->from[e] = static_cast<int32_t>(ends[2 * e]);
+        csr->to[e] = static_cast<int32_t>(ends[2 * e + 1]);
+    }
+
+    const double *w = weights != NULL ? VECTOR(*weights) : NULL;
+    for (igraph_integer_t e = 0; w != NULL && e < m; ++e)
+    {
+        if (!(w[e] > 0))
+            csr->positiveWeights = false;
+        if (!(w[e] >= 0))
+        {
+            csr->nonNegativeWeights = false;
+            break;
+        }
+    }
+
+    fill_all_rows(*csr, csr->from, csr->to, w);
+    csr->gapBefore = csr->gapAfter = mean_gap(csr->outRows);
+    if (order == ORDER_NONE || n < 2)
+        return csr;
+
+    const auto started = std::chrono::steady_clock::now();
+    csr->order = order;
+    csr->original = order == ORDER_DEGREE ? degree_order(*csr) : rcm_order(*csr);
+    csr->internal.resize(n);
+    for (int32_t i = 0; i < csr->vertices; ++i)
+        csr->internal[csr->original[i]] = i;
+
+    std::vector<int32_t> from(m), to(m);
+    for (igraph_integer_t e = 0; e < m; ++e)
+    {
+        from[e] = csr->internal[csr->from[e]];
+        to[e] = csr->internal[csr->to[e]];
+    }
+    fill_all_rows(*csr, from, to, w);
+    csr->reorderMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    csr->gapAfter = mean_gap(csr->outRows);
+    return csr;
+}
+
+const CsrGraph &graph_csr(void)
+{
+    ResidentGraph &rg = *currentGraph;
+    if (!rg.csr)
+    {
+        rg.csr = build_csr(&rg.graph, igraph_weights(), rg.vertexOrder);
+        rg.reorderMs += rg.csr->reorderMs;
+    }
+    return *rg.csr;
+}
+
+KernelTimer::KernelTimer(const CsrGraph &csr, const char *kernel)
+    : kernel(kernel), order(csr.order), started(std::chrono::steady_clock::now())
+{
+}
+
+// Cancelled and failed runs are not counted
+KernelTimer::~KernelTimer()
+{
+    if (std::uncaught_exceptions() > 0)
+        return;
+    KernelTime &time = currentGraph->kernelTime[order][kernel];
+    time.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    time.runs++;
+}
+
+static const char *const ORDER_NAMES[ORDER_COUNT] = {"none", "degree", "rcm"};
+
+// Numbers the rows of the handle's CSR snapshot in the given order ("none",
+// "degree" or "rcm") from the next algorithm on. The choice survives rebuilds
+// of the graph from new snapshots.
+void set_vertex_order(int handle, std::string order)
+{
+    ResidentGraph &rg = resident_graph(handle);
+    const char *const *found = std::find(ORDER_NAMES, ORDER_NAMES + ORDER_COUNT, order);
+    if (found == ORDER_NAMES + ORDER_COUNT)
+    {
+        throw std::runtime_error("Unknown vertex order \"" + order + "\"");
+    }
+    const VertexOrder chosen = static_cast<VertexOrder>(found - ORDER_NAMES);
+    if (chosen != rg.vertexOrder)
+    {
+        rg.vertexOrder = chosen;
+        rg.csr.reset();
+    }
+}
+
+// What reordering cost and what it bought: the total time spent reordering,
+// the neighbour ID gap of the current snapshot before and after, and the
+// kernel time under each order, in total and by kernel. savedMs compares mean
+// runs of the same kernel under the current order and under "none", summed
+// over the kernels measured under both (null until there is one). All of it
+// covers the graph since it was last built from a snapshot or projected;
+// mutations keep accumulating.
+val vertex_order_stats(int handle)
+{
+    ResidentGraph &rg = resident_graph(handle);
+
+    val stats = val::object();
+    stats.set("order", std::string(ORDER_NAMES[rg.vertexOrder]));
+    stats.set("reorderMs", rg.reorderMs);
+    stats.set("gapBefore", rg.csr ? val(rg.csr->gapBefore) : val::null());
+    stats.set("gapAfter", rg.csr ? val(rg.csr->gapAfter) : val::null());
+
+    auto time_entry = [](const KernelTime &time)
+    {
+        val entry = val::object();
+        entry.set("runs", static_cast<double>(time.runs));
+        entry.set("ms", time.ms);
+        entry.set("meanMs", time.runs ? time.ms / time.runs : 0.0);
+        return entry;
+    };
+    val kernels = val::object();
+    for (int o = 0; o < ORDER_COUNT; ++o)
+    {
+        KernelTime total;
+        val byKernel = val::object();
+        for (const auto &kernel : rg.kernelTime[o])
+        {
+            total.ms += kernel.second.ms;
+            total.runs += kernel.second.runs;
+            byKernel.set(kernel.first, time_entry(kernel.second));
+        }
+        val entry = time_entry(total);
+        entry.set("byKernel", byKernel);
+        kernels.set(ORDER_NAMES[o], entry);
+    }
+    stats.set("kernels", kernels);
+
+    // Different kernels take very different times, so only runs of the same
+    // kernel under both orders are compared
+    double saved = 0;
+    bool compared = false;
+    if (rg.vertexOrder != ORDER_NONE)
+    {
+        const auto &base = rg.kernelTime[ORDER_NONE];
+        for (const auto &kernel : rg.kernelTime[rg.vertexOrder])
+        {
+            auto found = base.find(kernel.first);
+            const KernelTime &current = kernel.second;
+            if (found == base.end() || found->second.runs == 0 || current.runs == 0)
+                continue;
+            const double perRun = found->second.ms / found->second.runs - current.ms / current.runs;
+            saved += perRun * current.runs;
+            compared = true;
+        }
+    }
+    stats.set("savedMs", compared ? val(saved - rg.reorderMs) : val::null());
+    return stats;
+}
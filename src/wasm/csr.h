@@ -0,0 +1,175 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Allocator for arrays that kernels stream through: storage starts on an
+// Alignment-byte boundary, i.e. on a cache line and a SIMD vector
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator
+{
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+    T *allocate(size_t n)
+    {
+        const size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void *p = std::aligned_alloc(Alignment, bytes);
+        if (p == NULL)
+            throw std::bad_alloc();
+        return static_cast<T *>(p);
+    }
+
+    void deallocate(T *p, size_t)
+    {
+        std::free(p);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment> &) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment> &) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// One direction of a CSR snapshot. Vertex v's edges occupy the slots
+// [offsets[v], offsets[v + 1]) in edge ID order; each slot holds the other
+// endpoint (targets), the igraph edge ID (edges) and, for weighted graphs,
+// the weight (weights, empty otherwise).
+struct EdgeRows
+{
+    std::vector<int32_t> offsets, targets, edges;
+    AlignedVector<double> weights;
+};
+
+// Vertex numbering of the rows of a CSR snapshot. Traversals touch the
+// neighbours of a vertex together, so numbering vertices that are adjacent
+// close to each other keeps their per-vertex state in the same cache lines.
+enum VertexOrder
+{
+    ORDER_NONE,   // igraph vertex IDs, i.e. the order the vertices were first seen in
+    ORDER_DEGREE, // by decreasing degree, hubs first
+    ORDER_RCM,    // reverse Cuthill-McKee: breadth-first from low-degree vertices
+    ORDER_COUNT
+};
+
+// Time spent in CSR kernels under one vertex order
+struct KernelTime
+{
+    double ms = 0;
+    size_t runs = 0;
+};
+
+// Distance tables of the ALT landmarks (see algorithms/routing.cpp), in
+// internal IDs and interleaved by vertex: from[v * count + l] is the distance
+// from landmark l to v and to[v * count + l] the distance from v to it
+// (INFINITY if unreachable). Undirected graphs keep only `from`.
+struct Landmarks
+{
+    int count = 0;
+    std::vector<int32_t> vertices;
+    std::vector<double> from, to;
+    double buildMs = 0;
+
+    size_t bytes(void) const { return (from.size() + to.size()) * sizeof(double) + vertices.size() * sizeof(int32_t); }
+};
+
+// Arc of a contraction hierarchy: an edge of the graph (igraph ID in edge)
+// or a shortcut for the arcs first and second through a contracted vertex
+struct ChArc
+{
+    int32_t from, to;
+    double weight;
+    int32_t edge, first, second; // -1 where not applicable
+};
+
+// Contraction hierarchy over a CSR snapshot (see algorithms/routing.cpp), in
+// internal IDs. Vertex v's arcs towards higher ranks are
+// up[upOffsets[v], upOffsets[v + 1]) and the arcs reaching it from higher
+// ranks down[downOffsets[v], downOffsets[v + 1]), both as indices into arcs.
+struct ContractionHierarchy
+{
+    std::vector<int32_t> rank; // contraction order
+    std::vector<ChArc> arcs;
+    std::vector<int32_t> upOffsets, up, downOffsets, down;
+    size_t shortcuts = 0;
+    double buildMs = 0;
+
+    size_t bytes(void) const
+    {
+        return arcs.size() * sizeof(ChArc) + (rank.size() + upOffsets.size() + up.size() + downOffsets.size() + down.size()) * sizeof(int32_t);
+    }
+};
+
+// Compressed sparse row snapshot of a resident graph for native kernels (see
+// csr.cpp). graph_csr() builds it on first use with the weights algorithms
+// currently see, and it stays resident until the graph or its weights
+// change. Kernels walk the rows with plain array indexing instead of igraph
+// calls. Undirected edges appear in the rows of both endpoints, and in() is
+// then the same rows as out().
+//
+// The rows are numbered in the graph's VertexOrder: row i belongs to igraph
+// vertex original[i] and targets hold these internal IDs too. Edge IDs and
+// from/to stay igraph's, and kernels return per-vertex results through
+// to_original(), so nothing outside the kernels sees the internal IDs.
+struct CsrGraph
+{
+    int32_t vertices = 0;
+    int32_t edgeCount = 0;
+    bool directed = false;
+    bool weighted = false;
+    bool positiveWeights = true;    // every weight > 0, true when unweighted
+    bool nonNegativeWeights = true; // every weight >= 0, true when unweighted
+    std::vector<int32_t> from, to;  // igraph endpoints by edge ID
+    EdgeRows outRows, inRows;       // inRows stays empty for undirected graphs
+
+    VertexOrder order = ORDER_NONE;
+    std::vector<int32_t> original; // internal ID -> igraph ID, empty for ORDER_NONE
+    std::vector<int32_t> internal; // igraph ID -> internal ID, empty for ORDER_NONE
+    double reorderMs = 0;          // time spent numbering and rebuilding the rows
+    double gapBefore = 0;          // mean |ID difference| of row neighbours in igraph IDs
+    double gapAfter = 0;           // the same in internal IDs
+
+    // Last result of each power iteration kernel in internal IDs, the start of
+    // its next run (see algorithms/spectral.cpp). Dropped with the snapshot.
+    mutable std::map<std::string, std::vector<double>> warmStarts;
+    mutable std::unique_ptr<Landmarks> landmarks; // built by the first A* query
+    mutable std::unique_ptr<ContractionHierarchy> hierarchy; // built by build_shortest_path_index()
+
+    const EdgeRows &out(void) const { return outRows; }
+    const EdgeRows &in(void) const { return directed ? inRows : outRows; }
+
+    int32_t to_internal(int32_t v) const { return internal.empty() ? v : internal[v]; }
+
+    // Per-vertex values indexed by internal ID, reindexed by igraph ID
+    template <typename T>
+    std::vector<T> to_original(std::vector<T> values) const
+    {
+        if (original.empty())
+            return values;
+        std::vector<T> result(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            result[original[i]] = values[i];
+        return result;
+    }
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "generator.h"
 #include <cstring>
+#include <cmath>
 #include <string>
 
 static inline bool eq(const char *a, const char *b)
@@ -31,29 +32,63 @@ static inline bool is_empty_object(const emscripten::val &v)
     return keys["length"].as<unsigned>() == 0u;
 }
 
-void create_node(igraph_t *g,
+// Type of the typed attribute column a JS attribute value goes into
+static AttributeType value_type(const emscripten::val &value)
+{
+    const std::string type = value.typeOf().as<std::string>();
+    if (type == "number")
+        return ATTRIBUTE_FLOAT;
+    if (type == "boolean")
+        return ATTRIBUTE_BOOL;
+    if (value.instanceof(emscripten::val::global("Date")))
+        return ATTRIBUTE_TIMESTAMP;
+    return ATTRIBUTE_STRING;
+}
+
+// label and tableName stay igraph string attributes (they name the vertex);
+// every other attribute goes into the graph's typed attribute store, typed
+// after its JS value. null and undefined are stored as missing and never
+// decide a column's type; a value of another type than its column throws.
+void create_node(ResidentGraph &rg,
                  igraph_integer_t id,
                  const char *label,
                  const char *tableName,
                  emscripten::val attributes)
 {
-    SETVAS(g, "label", id, label);
-    SETVAS(g, "tableName", id, tableName);
+    SETVAS(&rg.graph, "label", id, label);
+    SETVAS(&rg.graph, "tableName", id, tableName);
 
     if (is_empty_object(attributes))
         return;
 
+    const size_t count = igraph_vcount(&rg.graph);
     auto keys = emscripten::val::global("Object").call<emscripten::val>("keys", attributes);
     unsigned len = keys["length"].as<unsigned>();
     for (unsigned i = 0; i < len; i++)
     {
         std::string key = keys[i].as<std::string>();
-        std::string value = attributes[key].as<std::string>();
-        SETVAS(g, key.c_str(), id, value.c_str());
+        emscripten::val value = attributes[key];
+        if (value.isUndefined() || value.isNull())
+        {
+            auto existing = rg.vertexAttributes.find(key);
+            if (existing != rg.vertexAttributes.end())
+                set_typed_attribute(typed_attribute(rg.vertexAttributes, key, existing->second.type, count), id, value);
+            continue;
+        }
+        AttributeColumn &column = typed_attribute(rg.vertexAttributes, key, value_type(value), count);
+        set_typed_attribute(column, id, value);
     }
 }
 
-val vertex_attributes_object(const igraph_t *g, igraph_integer_t vid)
+// The vertex or edge attributes of a graph, listed once per export instead of
+// once per element
+struct AttributeList
+{
+    std::vector<std::string> names;
+    std::vector<int> types;
+};
+
+static AttributeList list_attributes(const igraph_t *g, igraph_attribute_elemtype_t elemtype)
 {
     igraph_strvector_t gnames, vnames, enames;
     igraph_vector_int_t gtypes, vtypes, etypes;
@@ -65,42 +100,17 @@ val vertex_attributes_object(const igraph_t *g, igraph_integer_t vid)
     igraph_vector_int_init(&vtypes, 0);
     igraph_vector_int_init(&etypes, 0);
 
-    val attrs = val::object();
-
+    AttributeList list;
     if (igraph_cattribute_list(g, &gnames, &gtypes, &vnames, &vtypes, &enames, &etypes) == IGRAPH_SUCCESS)
     {
-        long nv = igraph_strvector_size(&vnames);
-        for (long i = 0; i < nv; ++i)
+        const bool vertex = elemtype == IGRAPH_ATTRIBUTE_VERTEX;
+        igraph_strvector_t &names = vertex ? vnames : enames;
+        igraph_vector_int_t &types = vertex ? vtypes : etypes;
+        long n = igraph_strvector_size(&names);
+        for (long i = 0; i < n; ++i)
         {
-            // (STR macro is only deprecated -> warning is OK; you can migrate later)
-            const char *aname = STR(vnames, i);
-            if (eq(aname, "label") || eq(aname, "tableName") || eq(aname, "name"))
-                continue;
-
-            int atype = VECTOR(vtypes)[i]; // enum value
-            switch (atype)
-            {
-            case IGRAPH_ATTRIBUTE_NUMERIC:
-            {
-                double v = VAN(g, aname, vid);
-                attrs.set(aname, to_str(v));
-                break;
-            }
-            case IGRAPH_ATTRIBUTE_BOOLEAN:
-            {
-                int b = (int)VAB(g, aname, vid);
-                attrs.set(aname, b ? "true" : "false");
-                break;
-            }
-            case IGRAPH_ATTRIBUTE_STRING:
-            {
-                const char *s = VAS(g, aname, vid);
-                attrs.set(aname, s ? std::string(s) : std::string(""));
-                break;
-            }
-            default:
-                attrs.set(aname, std::string(""));
-            }
+            list.names.push_back(STR(names, i));
+            list.types.push_back(VECTOR(types)[i]);
         }
     }
 
@@ -110,80 +120,102 @@ val vertex_attributes_object(const igraph_t *g, igraph_integer_t vid)
     igraph_vector_int_destroy(&gtypes);
     igraph_vector_int_destroy(&vtypes);
     igraph_vector_int_destroy(&etypes);
+    return list;
+}
 
-    if (is_empty_object(attrs))
-        return val::undefined();
+// Attributes shown under "attributes"; the rest are top-level fields
+static bool is_listed_attribute(igraph_attribute_elemtype_t elemtype, const char *aname)
+{
+    if (elemtype == IGRAPH_ATTRIBUTE_VERTEX)
+        return !(eq(aname, "label") || eq(aname, "tableName") || eq(aname, "name"));
+    return !eq(aname, "weight");
+}
 
-    return attrs;
+// A typed store value as shown under "attributes", or undefined if missing
+static val typed_attribute_string(const AttributeColumn &column, igraph_integer_t id)
+{
+    switch (column.type)
+    {
+    case ATTRIBUTE_STRING:
+    {
+        const int32_t code = column.ints[id];
+        return code < 0 ? val::undefined() : val(column.dictionary[code]);
+    }
+    case ATTRIBUTE_BOOL:
+        return val(column.bools[id] ? "true" : "false");
+    case ATTRIBUTE_TIMESTAMP:
+    {
+        const double ms = column.numbers[id];
+        return std::isnan(ms) ? val::undefined() : val::global("Date").new_(ms).call<val>("toISOString");
+    }
+    default:
+    {
+        const double v = column.number(id);
+        return std::isnan(v) ? val::undefined() : val(to_str(v));
+    }
+    }
 }
 
-val edge_attributes_object(const igraph_t *g, igraph_integer_t eid)
+static val attributes_object(const igraph_t *g, igraph_attribute_elemtype_t elemtype, const AttributeList &list, const AttributeStore *store, igraph_integer_t id)
 {
-    igraph_strvector_t gnames, vnames, enames;
-    igraph_vector_int_t gtypes, vtypes, etypes;
+    const bool vertex = elemtype == IGRAPH_ATTRIBUTE_VERTEX;
+    val attrs = val::object();
+    bool empty = true;
 
-    igraph_strvector_init(&gnames, 0);
-    igraph_strvector_init(&vnames, 0);
-    igraph_strvector_init(&enames, 0);
-    igraph_vector_int_init(&gtypes, 0);
-    igraph_vector_int_init(&vtypes, 0);
-    igraph_vector_int_init(&etypes, 0);
+    for (size_t i = 0; i < list.names.size(); ++i)
+    {
+        const char *aname = list.names[i].c_str();
+        if (!is_listed_attribute(elemtype, aname))
+            continue;
 
-    val attrs = val::object();
+        empty = false;
+        switch (list.types[i])
+        {
+        case IGRAPH_ATTRIBUTE_NUMERIC:
+        {
+            double v = vertex ? VAN(g, aname, id) : EAN(g, aname, id);
+            attrs.set(aname, to_str(v));
+            break;
+        }
+        case IGRAPH_ATTRIBUTE_BOOLEAN:
+        {
+            int b = (int)(vertex ? VAB(g, aname, id) : EAB(g, aname, id));
+            attrs.set(aname, b ? "true" : "false");
+            break;
+        }
+        case IGRAPH_ATTRIBUTE_STRING:
+        {
+            const char *s = vertex ? VAS(g, aname, id) : EAS(g, aname, id);
+            attrs.set(aname, s ? std::string(s) : std::string(""));
+            break;
+        }
+        default:
+            attrs.set(aname, std::string(""));
+        }
+    }
 
-    if (igraph_cattribute_list(g, &gnames, &gtypes, &vnames, &vtypes, &enames, &etypes) == IGRAPH_SUCCESS)
+    if (store != NULL)
     {
-        long ne = igraph_strvector_size(&enames);
-        for (long i = 0; i < ne; ++i)
+        for (const auto &entry : *store)
         {
-            const char *aname = STR(enames, i);
-            if (eq(aname, "weight"))
+            val value = typed_attribute_string(entry.second, id);
+            if (value.isUndefined())
                 continue;
-
-            int atype = VECTOR(etypes)[i];
-            switch (atype)
-            {
-            case IGRAPH_ATTRIBUTE_NUMERIC:
-            {
-                double v = EAN(g, aname, eid);
-                attrs.set(aname, to_str(v));
-                break;
-            }
-            case IGRAPH_ATTRIBUTE_BOOLEAN:
-            {
-                int b = (int)EAB(g, aname, eid);
-                attrs.set(aname, b ? "true" : "false");
-                break;
-            }
-            case IGRAPH_ATTRIBUTE_STRING:
-            {
-                const char *s = EAS(g, aname, eid);
-                attrs.set(aname, s ? std::string(s) : std::string(""));
-                break;
-            }
-            default:
-                attrs.set(aname, std::string(""));
-            }
+            attrs.set(entry.first, value);
+            empty = false;
         }
     }
 
-    igraph_strvector_destroy(&gnames);
-    igraph_strvector_destroy(&vnames);
-    igraph_strvector_destroy(&enames);
-    igraph_vector_int_destroy(&gtypes);
-    igraph_vector_int_destroy(&vtypes);
-    igraph_vector_int_destroy(&etypes);
-
-    if (is_empty_object(attrs))
+    if (empty)
         return val::undefined();
 
     return attrs;
 }
 
-val graph_nodes(igraph_t *g)
+val graph_nodes(igraph_t *g, const AttributeStore *store)
 {
     val nodes = val::array();
-    std::string attr = igraph_check_attribute(g);
+    const AttributeList list = list_attributes(g, IGRAPH_ATTRIBUTE_VERTEX);
     for (igraph_integer_t i = 0; i < igraph_vcount(g); i++)
     {
         val n = val::object();
@@ -197,7 +229,7 @@ val graph_nodes(igraph_t *g)
         if (table)
             n.set("tableName", std::string(table));
 
-        val attrs = vertex_attributes_object(g, i);
+        val attrs = attributes_object(g, IGRAPH_ATTRIBUTE_VERTEX, list, store, i);
         if (!attrs.isUndefined())
             n.set("attributes", attrs);
 
@@ -206,10 +238,11 @@ val graph_nodes(igraph_t *g)
     return nodes;
 }
 
-val graph_edges(igraph_t *g)
+val graph_edges(igraph_t *g, const AttributeStore *store)
 {
     val edges = val::array();
-
+    const AttributeList list = list_attributes(g, IGRAPH_ATTRIBUTE_EDGE);
+    const bool weighted = igraph_cattribute_has_attr(g, IGRAPH_ATTRIBUTE_EDGE, "weight");
     for (igraph_integer_t i = 0; i < igraph_ecount(g); i++)
     {
         igraph_integer_t from, to;
@@ -219,13 +252,13 @@ val graph_edges(igraph_t *g)
         e.set("source", std::to_string(from));
         e.set("target", std::to_string(to));
 
-        if (igraph_cattribute_has_attr(g, IGRAPH_ATTRIBUTE_EDGE, "weight"))
+        if (weighted)
         {
             double w = EAN(g, "weight", i);
             e.set("weight", w);
         }
 
-        val attrs = edge_attributes_object(g, i);
+        val attrs = attributes_object(g, IGRAPH_ATTRIBUTE_EDGE, list, store, i);
         if (!attrs.isUndefined())
             e.set("attributes", attrs);
 
@@ -233,3 +266,158 @@ val graph_edges(igraph_t *g)
     }
     return edges;
 }
+
+// COLUMNAR EXPORT
+// One typed array per attribute instead of one object per vertex or edge:
+// numbers as Float64Array, booleans as Uint8Array and strings as UTF-8 bytes
+// plus Uint32Array offsets (value i is bytes[offsets[i], offsets[i + 1])).
+// Every attribute is read with a single igraph_cattribute_*V call, so the
+// cost is O(attributes + elements). Columns of the typed attribute store are
+// copied out as they are: int as Int32Array, timestamps as Float64Array (ms)
+// and strings as dictionary codes.
+
+static val string_column(const igraph_strvector_t *values)
+{
+    const igraph_integer_t n = igraph_strvector_size(values);
+    std::string bytes;
+    std::vector<uint32_t> offsets;
+    offsets.reserve(n + 1);
+    offsets.push_back(0);
+    for (igraph_integer_t i = 0; i < n; ++i)
+    {
+        bytes.append(igraph_strvector_get(values, i));
+        offsets.push_back(bytes.size());
+    }
+
+    val column = val::object();
+    column.set("type", "string");
+    column.set("offsets", val::global("Uint32Array").new_(typed_memory_view(offsets.size(), offsets.data())));
+    column.set("bytes", val::global("Uint8Array").new_(typed_memory_view(bytes.size(), reinterpret_cast<const uint8_t *>(bytes.data()))));
+    return column;
+}
+
+static val typed_column(const AttributeColumn &column)
+{
+    val result = val::object();
+    switch (column.type)
+    {
+    case ATTRIBUTE_FLOAT:
+        result.set("type", "number");
+        result.set("values", val::global("Float64Array").new_(typed_memory_view(column.numbers.size(), column.numbers.data())));
+        break;
+    case ATTRIBUTE_TIMESTAMP:
+        result.set("type", "timestamp");
+        result.set("values", val::global("Float64Array").new_(typed_memory_view(column.numbers.size(), column.numbers.data())));
+        break;
+    case ATTRIBUTE_INT:
+        result.set("type", "int");
+        result.set("values", val::global("Int32Array").new_(typed_memory_view(column.ints.size(), column.ints.data())));
+        break;
+    case ATTRIBUTE_BOOL:
+        result.set("type", "boolean");
+        result.set("values", val::global("Uint8Array").new_(typed_memory_view(column.bools.size(), column.bools.data())));
+        break;
+    case ATTRIBUTE_STRING:
+        result.set("type", "dictionary");
+        result.set("codes", val::global("Int32Array").new_(typed_memory_view(column.ints.size(), column.ints.data())));
+        result.set("dictionary", val::array(column.dictionary));
+        break;
+    }
+    return result;
+}
+
+static val attribute_columns(const igraph_t *g, igraph_attribute_elemtype_t elemtype, const AttributeStore *store)
+{
+    const bool vertex = elemtype == IGRAPH_ATTRIBUTE_VERTEX;
+    const AttributeList list = list_attributes(g, elemtype);
+    val columns = val::object();
+
+    for (size_t i = 0; i < list.names.size(); ++i)
+    {
+        const char *aname = list.names[i].c_str();
+        val column = val::object();
+        switch (list.types[i])
+        {
+        case IGRAPH_ATTRIBUTE_NUMERIC:
+        {
+            IGraphVector values;
+            if (vertex)
+                igraph_cattribute_VANV(g, aname, igraph_vss_all(), values.vec());
+            else
+                igraph_cattribute_EANV(g, aname, igraph_ess_all(IGRAPH_EDGEORDER_ID), values.vec());
+            column.set("type", "number");
+            column.set("values", val::global("Float64Array").new_(typed_memory_view(values.size(), VECTOR(*values.vec()))));
+            break;
+        }
+        case IGRAPH_ATTRIBUTE_BOOLEAN:
+        {
+            igraph_vector_bool_t values;
+            igraph_vector_bool_init(&values, 0);
+            if (vertex)
+                igraph_cattribute_VABV(g, aname, igraph_vss_all(), &values);
+            else
+                igraph_cattribute_EABV(g, aname, igraph_ess_all(IGRAPH_EDGEORDER_ID), &values);
+            std::vector<uint8_t> bytes(VECTOR(values), VECTOR(values) + igraph_vector_bool_size(&values));
+            igraph_vector_bool_destroy(&values);
+            column.set("type", "boolean");
+            column.set("values", val::global("Uint8Array").new_(typed_memory_view(bytes.size(), bytes.data())));
+            break;
+        }
+        case IGRAPH_ATTRIBUTE_STRING:
+        {
+            igraph_strvector_t values;
+            igraph_strvector_init(&values, 0);
+            if (vertex)
+                igraph_cattribute_VASV(g, aname, igraph_vss_all(), &values);
+            else
+                igraph_cattribute_EASV(g, aname, igraph_ess_all(IGRAPH_EDGEORDER_ID), &values);
+            column = string_column(&values);
+            igraph_strvector_destroy(&values);
+            break;
+        }
+        default:
+            continue;
+        }
+        columns.set(aname, column);
+    }
+
+    if (store != NULL)
+    {
+        for (const auto &entry : *store)
+            columns.set(entry.first, typed_column(entry.second));
+    }
+    return columns;
+}
+
+// { count, columns } with one column per vertex attribute, label and
+// tableName included
+val graph_node_columns(const igraph_t *g, const AttributeStore *store)
+{
+    val result = val::object();
+    result.set("count", static_cast<double>(igraph_vcount(g)));
+    result.set("columns", attribute_columns(g, IGRAPH_ATTRIBUTE_VERTEX, store));
+    return result;
+}
+
+// { count, sources, targets, columns } with the endpoints as Int32Arrays and
+// one column per edge attribute, weight included
+val graph_edge_columns(const igraph_t *g, const AttributeStore *store)
+{
+    const igraph_integer_t count = igraph_ecount(g);
+    IGraphVectorInt edgelist;
+    igraph_get_edgelist(g, edgelist.vec(), 0);
+
+    std::vector<int32_t> sources(count), targets(count);
+    for (igraph_integer_t i = 0; i < count; ++i)
+    {
+        sources[i] = VECTOR(*edgelist.vec())[2 * i];
+        targets[i] = VECTOR(*edgelist.vec())[2 * i + 1];
+    }
+
+    val result = val::object();
+    result.set("count", static_cast<double>(count));
+    result.set("sources", val::global("Int32Array").new_(typed_memory_view(sources.size(), sources.data())));
+    result.set("targets", val::global("Int32Array").new_(typed_memory_view(targets.size(), targets.data())));
+    result.set("columns", attribute_columns(g, IGRAPH_ATTRIBUTE_EDGE, store));
+    return result;
+}
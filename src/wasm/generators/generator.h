@@ -16,11 +16,14 @@ typedef std::unordered_map<std::string, int> NodeMap;
 
 using namespace emscripten;
 
-val graph_nodes(igraph_t *g);
-val graph_edges(igraph_t *g);
+// store adds the typed attributes of a resident graph, if given
+val graph_nodes(igraph_t *g, const AttributeStore *store = NULL);
+val graph_edges(igraph_t *g, const AttributeStore *store = NULL);
+val graph_node_columns(const igraph_t *g, const AttributeStore *store = NULL);
+val graph_edge_columns(const igraph_t *g, const AttributeStore *store = NULL);
 
 // Keep default ONLY in the header:
-void create_node(igraph_t *g,
+void create_node(ResidentGraph &rg,
                  igraph_integer_t id,
                  const char *label,
                  const char *tableName,
@@ -5,11 +5,13 @@
 
 using namespace emscripten;
 
-igraph_t globalGraph;
-igraph_vector_t globalWeights;
-
 static void igraph_error_handler(const char *reason, const char *file, int line, igraph_error_t igraph_errno)
 {
+    // The throw skips igraph's own cleanup, so free whatever the failing
+    // call has registered for it first
+    IGRAPH_FINALLY_FREE();
+    if (igraph_errno == IGRAPH_INTERRUPTED)
+        throw Cancelled();
     throw std::runtime_error(reason ? reason : "Unknown igraph error. Try again later.");
 }
 
@@ -17,6 +19,7 @@ __attribute__((constructor)) static void init_igraph_error_handler()
 {
     // Prints the same message igraph normally prints, but does NOT abort.
     igraph_set_error_handler(igraph_error_handler);
+    install_progress_handlers();
 }
 
 // The first graph to be rendered on the screen
@@ -24,7 +27,10 @@ val initRandomGraph(void)
 {
     igraph_set_attribute_table(&igraph_cattribute_table);
 
-    igraph_empty(&globalGraph, 10, IGRAPH_UNDIRECTED);
+    int handle = create_graph_handle();
+    ResidentGraph &rg = resident_graph(handle);
+    igraph_empty(&rg.graph, 10, IGRAPH_UNDIRECTED);
+    rg.initialized = true;
 
     const char *cityNames[10] = {
         "London", "Paris", "Berlin", "Rome", "Madrid",
@@ -42,40 +48,35 @@ val initRandomGraph(void)
     for (int i = 0; i < 10; i++)
     {
         val attrs = val::object();
-        attrs.set("latitude", std::to_string(lat[i]));
-        attrs.set("longitude", std::to_string(lon[i]));
-        attrs.set("population", std::to_string(population[i]));
+        attrs.set("latitude", lat[i]);
+        attrs.set("longitude", lon[i]);
+        attrs.set("population", population[i]);
 
-        // Create the node with label, tableName, and extra attributes
-        create_node(&globalGraph, i, cityNames[i], "City", attrs);
+        // Create the node with label, tableName, and extra (typed) attributes
+        create_node(rg, i, cityNames[i], "City", attrs);
     }
 
     // Create some edges to connect these cities in a network
-    igraph_add_edge(&globalGraph, 0, 1);
-    igraph_add_edge(&globalGraph, 0, 6);
-    igraph_add_edge(&globalGraph, 1, 7);
-    igraph_add_edge(&globalGraph, 1, 4);
-    igraph_add_edge(&globalGraph, 1, 3);
-    igraph_add_edge(&globalGraph, 1, 2);
-    igraph_add_edge(&globalGraph, 2, 6);
-    igraph_add_edge(&globalGraph, 2, 9);
-    igraph_add_edge(&globalGraph, 4, 8);
-    igraph_add_edge(&globalGraph, 5, 9);
-    igraph_add_edge(&globalGraph, 6, 7);
+    igraph_add_edge(&rg.graph, 0, 1);
+    igraph_add_edge(&rg.graph, 0, 6);
+    igraph_add_edge(&rg.graph, 1, 7);
+    igraph_add_edge(&rg.graph, 1, 4);
+    igraph_add_edge(&rg.graph, 1, 3);
+    igraph_add_edge(&rg.graph, 1, 2);
+    igraph_add_edge(&rg.graph, 2, 6);
+    igraph_add_edge(&rg.graph, 2, 9);
+    igraph_add_edge(&rg.graph, 4, 8);
+    igraph_add_edge(&rg.graph, 5, 9);
+    igraph_add_edge(&rg.graph, 6, 7);
 
     val result = val::object();
-    result.set("nodes", graph_nodes(&globalGraph));
-    result.set("edges", graph_edges(&globalGraph));
+    result.set("nodes", graph_nodes(&rg.graph, &rg.vertexAttributes));
+    result.set("edges", graph_edges(&rg.graph, &rg.edgeAttributes));
     result.set("directed", false);
+    result.set("handle", handle);
     return result;
 }
 
-void cleanupGraph(void)
-{
-    igraph_destroy(&globalGraph);
-    igraph_vector_destroy(&globalWeights);
-}
-
 void test()
 {
     // test an exception
@@ -83,126 +84,45 @@ void test()
     std::cout << "This is a test" << std::endl;
 }
 
+// Threads the parallel kernels run on: 1 in the single-threaded build
+unsigned thread_count(void)
+{
+    return TaskPool::instance().size();
+}
+
 val what_to_stderr(intptr_t ptr)
 {
     auto error = reinterpret_cast<std::runtime_error *>(ptr);
     return val(error->what());
 }
 
-void create_graph_from_kuzu_to_igraph(
-    igraph_integer_t nodes,
-    val src_js, // Int32Array
-    val dst_js, // Int32Array
-    igraph_bool_t directed,
-    val weight_js // Float64Array or undefined
-)
+// Columnar attribute export of the current graph, see generator.cpp
+static val node_columns(void)
 {
-    igraph_set_attribute_table(&igraph_cattribute_table);
-
-    static bool graph_initialized = false;
-    static bool weights_initialized = false;
-
-    if (graph_initialized)
-    {
-        igraph_destroy(&globalGraph);
-        graph_initialized = false;
-    }
-
-    igraph_error_t rc = igraph_empty(&globalGraph, nodes, directed ? IGRAPH_DIRECTED : IGRAPH_UNDIRECTED);
-    if (rc != IGRAPH_SUCCESS)
-    {
-        throw std::runtime_error(std::string("igraph_empty failed: ") + igraph_strerror(rc));
-    }
-    graph_initialized = true;
-
-    const int edge_count = src_js["length"].as<int>();
-
-    // Validate that source and destination arrays have the same length
-    const int dst_count = dst_js["length"].as<int>();
-    if (edge_count != dst_count)
-    {
-        igraph_destroy(&globalGraph);
-        graph_initialized = false;
-        throw std::runtime_error("Source and destination arrays must have the same length");
-    }
-
-    // Initialize edge vector for batch addition - USE igraph_vector_int_t
-    igraph_vector_int_t edge_vector;
-    rc = igraph_vector_int_init(&edge_vector, 0);
-    if (rc != IGRAPH_SUCCESS)
-    {
-        igraph_destroy(&globalGraph);
-        graph_initialized = false;
-        throw std::runtime_error(std::string("igraph_vector_int_init failed: ") + igraph_strerror(rc));
-    }
-
-    // Reserve space for all edges (2 * number of edges)
-    rc = igraph_vector_int_reserve(&edge_vector, 2 * edge_count);
-    if (rc != IGRAPH_SUCCESS)
-    {
-        igraph_vector_int_destroy(&edge_vector);
-        igraph_destroy(&globalGraph);
-        graph_initialized = false;
-        throw std::runtime_error(std::string("igraph_vector_int_reserve failed: ") + igraph_strerror(rc));
-    }
-
-    // Populate the edge vector with source and destination pairs
-    for (int i = 0; i < edge_count; i++)
-    {
-        const igraph_integer_t s = src_js[i].as<int>();
-        const igraph_integer_t t = dst_js[i].as<int>();
-
-        // Add bounds checking
-        if (s < 0 || s >= nodes || t < 0 || t >= nodes)
-        {
-            igraph_vector_int_destroy(&edge_vector);
-            igraph_destroy(&globalGraph);
-            graph_initialized = false;
-            throw std::runtime_error("Vertex index out of bounds");
-        }
-
-        igraph_vector_int_push_back(&edge_vector, s);
-        igraph_vector_int_push_back(&edge_vector, t);
-    }
+    return graph_node_columns(&currentGraph->graph, &currentGraph->vertexAttributes);
+}
 
-    // Add all edges to the graph in batch
-    rc = igraph_add_edges(&globalGraph, &edge_vector, 0);
-    if (rc != IGRAPH_SUCCESS)
-    {
-        igraph_vector_int_destroy(&edge_vector);
-        igraph_destroy(&globalGraph);
-        graph_initialized = false;
-        throw std::runtime_error(std::string("igraph_add_edges failed: ") + igraph_strerror(rc));
-    }
-    igraph_vector_int_destroy(&edge_vector);
+static val edge_columns(void)
+{
+    return graph_edge_columns(&currentGraph->graph, &currentGraph->edgeAttributes);
+}
 
-    if (weights_initialized)
-    {
-        igraph_vector_destroy(&globalWeights);
-        weights_initialized = false;
-    }
+// Wraps an algorithm so that its exported signature takes a graph handle as
+// the first argument and the algorithm runs against that graph, as one
+// cancellable run with its own progress
+template <auto Fn>
+struct OnGraph;
 
-    if (!weight_js.isUndefined() && !weight_js.isNull())
+template <typename R, typename... Args, R (*Fn)(Args...)>
+struct OnGraph<Fn>
+{
+    static R call(int handle, Args... args)
     {
-        const int weight_count = weight_js["length"].as<int>();
-        rc = igraph_vector_init(&globalWeights, edge_count);
-        if (rc != IGRAPH_SUCCESS)
-        {
-            igraph_destroy(&globalGraph);
-            graph_initialized = false;
-            throw std::runtime_error(std::string("igraph_vector_init failed: ") + igraph_strerror(rc));
-        }
-        weights_initialized = true;
-
-        for (int i = 0; i < edge_count; i++)
-        {
-            double w = (i < weight_count) ? weight_js[i].as<double>() : 0.0;
-            VECTOR(globalWeights)
-            [i] = w;
-        }
-        igraph_cattribute_EAN_setv(&globalGraph, "weight", &globalWeights);
+        GraphScope scope(handle);
+        ProgressScope progress;
+        return Fn(args...);
     }
-}
+};
 
 EMSCRIPTEN_BINDINGS(graph)
 {
@@ -212,46 +132,81 @@ EMSCRIPTEN_BINDINGS(graph)
     function("initRandomGraph", &initRandomGraph);
     function("test", &test);
     function("what_to_stderr", &what_to_stderr);
+    function("thread_count", &thread_count);
+    function("progress_view", &progress_view);
+    function("cancel_view", &cancel_view);
+    function("set_progress_callback", &set_progress_callback);
+    function("request_cancel", &request_cancel);
+    function("clear_cancel", &clear_cancel);
+
+    function("dijkstra_source_to_target", &OnGraph<&dijkstra_source_to_target>::call);
+    function("dijkstra_source_to_all", &OnGraph<&dijkstra_source_to_all>::call);
+    function("astar_source_to_target", &OnGraph<&astar_source_to_target>::call);
+    function("build_shortest_path_index", &OnGraph<&build_shortest_path_index>::call);
+    function("shortest_path_pairs", &OnGraph<&shortest_path_pairs>::call);
+    function("yen_source_to_target", &OnGraph<&yen_source_to_target>::call);
+    function("bellman_ford_source_to_target", &OnGraph<&bf_source_to_target>::call);
+    function("bellman_ford_source_to_all", &OnGraph<&bf_source_to_all>::call);
+    function("bfs", &OnGraph<&bfs>::call);
+    function("dfs", &OnGraph<&dfs>::call);
+    function("random_walk", &OnGraph<&randomWalk>::call);
+    function("min_spanning_tree", &OnGraph<&min_spanning_tree>::call);
+
+    function("betweenness_centrality", &OnGraph<&betweenness_centrality>::call);
+    function("approximate_betweenness", &OnGraph<&approximate_betweenness>::call);
+    function("closeness_centrality", &OnGraph<&closeness_centrality>::call);
+    function("degree_centrality", &OnGraph<&degree_centrality>::call);
+    function("eigenvector_centrality", &OnGraph<&eigenvector_centrality>::call);
+    function("strength_centrality", &OnGraph<&strength>::call);
+    function("harmonic_centrality", &OnGraph<&harmonic_centrality>::call);
+    function("pagerank", &OnGraph<&pagerank>::call);
+    function("katz_centrality", &OnGraph<&katz_centrality>::call);
+    function("hits", &OnGraph<&hits>::call);
+    function("personalized_pagerank", &OnGraph<&personalized_pagerank>::call);
+
+    function("louvain", &OnGraph<&louvain>::call);
+    function("leiden", &OnGraph<&leiden>::call);
+    function("fast_greedy", &OnGraph<&fast_greedy>::call);
+    function("label_propagation", &OnGraph<&label_propagation>::call);
+    function("local_clustering_coefficient", &OnGraph<&local_clustering_coefficient>::call);
+    function("k_core", &OnGraph<&k_core>::call);
+    function("triangle_count", &OnGraph<&triangles>::call);
+    function("strongly_connected_components", &OnGraph<&strongly_connected_components>::call);
+    function("weakly_connected_components", &OnGraph<&weakly_connected_components>::call);
+
+    function("vertices_are_adjacent", &OnGraph<&vertices_are_adjacent>::call);
+    function("jaccard_similarity", &OnGraph<&jaccard_similarity>::call);
+    function("topological_sort", &OnGraph<&topological_sort>::call);
+    function("diameter", &OnGraph<&diameter>::call);
+    function("eulerian_path", &OnGraph<&eulerian_path>::call);
+    function("eulerian_circuit", &OnGraph<&eulerian_circuit>::call);
+    function("missing_edge_prediction_default_values", &OnGraph<&missing_edge_prediction_default_values>::call);
+    function("missing_edge_prediction", &OnGraph<&missing_edge_prediction>::call);
+
+    function("graph_node_columns", &OnGraph<&node_columns>::call);
+    function("graph_edge_columns", &OnGraph<&edge_columns>::call);
 
-    function("dijkstra_source_to_target", &dijkstra_source_to_target);
-    function("dijkstra_source_to_all", &dijkstra_source_to_all);
-    function("yen_source_to_target", &yen_source_to_target);
-    function("bellman_ford_source_to_target", &bf_source_to_target);
-    function("bellman_ford_source_to_all", &bf_source_to_all);
     function("cleanupGraph", &cleanupGraph);
-    function("bfs", &bfs);
-    function("dfs", &dfs);
-    function("random_walk", &randomWalk);
-    function("min_spanning_tree", &min_spanning_tree);
-
-    function("betweenness_centrality", &betweenness_centrality);
-    function("closeness_centrality", &closeness_centrality);
-    function("degree_centrality", &degree_centrality);
-    function("eigenvector_centrality", &eigenvector_centrality);
-    function("strength_centrality", &strength);
-    function("harmonic_centrality", &harmonic_centrality);
-    function("pagerank", &pagerank);
-
-    function("louvain", &louvain);
-    function("leiden", &leiden);
-    function("fast_greedy", &fast_greedy);
-    function("label_propagation", &label_propagation);
-    function("local_clustering_coefficient", &local_clustering_coefficient);
-    function("k_core", &k_core);
-    function("triangle_count", &triangles);
-    function("strongly_connected_components", &strongly_connected_components);
-    function("weakly_connected_components", &weakly_connected_components);
-
-    function("vertices_are_adjacent", &vertices_are_adjacent);
-    function("jaccard_similarity", &jaccard_similarity);
-    function("topological_sort", &topological_sort);
-    function("diameter", &diameter);
-    function("eulerian_path", &eulerian_path);
-    function("eulerian_circuit", &eulerian_circuit);
-    function("missing_edge_prediction_default_values", &missing_edge_prediction_default_values);
-    function("missing_edge_prediction", &missing_edge_prediction);
-
+    function("create_graph_handle", &create_graph_handle);
+    function("release_graph_handle", &release_graph_handle);
+    function("create_induced_subgraph", &create_induced_subgraph);
+    function("create_undirected_projection", &create_undirected_projection);
+    function("vertex_name_table", &vertex_name_table);
+    function("import_attributes", &import_attributes);
+    function("attribute_column", &attribute_column);
+    function("drop_attribute", &drop_attribute);
+    function("set_weight_attribute", &set_weight_attribute);
+    function("filter_by_attribute", &filter_by_attribute);
+    function("set_vertex_order", &set_vertex_order);
+    function("vertex_order_stats", &vertex_order_stats);
     function("create_graph_from_kuzu_to_igraph", &create_graph_from_kuzu_to_igraph);
+    function("ingest_buffers", &ingest_buffers);
+    function("create_graph_from_ingest_buffers", &create_graph_from_ingest_buffers);
+    function("graph_is_resident", &graph_is_resident);
+    function("add_vertices", &add_vertices);
+    function("add_edges", &add_edges);
+    function("delete_edges", &delete_edges);
+    function("delete_vertices", &delete_vertices);
 }
 
 // emcc demo.cpp -O3 -s WASM=1 -s -sEXPORTED_FUNCTIONS=_sum,_subtract --no-entry -o demo.wasm
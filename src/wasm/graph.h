@@ -2,6 +2,9 @@
 #define GRAPH_H
 
 #include "igraph_wrappers.h"
+#include "task_pool.h"
+#include "progress.h"
+#include "csr.h"
 #include <emscripten/val.h>
 #include <emscripten/bind.h>
 #include <vector>
@@ -10,10 +13,94 @@
 #include <iomanip>
 #include <unordered_map>
 #include <unordered_set>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <cmath>
 
-// #define N 11 // number of nodes
-extern igraph_t globalGraph;          // igraph structure
-extern igraph_vector_t globalWeights; // edge weights
+// Vertex names of a resident graph, built on first use and shared by every
+// algorithm run on it. The names are stored back to back in `chars`, vertex
+// v's name being chars[offsets[v], offsets[v + 1]). Graphs without a "label"
+// or "id" attribute are numeric: each vertex is named by its ID and nothing
+// is stored.
+struct VertexNames
+{
+    bool numeric = true;
+    std::string chars;
+    std::vector<uint32_t> offsets;
+};
+
+// Typed attribute columns kept next to a resident graph (see attributes.cpp).
+// A column holds one value per vertex or edge in a contiguous array, so a
+// numeric attribute costs 8 bytes per element instead of a heap-allocated
+// string per element as with SETVAS.
+enum AttributeType
+{
+    ATTRIBUTE_INT,       // int32
+    ATTRIBUTE_FLOAT,     // double
+    ATTRIBUTE_BOOL,      // uint8, 0 or 1
+    ATTRIBUTE_TIMESTAMP, // double, milliseconds since the epoch as in JS Date
+    ATTRIBUTE_STRING     // int32 codes into a dictionary of distinct values
+};
+
+struct AttributeColumn
+{
+    AttributeType type = ATTRIBUTE_FLOAT;
+    std::vector<double> numbers;         // FLOAT and TIMESTAMP, NaN if missing
+    std::vector<int32_t> ints;           // INT, and STRING codes (-1 if missing)
+    std::vector<uint8_t> bools;          // BOOL
+    std::vector<std::string> dictionary; // STRING
+
+    size_t size(void) const;
+    void resize(size_t n);                      // new elements get the missing value
+    void compact(const std::vector<bool> &keep); // drops elements, keeping the order
+    double number(size_t i) const;              // value of a non-STRING column as a double
+};
+
+typedef std::map<std::string, AttributeColumn> AttributeStore;
+
+// A graph held resident by the module. JS addresses it through an integer
+// handle, so several graphs (e.g. both orientations of a snapshot, a k-core
+// subgraph or a filtered view) can be kept at the same time.
+struct ResidentGraph
+{
+    igraph_t graph;               // igraph structure
+    igraph_vector_t weights = {}; // edge weights, VECTOR(weights) is NULL when unweighted
+    igraph_integer_t version = -1; // snapshot version, -1 if built without one
+    bool initialized = false;
+    std::unique_ptr<VertexNames> names; // NULL until first needed, dropped when vertices change
+    AttributeStore vertexAttributes, edgeAttributes;
+    std::string weightAttribute;    // float edge column used as weights, "" for `weights`
+    igraph_vector_t weightView = {}; // view over that column, refreshed by GraphScope
+    std::unique_ptr<CsrGraph> csr;   // NULL until first needed, dropped when edges or weights change
+    VertexOrder vertexOrder = ORDER_NONE;  // numbering of the CSR rows, kept across rebuilds
+    double reorderMs = 0;                  // total time spent reordering this graph, cleared by reset()
+    std::map<std::string, KernelTime> kernelTime[ORDER_COUNT]; // CSR kernel time by kernel, under each order, cleared by reset()
+
+    ResidentGraph() = default;
+    ResidentGraph(const ResidentGraph &) = delete;
+    ResidentGraph &operator=(const ResidentGraph &) = delete;
+    ~ResidentGraph();
+
+    void reset(void);
+};
+
+// The graph the running algorithm operates on. Exported algorithms take a
+// handle as their first argument and the bindings select it with a GraphScope.
+extern ResidentGraph *currentGraph;
+
+ResidentGraph &resident_graph(int handle);
+
+// RAII guard making the graph behind a handle current for its lifetime
+class GraphScope
+{
+public:
+    explicit GraphScope(int handle);
+    ~GraphScope();
+
+private:
+    ResidentGraph *previous;
+};
 
 #define MODE_COLOR_IMPORTANT 1     // Dark for important, light for less important
 #define MODE_COLOR_SHADE_DEFAULT 2 // Multiple purple shades
@@ -25,32 +112,223 @@ using namespace emscripten;
 
 val initGraph(void);
 void cleanupGraph(void);
+int create_graph_handle(void);
+void release_graph_handle(int handle);
+bool graph_is_resident(int handle, igraph_integer_t version, igraph_bool_t directed);
+void create_graph_from_kuzu_to_igraph(int handle, igraph_integer_t nodes, val src_js, val dst_js, igraph_bool_t directed, val weight_js);
+val ingest_buffers(igraph_integer_t edge_count, igraph_bool_t weighted);
+void create_graph_from_ingest_buffers(int handle, igraph_integer_t nodes, igraph_bool_t directed, igraph_integer_t version);
+val create_induced_subgraph(int handle, val vids_js);
+void create_undirected_projection(int handle, int target, std::string weight_merge);
+
+AttributeStore &attribute_store(ResidentGraph &rg, const std::string &kind);
+AttributeColumn &typed_attribute(AttributeStore &store, const std::string &name, AttributeType type, size_t count);
+void set_typed_attribute(AttributeColumn &column, size_t i, val value);
+void resize_attributes(AttributeStore &store, size_t count);
+void compact_attributes(AttributeStore &store, const std::vector<bool> &keep);
+void refresh_weight_view(ResidentGraph &rg);
+void import_attributes(int handle, std::string kind, val columns);
+val attribute_column(int handle, std::string kind, std::string name);
+void drop_attribute(int handle, std::string kind, std::string name);
+void set_weight_attribute(int handle, std::string name);
+val filter_by_attribute(int handle, std::string kind, std::string name, double min, double max);
+
+val progress_view(void);
+val cancel_view(void);
+void set_progress_callback(val fn);
+void request_cancel(void);
+void clear_cancel(void);
+
+igraph_integer_t add_vertices(int handle, igraph_integer_t count, igraph_integer_t version);
+void add_edges(int handle, val src_js, val dst_js, val weight_js, igraph_integer_t version);
+void delete_edges(int handle, val eids_js, igraph_integer_t version);
+val delete_vertices(int handle, val vids_js, igraph_integer_t version);
 
 std::string igraph_check_attribute(const igraph_t *graph);
 igraph_error_t igraph_init_copy(igraph_t *to, const igraph_t *from);
 std::string igraph_get_name(igraph_integer_t v);
+const VertexNames &vertex_names(ResidentGraph &rg);
+val vertex_name(igraph_integer_t v);
+val vertex_name_table(int handle);
 igraph_vector_t *igraph_weights(void);
 
+// CSR snapshot of the current graph with its current weights, see csr.h
+std::unique_ptr<CsrGraph> build_csr(const igraph_t *g, const igraph_vector_t *weights, VertexOrder order = ORDER_NONE);
+const CsrGraph &graph_csr(void);
+void set_vertex_order(int handle, std::string order);
+val vertex_order_stats(int handle);
+
+// Adds its lifetime to the current graph's time for the named kernel under
+// the snapshot's vertex order, for vertex_order_stats()
+class KernelTimer
+{
+public:
+    KernelTimer(const CsrGraph &csr, const char *kernel);
+    ~KernelTimer();
+
+private:
+    const char *kernel;
+    VertexOrder order;
+    std::chrono::steady_clock::time_point started;
+};
+
+// Highlight data of a result as typed arrays instead of colorMap entries with
+// "from-to" string keys: vertex IDs and edge endpoints, each with its value.
+// Setting the same vertex or edge again overrides the earlier value, as with
+// colorMap.
+class HighlightBuffer
+{
+public:
+    void vertex(igraph_integer_t v, double value);
+    void edge(igraph_integer_t from, igraph_integer_t to, double value);
+    val to_val(void) const;
+
+private:
+    std::vector<int32_t> vertices, edgeSources, edgeTargets;
+    std::vector<double> vertexValues, edgeValues;
+};
+
 void frequenciesToColorMap(std::unordered_map<int, int> fm, val &colorMap);
+void frequenciesToColorMap(std::unordered_map<int, int> fm, HighlightBuffer &highlight);
 void doublesToColorMap(std::unordered_map<int, double> dm, val &colorMap);
 
+// Point-to-point shortest path from the routing kernels (algorithms/routing.cpp)
+struct PathSearch
+{
+    double distance = INFINITY;    // INFINITY if the target is unreachable
+    std::vector<int32_t> vertices; // igraph IDs from source to target, empty if unreachable
+    std::vector<int32_t> edges;    // igraph edge IDs along the path
+    size_t settled = 0;            // vertices taken off the queue(s)
+};
+
+// BFS levels from one source: level k is order[layerStarts[k],
+// layerStarts[k + 1]), in igraph IDs sorted within the level; bottomUp[k]
+// tells whether level k was found by a bottom-up step
+struct BfsLayers
+{
+    std::vector<int32_t> order, layerStarts;
+    std::vector<char> bottomUp;
+};
+
+// Single-source shortest paths as a tree, indexed by igraph vertex ID
+// (-1 and INFINITY where there is no predecessor or path)
+struct SourceTree
+{
+    std::vector<double> distances;
+    std::vector<int32_t> pred, predEdge;
+    double delta = 0;   // bucket width used
+    size_t phases = 0;  // frontiers relaxed
+    size_t relaxed = 0; // edge relaxations, counting repeats
+    size_t reached = 0;
+};
+
+// Shortest paths for a batch of (source, target) pairs. Path i spans
+// vertices[vertexOffsets[i], vertexOffsets[i + 1]) and
+// edges[edgeOffsets[i], edgeOffsets[i + 1]), in igraph IDs; the offsets are
+// only filled when paths are asked for.
+struct PairPaths
+{
+    std::vector<double> distances; // by pair, INFINITY if unreachable
+    std::vector<int32_t> vertexOffsets, vertices, edgeOffsets, edges;
+    size_t sources = 0; // distinct sources, one search each
+    size_t settled = 0;
+};
+
+void dijkstra_distances(const EdgeRows &rows, int32_t source, double *dist);
+PathSearch bidirectional_dijkstra(const CsrGraph &csr, int32_t source, int32_t target);
+const Landmarks &graph_landmarks(const CsrGraph &csr, int count, bool &built);
+PathSearch alt_search(const CsrGraph &csr, const Landmarks &landmarks, int32_t source, int32_t target);
+const ContractionHierarchy &graph_hierarchy(const CsrGraph &csr, bool &built);
+PathSearch hierarchy_search(const CsrGraph &csr, const ContractionHierarchy &hierarchy, int32_t source, int32_t target);
+val build_shortest_path_index(void);
+PairPaths many_pairs(const CsrGraph &csr, const std::vector<int32_t> &sources, const std::vector<int32_t> &targets, bool paths);
+val shortest_path_pairs(val sources_js, val targets_js, bool paths);
+double delta_stepping_width(const CsrGraph &csr);
+SourceTree delta_stepping(const CsrGraph &csr, int32_t source, double delta);
+BfsLayers direction_optimizing_bfs(const CsrGraph &csr, int32_t source);
+
 val dijkstra_source_to_target(igraph_integer_t src, igraph_integer_t tar);
-val dijkstra_source_to_all(igraph_integer_t src);
+val dijkstra_source_to_all(igraph_integer_t src, bool tree);
+val astar_source_to_target(igraph_integer_t src, igraph_integer_t tar, int landmarks);
 val yen_source_to_target(igraph_integer_t src, igraph_integer_t tar, igraph_integer_t k);
 val bf_source_to_target(igraph_integer_t src, igraph_integer_t tar);
-val bf_source_to_all(igraph_integer_t src);
+val bf_source_to_all(igraph_integer_t src, bool tree);
 val bfs(igraph_integer_t src);
 val dfs(igraph_integer_t src);
 val randomWalk(igraph_integer_t start, int steps);
 val min_spanning_tree(void);
 
-val betweenness_centrality(void);
-val closeness_centrality(void);
-val degree_centrality(void);
-val eigenvector_centrality(void);
-val harmonic_centrality(void);
-val strength(void);
-val pagerank(igraph_real_t damping);
+// How sampled_betweenness() arrived at its estimate
+struct BetweennessSample
+{
+    size_t samples = 0;        // shortest paths drawn, 0 if the exact scores were cheaper
+    size_t vertexDiameter = 0; // bound on the vertices of a shortest path used for the sample size
+    double errorBound = 0;     // achieved bound on the error of the normalized scores
+    bool exact = false;
+};
+
+std::vector<double> parallel_betweenness(const CsrGraph &csr);
+std::vector<double> sampled_betweenness(const CsrGraph &csr, double epsilon, double delta, uint64_t seed, BetweennessSample &info);
+val betweenness_centrality(bool columnar);
+val approximate_betweenness(double epsilon, double delta, double seed, bool columnar);
+// Per-source unweighted out-distance sums over the vertices each source
+// reaches, from bfs_distance_sums() (see algorithms/msbfs.h)
+struct DistanceSums
+{
+    std::vector<double> total;    // sum of distances
+    std::vector<double> inverse;  // sum of reciprocal distances
+    std::vector<int32_t> reached; // vertices reached, the source included
+};
+
+DistanceSums bfs_distance_sums(const CsrGraph &csr);
+val closeness_centrality(bool columnar);
+val degree_centrality(bool columnar);
+val harmonic_centrality(bool columnar);
+val strength(bool columnar);
+
+// Parameters of the power iteration kernels (algorithms/spectral.cpp). An
+// empty start continues from the kernel's last result on the same snapshot,
+// or from a uniform vector; otherwise it holds one non-negative value per
+// vertex, indexed by igraph ID.
+struct SpectralOptions
+{
+    double tolerance = 1e-10; // on the relative L1 change of an iteration
+    int maxIterations = 1000;
+    std::vector<double> start;
+};
+
+struct SpectralResult
+{
+    std::vector<double> scores; // by igraph ID, authorities for HITS
+    std::vector<double> hubs;   // HITS only
+    double value = 0;           // dominant eigenvalue, 1 for PageRank and Katz
+    int iterations = 0;
+    double residual = 0; // relative L1 change of the last iteration
+    bool converged = false;
+    bool warmStarted = false; // started from the previous result
+    std::string warning;      // set when the scores are a degenerate case
+};
+
+SpectralResult spectral_pagerank(const CsrGraph &csr, double damping, const SpectralOptions &options);
+SpectralResult spectral_eigenvector(const CsrGraph &csr, const SpectralOptions &options);
+SpectralResult spectral_katz(const CsrGraph &csr, double alpha, double beta, const SpectralOptions &options);
+SpectralResult spectral_hits(const CsrGraph &csr, const SpectralOptions &options);
+// Sparse result of personalized_push(): the top vertices by estimate
+struct PushEstimate
+{
+    std::vector<int32_t> vertices; // igraph IDs, by decreasing score
+    std::vector<double> scores;
+    size_t pushes = 0;   // push operations performed
+    size_t touched = 0;  // vertices that received any probability mass
+    double residual = 0; // mass left unpushed, a bound on the L1 error
+};
+
+PushEstimate personalized_push(const CsrGraph &csr, const std::vector<int32_t> &seeds, double damping, double epsilon, size_t k);
+val pagerank(igraph_real_t damping, bool columnar, val options);
+val eigenvector_centrality(bool columnar, val options);
+val katz_centrality(double alpha, double beta, bool columnar, val options);
+val hits(bool columnar, val options);
+val personalized_pagerank(val seeds_js, double damping, double epsilon, int k);
 
 val louvain(igraph_real_t resolution);
 val leiden(igraph_real_t resolution);
@@ -198,4 +198,27 @@ private:
     igraph_matrix_t m;
 };
 
+// RAII wrapper for igraph_hrg_t
+class IGraphHrg
+{
+public:
+    IGraphHrg()
+    {
+        igraph_hrg_init(&h, 0);
+    }
+
+    ~IGraphHrg()
+    {
+        igraph_hrg_destroy(&h);
+    }
+
+    igraph_hrg_t *hrg()
+    {
+        return &h;
+    }
+
+private:
+    igraph_hrg_t h;
+};
+
 #endif
\ No newline at end of file
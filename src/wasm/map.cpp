@@ -2,6 +2,9 @@
 
 void frequenciesToColorMap(std::unordered_map<int, int> fm, val &colorMap)
 {
+    if (fm.empty())
+        return;
+
     auto max_it = std::max_element(fm.begin(), fm.end(), [](const std::pair<int, int> &p1, const std::pair<int, int> &p2)
                                    { return p1.second < p2.second; });
     int max_freq = max_it->second;
@@ -16,6 +19,22 @@ void frequenciesToColorMap(std::unordered_map<int, int> fm, val &colorMap)
     }
 }
 
+void frequenciesToColorMap(std::unordered_map<int, int> fm, HighlightBuffer &highlight)
+{
+    // Nothing reached (e.g. an isolated source): no maximum to scale by
+    if (fm.empty())
+        return;
+
+    auto max_it = std::max_element(fm.begin(), fm.end(), [](const std::pair<int, int> &p1, const std::pair<int, int> &p2)
+                                   { return p1.second < p2.second; });
+    int max_freq = max_it->second;
+
+    for (auto &pair : fm)
+    {
+        highlight.vertex(pair.first, static_cast<double>(pair.second) / max_freq);
+    }
+}
+
 void doublesToColorMap(std::unordered_map<int, double> dm, val &colorMap)
 {
     double max = 0.0;
@@ -31,4 +50,27 @@ void doublesToColorMap(std::unordered_map<int, double> dm, val &colorMap)
         double scaled = value / max;
         colorMap.set(node, scaled);
     }
-}
\ No newline at end of file
+}
+void HighlightBuffer::vertex(igraph_integer_t v, double value)
+{
+    vertices.push_back(v);
+    vertexValues.push_back(value);
+}
+
+void HighlightBuffer::edge(igraph_integer_t from, igraph_integer_t to, double value)
+{
+    edgeSources.push_back(from);
+    edgeTargets.push_back(to);
+    edgeValues.push_back(value);
+}
+
+val HighlightBuffer::to_val(void) const
+{
+    val highlight = val::object();
+    highlight.set("vertices", val::global("Int32Array").new_(typed_memory_view(vertices.size(), vertices.data())));
+    highlight.set("vertexValues", val::global("Float64Array").new_(typed_memory_view(vertexValues.size(), vertexValues.data())));
+    highlight.set("edgeSources", val::global("Int32Array").new_(typed_memory_view(edgeSources.size(), edgeSources.data())));
+    highlight.set("edgeTargets", val::global("Int32Array").new_(typed_memory_view(edgeTargets.size(), edgeTargets.data())));
+    highlight.set("edgeValues", val::global("Float64Array").new_(typed_memory_view(edgeValues.size(), edgeValues.data())));
+    return highlight;
+}
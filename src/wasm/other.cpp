@@ -1,5 +1,6 @@
 #include "graph.h"
 #include <iostream>
+#include <memory>
 
 // contains my own custom igraph functions
 
@@ -45,21 +46,85 @@ igraph_error_t igraph_init_copy(igraph_t *to, const igraph_t *from)
     return ret;
 }
 
+// Builds the name table of a graph once; later calls reuse it until the
+// vertex set changes
+const VertexNames &vertex_names(ResidentGraph &rg)
+{
+    if (rg.names)
+        return *rg.names;
+
+    auto names = std::make_unique<VertexNames>();
+    std::string attr = igraph_check_attribute(&rg.graph);
+    if (!attr.empty())
+    {
+        igraph_strvector_t values;
+        igraph_strvector_init(&values, 0);
+        igraph_cattribute_VASV(&rg.graph, attr.c_str(), igraph_vss_all(), &values);
+
+        const igraph_integer_t n = igraph_strvector_size(&values);
+        names->numeric = false;
+        names->offsets.reserve(n + 1);
+        names->offsets.push_back(0);
+        for (igraph_integer_t v = 0; v < n; ++v)
+        {
+            names->chars.append(igraph_strvector_get(&values, v));
+            names->offsets.push_back(names->chars.size());
+        }
+        igraph_strvector_destroy(&values);
+    }
+
+    rg.names = std::move(names);
+    return *rg.names;
+}
+
 std::string igraph_get_name(igraph_integer_t v)
 {
-    std::string attr = igraph_check_attribute(&globalGraph);
-    if (attr.empty())
+    const VertexNames &names = vertex_names(*currentGraph);
+    if (names.numeric)
     {
         return std::to_string(v);
     }
-    else
+    return names.chars.substr(names.offsets[v], names.offsets[v + 1] - names.offsets[v]);
+}
+
+// Name of a vertex of the current graph as it goes into a result. Graphs
+// without name attributes yield the integer ID itself, leaving the caller to
+// resolve it (the TS side maps IDs back to Kuzu nodes anyway).
+val vertex_name(igraph_integer_t v)
+{
+    const VertexNames &names = vertex_names(*currentGraph);
+    if (names.numeric)
+    {
+        return val(static_cast<double>(v));
+    }
+    return val(names.chars.substr(names.offsets[v], names.offsets[v + 1] - names.offsets[v]));
+}
+
+// Exports the whole name table at once: the UTF-8 bytes of all names and an
+// offsets array with one more entry than there are vertices. Numeric graphs
+// return null.
+val vertex_name_table(int handle)
+{
+    ResidentGraph &rg = resident_graph(handle);
+    if (!rg.initialized)
     {
-        return VAS(&globalGraph, attr.c_str(), v);
+        throw std::runtime_error("Graph handle " + std::to_string(handle) + " does not hold a graph yet");
     }
+
+    const VertexNames &names = vertex_names(rg);
+    if (names.numeric)
+        return val::null();
+
+    val table = val::object();
+    table.set("chars", val::global("Uint8Array").new_(typed_memory_view(names.chars.size(), reinterpret_cast<const uint8_t *>(names.chars.data()))));
+    table.set("offsets", val::global("Uint32Array").new_(typed_memory_view(names.offsets.size(), names.offsets.data())));
+    return table;
 }
 
 igraph_vector_t *igraph_weights()
 {
-    bool hasWeights = VECTOR(globalWeights) != NULL;
-    return hasWeights ? &globalWeights : NULL;
+    if (!currentGraph->weightAttribute.empty())
+        return &currentGraph->weightView;
+    bool hasWeights = VECTOR(currentGraph->weights) != NULL;
+    return hasWeights ? &currentGraph->weights : NULL;
 }
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "graph.h"
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+using namespace emscripten;
+
+// Shared with JS: [percent, elapsed ms, ETA ms (NaN until known), running]
+alignas(8) static double progressCells[4] = {0, 0, NAN, 0};
+static std::atomic<int32_t> cancelFlag{0};
+
+static std::mutex reportMutex;
+static std::chrono::steady_clock::time_point started;
+static std::thread::id runner;
+static int scopeDepth = 0; // only touched by the running thread
+static val *callback = NULL;
+static int callbackPercent = -1;
+static double callbackTime = 0;
+
+// The callback runs on every whole percent, and at least every
+// CALLBACK_INTERVAL_MS while igraph checks for interruption, which it does
+// far more often than it reports progress (the clock is read every
+// INTERRUPTION_POLL-th check)
+#define CALLBACK_INTERVAL_MS 100
+#define INTERRUPTION_POLL 1024
+
+static double elapsed_ms(void)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+}
+
+// Runs the JS callback on the thread that started the run; a true result
+// requests cancellation
+static void notify(double percent, const char *message)
+{
+    if (!callback || std::this_thread::get_id() != runner)
+        return;
+    const int whole = static_cast<int>(percent);
+    const double now = progressCells[1];
+    if (whole == callbackPercent && now - callbackTime < CALLBACK_INTERVAL_MS)
+        return;
+    callbackPercent = whole;
+    callbackTime = now;
+
+    val cancel = (*callback)(percent, progressCells[2], std::string(message ? message : ""));
+    if (cancel.isTrue())
+        cancelFlag = 1;
+}
+
+ProgressScope::ProgressScope()
+{
+    if (scopeDepth++ > 0)
+        return;
+    std::lock_guard<std::mutex> lock(reportMutex);
+    started = std::chrono::steady_clock::now();
+    runner = std::this_thread::get_id();
+    callbackPercent = -1;
+    callbackTime = 0;
+    progressCells[0] = 0;
+    progressCells[1] = 0;
+    progressCells[2] = NAN;
+    progressCells[3] = 1;
+}
+
+ProgressScope::~ProgressScope()
+{
+    if (--scopeDepth > 0)
+        return;
+    std::lock_guard<std::mutex> lock(reportMutex);
+    progressCells[1] = elapsed_ms();
+    progressCells[3] = 0;
+}
+
+void report_progress(double percent, const char *message)
+{
+    {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        percent = std::min(100.0, std::max(percent, progressCells[0]));
+        const double elapsed = elapsed_ms();
+        progressCells[0] = percent;
+        progressCells[1] = elapsed;
+        progressCells[2] = percent > 0 ? elapsed * (100 - percent) / percent : NAN;
+    }
+    notify(percent, message);
+}
+
+bool cancel_requested(void)
+{
+    return cancelFlag.load(std::memory_order_relaxed) != 0;
+}
+
+void throw_if_cancelled(void)
+{
+    if (cancel_requested())
+        throw Cancelled();
+}
+
+void ProgressCounter::add(size_t items)
+{
+    const size_t before = done.fetch_add(items);
+    if (total > 0 && (before * 100) / total != ((before + items) * 100) / total)
+        report_progress(100.0 * (before + items) / total);
+    throw_if_cancelled();
+}
+
+static igraph_error_t igraph_progress_handler(const char *message, igraph_real_t percent, void *)
+{
+    report_progress(percent, message);
+    return cancel_requested() ? IGRAPH_INTERRUPTED : IGRAPH_SUCCESS;
+}
+
+static igraph_error_t igraph_interruption_handler(void *)
+{
+    static unsigned polls = 0;
+    if (++polls % INTERRUPTION_POLL == 0 && std::this_thread::get_id() == runner)
+    {
+        {
+            std::lock_guard<std::mutex> lock(reportMutex);
+            progressCells[1] = elapsed_ms();
+        }
+        notify(progressCells[0], NULL);
+    }
+    return cancel_requested() ? IGRAPH_INTERRUPTED : IGRAPH_SUCCESS;
+}
+
+void install_progress_handlers(void)
+{
+    igraph_set_progress_handler(igraph_progress_handler);
+    igraph_set_interruption_handler(igraph_interruption_handler);
+}
+
+// Zero-copy views over the shared state. Like attribute_column(), fetch them
+// again after the heap may have grown unless memory is shared.
+val progress_view(void)
+{
+    return val(typed_memory_view(4, progressCells));
+}
+
+val cancel_view(void)
+{
+    static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t), "cancel flag must be a plain int32");
+    return val(typed_memory_view(1, reinterpret_cast<int32_t *>(&cancelFlag)));
+}
+
+// fn(percent, etaMs, message) is called as the running algorithm advances;
+// returning true cancels it. Pass null to remove it.
+void set_progress_callback(val fn)
+{
+    delete callback;
+    callback = fn.isNull() || fn.isUndefined() ? NULL : new val(fn);
+}
+
+void request_cancel(void)
+{
+    cancelFlag = 1;
+}
+
+void clear_cancel(void)
+{
+    cancelFlag = 0;
+}
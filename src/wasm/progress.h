@@ -0,0 +1,69 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+// Progress and cancellation of the algorithm running on a resident graph.
+//
+// The state sits in linear memory and JS reads it through typed array views
+// (progress_view(), cancel_view()). In the multithreaded build that memory is
+// a SharedArrayBuffer, so a UI thread can poll the percentage and set the
+// cancel flag while a worker runs the algorithm. The single-threaded build
+// cannot be reached while it runs; there a callback registered with
+// set_progress_callback() is called on the running thread and cancels by
+// returning true. Both are fed by igraph's progress and interruption handlers
+// and by the parallel kernels through ProgressCounter.
+
+// Thrown when a run is cancelled; the message is what JS sees
+class Cancelled : public std::runtime_error
+{
+public:
+    Cancelled() : std::runtime_error("Cancelled") {}
+};
+
+// Marks one algorithm run and resets the progress. Nested scopes belong to
+// the outer run. The cancel flag is left set, so a cancel raised while the
+// caller was still preparing the run stops it; callers clear it with
+// clear_cancel() when they start a run.
+class ProgressScope
+{
+public:
+    ProgressScope();
+    ~ProgressScope();
+
+    ProgressScope(const ProgressScope &) = delete;
+    ProgressScope &operator=(const ProgressScope &) = delete;
+};
+
+// Publishes percent (0-100) with the elapsed time and an ETA. Safe to call
+// from any pool thread; the JS callback only runs on the thread of the run.
+void report_progress(double percent, const char *message = NULL);
+
+bool cancel_requested(void);
+
+// Throws Cancelled if the run was cancelled. Kernels call it between chunks;
+// algorithms call it after igraph functions that may have been interrupted,
+// which return IGRAPH_INTERRUPTED instead of raising an error.
+void throw_if_cancelled(void);
+
+// Installs the igraph progress and interruption handlers
+void install_progress_handlers(void);
+
+// Counts finished work items across pool threads and reports each whole
+// percent once
+class ProgressCounter
+{
+public:
+    explicit ProgressCounter(size_t total) : total(total), done(0) {}
+
+    // Adds finished items, then throws Cancelled if the run was cancelled
+    void add(size_t items);
+
+private:
+    size_t total;
+    std::atomic<size_t> done;
+};
+
+#endif
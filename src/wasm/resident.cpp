@@ -0,0 +1,583 @@
+#include "graph.h"
+#include <cstring>
+#include <algorithm>
+#include <memory>
+
+// contains the registry of graphs held resident by the module, and the
+// functions that build and mutate them
+
+static std::unordered_map<int, std::unique_ptr<ResidentGraph>> residentGraphs;
+static int nextHandle = 1;
+
+ResidentGraph *currentGraph = NULL;
+
+ResidentGraph::~ResidentGraph()
+{
+    reset();
+}
+
+void ResidentGraph::reset(void)
+{
+    if (initialized)
+    {
+        igraph_destroy(&graph);
+        initialized = false;
+    }
+    if (VECTOR(weights) != NULL)
+    {
+        igraph_vector_destroy(&weights);
+    }
+    names.reset();
+    csr.reset();
+    vertexAttributes.clear();
+    edgeAttributes.clear();
+    weightAttribute.clear();
+    // Timings belong to the graph they were measured on; the mutation API
+    // edits the graph in place and keeps them
+    reorderMs = 0;
+    for (auto &times : kernelTime)
+        times.clear();
+    version = -1;
+}
+
+ResidentGraph &resident_graph(int handle)
+{
+    auto it = residentGraphs.find(handle);
+    if (it == residentGraphs.end())
+    {
+        throw std::runtime_error("Unknown graph handle " + std::to_string(handle));
+    }
+    return *it->second;
+}
+
+GraphScope::GraphScope(int handle) : previous(currentGraph)
+{
+    ResidentGraph &rg = resident_graph(handle);
+    if (!rg.initialized)
+    {
+        throw std::runtime_error("Graph handle " + std::to_string(handle) + " does not hold a graph yet");
+    }
+    refresh_weight_view(rg);
+    currentGraph = &rg;
+}
+
+GraphScope::~GraphScope()
+{
+    currentGraph = previous;
+}
+
+int create_graph_handle(void)
+{
+    int handle = nextHandle++;
+    residentGraphs.emplace(handle, std::make_unique<ResidentGraph>());
+    return handle;
+}
+
+void release_graph_handle(int handle)
+{
+    resident_graph(handle);
+    residentGraphs.erase(handle);
+}
+
+void cleanupGraph(void)
+{
+    residentGraphs.clear();
+}
+
+// Whether the handle already holds the given snapshot version in the given
+// direction, in which case the caller can skip parsing and rebuilding it
+bool graph_is_resident(int handle, igraph_integer_t version, igraph_bool_t directed)
+{
+    auto it = residentGraphs.find(handle);
+    if (it == residentGraphs.end())
+        return false;
+
+    const ResidentGraph &rg = *it->second;
+    return rg.initialized && rg.version >= 0 && rg.version == version &&
+           igraph_is_directed(&rg.graph) == directed;
+}
+
+// Replaces the graph held by rg with the edge list in src/dst/weights.
+// The endpoints are validated and widened to igraph_integer_t in a single pass
+// over contiguous memory and the resulting vector is handed to igraph_create
+// as is, so no element is pushed back one at a time.
+static void build_graph(
+    ResidentGraph &rg,
+    igraph_integer_t nodes,
+    const int32_t *src,
+    const int32_t *dst,
+    igraph_integer_t edge_count,
+    igraph_bool_t directed,
+    const double *weights, // NULL when the graph is unweighted
+    igraph_integer_t weight_count)
+{
+    igraph_set_attribute_table(&igraph_cattribute_table);
+    rg.reset();
+
+    if (nodes < 0)
+    {
+        throw std::runtime_error("Vertex count must not be negative");
+    }
+
+    igraph_vector_int_t edge_vector;
+    igraph_error_t rc = igraph_vector_int_init(&edge_vector, 2 * edge_count);
+    if (rc != IGRAPH_SUCCESS)
+    {
+        throw std::runtime_error(std::string("igraph_vector_int_init failed: ") + igraph_strerror(rc));
+    }
+
+    // Bounds check and widen in one tight loop; the unsigned compare rejects
+    // negative ids as well as ids >= nodes.
+    const uint64_t limit = static_cast<uint64_t>(nodes);
+    igraph_integer_t *out = VECTOR(edge_vector);
+    for (igraph_integer_t i = 0; i < edge_count; i++)
+    {
+        const int32_t s = src[i];
+        const int32_t t = dst[i];
+        if (static_cast<uint64_t>(static_cast<uint32_t>(s)) >= limit ||
+            static_cast<uint64_t>(static_cast<uint32_t>(t)) >= limit)
+        {
+            igraph_vector_int_destroy(&edge_vector);
+            throw std::runtime_error("Vertex index out of bounds");
+        }
+        out[2 * i] = s;
+        out[2 * i + 1] = t;
+    }
+
+    rc = igraph_create(&rg.graph, &edge_vector, nodes, directed ? IGRAPH_DIRECTED : IGRAPH_UNDIRECTED);
+    igraph_vector_int_destroy(&edge_vector);
+    if (rc != IGRAPH_SUCCESS)
+    {
+        throw std::runtime_error(std::string("igraph_create failed: ") + igraph_strerror(rc));
+    }
+    rg.initialized = true;
+
+    if (weights == NULL)
+        return;
+
+    // Missing trailing weights default to 0, as before
+    rc = igraph_vector_init(&rg.weights, edge_count);
+    if (rc != IGRAPH_SUCCESS)
+    {
+        rg.reset();
+        throw std::runtime_error(std::string("igraph_vector_init failed: ") + igraph_strerror(rc));
+    }
+
+    std::memcpy(VECTOR(rg.weights), weights, sizeof(double) * std::min(weight_count, edge_count));
+    igraph_cattribute_EAN_setv(&rg.graph, "weight", &rg.weights);
+}
+
+void create_graph_from_kuzu_to_igraph(
+    int handle,
+    igraph_integer_t nodes,
+    val src_js, // Int32Array
+    val dst_js, // Int32Array
+    igraph_bool_t directed,
+    val weight_js // Float64Array or undefined
+)
+{
+    ResidentGraph &rg = resident_graph(handle);
+    const igraph_integer_t edge_count = src_js["length"].as<igraph_integer_t>();
+
+    // Validate that source and destination arrays have the same length
+    if (edge_count != dst_js["length"].as<igraph_integer_t>())
+    {
+        throw std::runtime_error("Source and destination arrays must have the same length");
+    }
+
+    // Each conversion is a single TypedArray.set() into the WASM heap rather
+    // than one boundary crossing per element.
+    std::vector<int32_t> src = convertJSArrayToNumberVector<int32_t>(src_js);
+    std::vector<int32_t> dst = convertJSArrayToNumberVector<int32_t>(dst_js);
+
+    if (weight_js.isUndefined() || weight_js.isNull())
+    {
+        build_graph(rg, nodes, src.data(), dst.data(), edge_count, directed, NULL, 0);
+        return;
+    }
+
+    std::vector<double> weights = convertJSArrayToNumberVector<double>(weight_js);
+    build_graph(rg, nodes, src.data(), dst.data(), edge_count, directed, weights.data(), weights.size());
+}
+
+// Module-owned staging buffers for zero-copy ingestion. JS obtains typed
+// array views over them with ingest_buffers(), writes the edge list in place
+// and then calls create_graph_from_ingest_buffers().
+static std::vector<int32_t> ingestSrc, ingestDst;
+static std::vector<double> ingestWeights;
+
+// NOTE: the returned views alias WASM memory and are detached if the heap
+// grows, so fill them before making any other call into the module.
+val ingest_buffers(igraph_integer_t edge_count, igraph_bool_t weighted)
+{
+    if (edge_count < 0)
+    {
+        throw std::runtime_error("Edge count must not be negative");
+    }
+
+    ingestSrc.assign(edge_count, 0);
+    ingestDst.assign(edge_count, 0);
+    ingestWeights.assign(weighted ? edge_count : 0, 0.0);
+
+    val buffers = val::object();
+    buffers.set("src", val(typed_memory_view(ingestSrc.size(), ingestSrc.data())));
+    buffers.set("dst", val(typed_memory_view(ingestDst.size(), ingestDst.data())));
+    if (weighted)
+        buffers.set("weight", val(typed_memory_view(ingestWeights.size(), ingestWeights.data())));
+    return buffers;
+}
+
+void create_graph_from_ingest_buffers(int handle, igraph_integer_t nodes, igraph_bool_t directed, igraph_integer_t version)
+{
+    ResidentGraph &rg = resident_graph(handle);
+    const bool weighted = !ingestWeights.empty();
+    build_graph(rg, nodes, ingestSrc.data(), ingestDst.data(), ingestSrc.size(), directed,
+                weighted ? ingestWeights.data() : NULL, ingestWeights.size());
+
+    // Release the staging memory; igraph owns its own copy now
+    std::vector<int32_t>().swap(ingestSrc);
+    std::vector<int32_t>().swap(ingestDst);
+    std::vector<double>().swap(ingestWeights);
+
+    rg.version = version;
+}
+
+// Creates a new resident graph from the subgraph induced by the given vertices
+// (e.g. a k-core or a filtered view). Returns its handle together with an
+// Int32Array mapping each of its vertex IDs back to the source graph.
+val create_induced_subgraph(int handle, val vids_js)
+{
+    ResidentGraph &source = resident_graph(handle);
+    if (!source.initialized)
+    {
+        throw std::runtime_error("Graph handle " + std::to_string(handle) + " does not hold a graph yet");
+    }
+
+    std::vector<int32_t> vids = convertJSArrayToNumberVector<int32_t>(vids_js);
+    const igraph_integer_t nodes = igraph_vcount(&source.graph);
+    IGraphVectorInt vertices, invmap;
+    for (int32_t v : vids)
+    {
+        if (v < 0 || v >= nodes)
+        {
+            throw std::runtime_error("Vertex index out of bounds");
+        }
+        vertices.push_back(v);
+    }
+
+    int subHandle = create_graph_handle();
+    ResidentGraph &sub = resident_graph(subHandle);
+
+    igraph_vs_t vs;
+    igraph_vs_vector(&vs, vertices.vec());
+    try
+    {
+        igraph_induced_subgraph_map(&source.graph, &sub.graph, vs, IGRAPH_SUBGRAPH_AUTO, NULL, invmap.vec());
+    }
+    catch (...)
+    {
+        igraph_vs_destroy(&vs);
+        release_graph_handle(subHandle);
+        throw;
+    }
+    igraph_vs_destroy(&vs);
+    sub.initialized = true;
+
+    // The weight attribute travels with the edges, so read it back
+    if (VECTOR(source.weights) != NULL)
+    {
+        igraph_vector_init(&sub.weights, 0);
+        igraph_cattribute_EANV(&sub.graph, "weight", igraph_ess_all(IGRAPH_EDGEORDER_ID), &sub.weights);
+    }
+
+    std::vector<int32_t> original(invmap.size());
+    for (size_t i = 0; i < invmap.size(); i++)
+    {
+        original[i] = static_cast<int32_t>(invmap.at(i));
+    }
+
+    val result = val::object();
+    result.set("handle", subHandle);
+    result.set("vertices", val::global("Int32Array").new_(typed_memory_view(original.size(), original.data())));
+    return result;
+}
+
+static igraph_attribute_combination_type_t weight_merge_type(const std::string &merge)
+{
+    if (merge == "sum")
+        return IGRAPH_ATTRIBUTE_COMBINE_SUM;
+    if (merge == "max")
+        return IGRAPH_ATTRIBUTE_COMBINE_MAX;
+    if (merge == "min")
+        return IGRAPH_ATTRIBUTE_COMBINE_MIN;
+    if (merge == "mean")
+        return IGRAPH_ATTRIBUTE_COMBINE_MEAN;
+    if (merge == "first")
+        return IGRAPH_ATTRIBUTE_COMBINE_FIRST;
+    throw std::runtime_error("Unknown weight merge \"" + merge + "\"");
+}
+
+// igraph attribute the selected weight column is merged through
+static const char *const MERGED_WEIGHT_ATTRIBUTE = "__weight_attribute";
+
+// Replaces the graph behind target with the undirected projection of the graph
+// behind handle: reciprocal and parallel edges collapse into one undirected
+// edge whose weight is combined with weight_merge (sum, max, min, mean or
+// first). If the source selected a weight attribute, that column is merged
+// the same way and selected on the projection. The projection carries the
+// source's version, so graph_is_resident() reports it as current until the
+// source changes.
+void create_undirected_projection(int handle, int target, std::string weight_merge)
+{
+    ResidentGraph &source = resident_graph(handle);
+    if (!source.initialized)
+    {
+        throw std::runtime_error("Graph handle " + std::to_string(handle) + " does not hold a graph yet");
+    }
+    if (handle == target)
+    {
+        throw std::runtime_error("The projection needs a separate graph handle");
+    }
+
+    const igraph_attribute_combination_type_t merge = weight_merge_type(weight_merge);
+    ResidentGraph &projection = resident_graph(target);
+    projection.reset();
+
+    igraph_copy(&projection.graph, &source.graph);
+    projection.initialized = true;
+
+    const bool weightColumn = !source.weightAttribute.empty();
+    if (weightColumn)
+    {
+        refresh_weight_view(source);
+        igraph_cattribute_EAN_setv(&projection.graph, MERGED_WEIGHT_ATTRIBUTE, &source.weightView);
+    }
+
+    igraph_attribute_combination_t comb;
+    igraph_attribute_combination(&comb, "weight", merge, MERGED_WEIGHT_ATTRIBUTE, merge, "", IGRAPH_ATTRIBUTE_COMBINE_IGNORE, IGRAPH_NO_MORE_ATTRIBUTES);
+    try
+    {
+        igraph_to_undirected(&projection.graph, IGRAPH_TO_UNDIRECTED_COLLAPSE, &comb);
+    }
+    catch (...)
+    {
+        igraph_attribute_combination_destroy(&comb);
+        projection.reset();
+        throw;
+    }
+    igraph_attribute_combination_destroy(&comb);
+
+    if (VECTOR(source.weights) != NULL)
+    {
+        igraph_vector_init(&projection.weights, 0);
+        igraph_cattribute_EANV(&projection.graph, "weight", igraph_ess_all(IGRAPH_EDGEORDER_ID), &projection.weights);
+    }
+
+    if (weightColumn)
+    {
+        igraph_vector_t merged;
+        igraph_vector_init(&merged, 0);
+        igraph_cattribute_EANV(&projection.graph, MERGED_WEIGHT_ATTRIBUTE, igraph_ess_all(IGRAPH_EDGEORDER_ID), &merged);
+        AttributeColumn &column = typed_attribute(projection.edgeAttributes, source.weightAttribute, ATTRIBUTE_FLOAT, igraph_vector_size(&merged));
+        std::copy(VECTOR(merged), VECTOR(merged) + igraph_vector_size(&merged), column.numbers.begin());
+        igraph_vector_destroy(&merged);
+        igraph_cattribute_remove_e(&projection.graph, MERGED_WEIGHT_ATTRIBUTE);
+        projection.weightAttribute = source.weightAttribute;
+    }
+
+    projection.version = source.version;
+}
+
+// INCREMENTAL MUTATION
+// Apply a batch of changes to a resident graph in place instead of
+// re-exporting and rebuilding it. Each call takes the snapshot version the
+// graph corresponds to once the batch has been applied.
+
+static ResidentGraph &mutable_graph(int handle)
+{
+    ResidentGraph &rg = resident_graph(handle);
+    if (!rg.initialized || rg.version < 0)
+    {
+        throw std::runtime_error("There is no resident graph to modify");
+    }
+    return rg;
+}
+
+// Re-reads the weights from the "weight" attribute, which igraph keeps in
+// sync with the edge set when edges are removed
+static void sync_weights_from_attribute(ResidentGraph &rg)
+{
+    if (VECTOR(rg.weights) == NULL)
+        return;
+    igraph_cattribute_EANV(&rg.graph, "weight", igraph_ess_all(IGRAPH_EDGEORDER_ID), &rg.weights);
+}
+
+// Returns the ID of the first added vertex
+igraph_integer_t add_vertices(int handle, igraph_integer_t count, igraph_integer_t version)
+{
+    ResidentGraph &rg = mutable_graph(handle);
+    if (count < 0)
+    {
+        throw std::runtime_error("Vertex count must not be negative");
+    }
+
+    igraph_integer_t first = igraph_vcount(&rg.graph);
+    igraph_add_vertices(&rg.graph, count, NULL);
+    rg.names.reset();
+    rg.csr.reset();
+    resize_attributes(rg.vertexAttributes, first + count);
+    rg.version = version;
+    return first;
+}
+
+void add_edges(
+    int handle,
+    val src_js,    // Int32Array
+    val dst_js,    // Int32Array
+    val weight_js, // Float64Array or undefined
+    igraph_integer_t version)
+{
+    ResidentGraph &rg = mutable_graph(handle);
+
+    std::vector<int32_t> src = convertJSArrayToNumberVector<int32_t>(src_js);
+    std::vector<int32_t> dst = convertJSArrayToNumberVector<int32_t>(dst_js);
+    if (src.size() != dst.size())
+    {
+        throw std::runtime_error("Source and destination arrays must have the same length");
+    }
+
+    const igraph_integer_t count = src.size();
+    const igraph_integer_t nodes = igraph_vcount(&rg.graph);
+    IGraphVectorInt edges;
+    igraph_vector_int_resize(edges.vec(), 2 * count);
+    for (igraph_integer_t i = 0; i < count; i++)
+    {
+        if (src[i] < 0 || src[i] >= nodes || dst[i] < 0 || dst[i] >= nodes)
+        {
+            throw std::runtime_error("Vertex index out of bounds");
+        }
+        VECTOR(*edges.vec())[2 * i] = src[i];
+        VECTOR(*edges.vec())[2 * i + 1] = dst[i];
+    }
+
+    const igraph_integer_t first = igraph_ecount(&rg.graph);
+    igraph_add_edges(&rg.graph, edges.vec(), NULL);
+    resize_attributes(rg.edgeAttributes, first + count);
+
+    const bool hasNewWeights = !weight_js.isUndefined() && !weight_js.isNull();
+    if (VECTOR(rg.weights) == NULL && hasNewWeights)
+    {
+        // First weighted edges: existing edges default to 0, as in create_graph_from_kuzu_to_igraph
+        igraph_vector_init(&rg.weights, first + count);
+        std::vector<double> weights = convertJSArrayToNumberVector<double>(weight_js);
+        std::memcpy(VECTOR(rg.weights) + first, weights.data(), sizeof(double) * std::min<igraph_integer_t>(weights.size(), count));
+        igraph_cattribute_EAN_setv(&rg.graph, "weight", &rg.weights);
+    }
+    else if (VECTOR(rg.weights) != NULL)
+    {
+        std::vector<double> weights;
+        if (hasNewWeights)
+            weights = convertJSArrayToNumberVector<double>(weight_js);
+
+        igraph_vector_resize(&rg.weights, first + count);
+        for (igraph_integer_t i = 0; i < count; i++)
+        {
+            double w = i < static_cast<igraph_integer_t>(weights.size()) ? weights[i] : 0.0;
+            VECTOR(rg.weights)[first + i] = w;
+            SETEAN(&rg.graph, "weight", first + i, w);
+        }
+    }
+
+    rg.csr.reset();
+    rg.version = version;
+}
+
+// Deletes the edges with the given IDs. The remaining edges keep their
+// relative order, so callers can renumber their own edge lists by compaction.
+void delete_edges(int handle, val eids_js, igraph_integer_t version)
+{
+    ResidentGraph &rg = mutable_graph(handle);
+
+    std::vector<int32_t> ids = convertJSArrayToNumberVector<int32_t>(eids_js);
+    const igraph_integer_t edge_count = igraph_ecount(&rg.graph);
+    IGraphVectorInt eids;
+    std::vector<bool> keep(edge_count, true);
+    for (int32_t eid : ids)
+    {
+        if (eid < 0 || eid >= edge_count)
+        {
+            throw std::runtime_error("Edge index out of bounds");
+        }
+        eids.push_back(eid);
+        keep[eid] = false;
+    }
+
+    igraph_es_t es;
+    igraph_es_vector(&es, eids.vec());
+    igraph_delete_edges(&rg.graph, es);
+    igraph_es_destroy(&es);
+    sync_weights_from_attribute(rg);
+    compact_attributes(rg.edgeAttributes, keep);
+    rg.csr.reset();
+
+    rg.version = version;
+}
+
+// Deletes the given vertices together with their edges. Returns an Int32Array
+// mapping every old vertex ID to its new ID, or -1 if it was deleted.
+val delete_vertices(int handle, val vids_js, igraph_integer_t version)
+{
+    ResidentGraph &rg = mutable_graph(handle);
+
+    std::vector<int32_t> vids = convertJSArrayToNumberVector<int32_t>(vids_js);
+    const igraph_integer_t nodes = igraph_vcount(&rg.graph);
+    IGraphVectorInt vertices, idx;
+    for (int32_t v : vids)
+    {
+        if (v < 0 || v >= nodes)
+        {
+            throw std::runtime_error("Vertex index out of bounds");
+        }
+        vertices.push_back(v);
+    }
+
+    // The edges that go with the vertices, for the typed edge attributes
+    std::vector<bool> keepEdges;
+    if (!rg.edgeAttributes.empty())
+    {
+        std::vector<bool> deleted(nodes, false);
+        for (int32_t v : vids)
+            deleted[v] = true;
+
+        const igraph_integer_t edge_count = igraph_ecount(&rg.graph);
+        keepEdges.resize(edge_count);
+        for (igraph_integer_t e = 0; e < edge_count; e++)
+        {
+            igraph_integer_t from, to;
+            igraph_edge(&rg.graph, e, &from, &to);
+            keepEdges[e] = !deleted[from] && !deleted[to];
+        }
+    }
+
+    igraph_vs_t vs;
+    igraph_vs_vector(&vs, vertices.vec());
+    igraph_delete_vertices_idx(&rg.graph, vs, idx.vec(), NULL);
+    igraph_vs_destroy(&vs);
+    rg.names.reset();
+    rg.csr.reset();
+    sync_weights_from_attribute(rg);
+    compact_attributes(rg.edgeAttributes, keepEdges);
+
+    // idx holds new ID + 1, with 0 for deleted vertices
+    std::vector<int32_t> remap(nodes);
+    std::vector<bool> keepVertices(nodes);
+    for (igraph_integer_t v = 0; v < nodes; v++)
+    {
+        remap[v] = static_cast<int32_t>(idx.at(v)) - 1;
+        keepVertices[v] = remap[v] >= 0;
+    }
+    compact_attributes(rg.vertexAttributes, keepVertices);
+
+    rg.version = version;
+    return val::global("Int32Array").new_(typed_memory_view(remap.size(), remap.data()));
+}
@@ -0,0 +1,182 @@
+#include "task_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+// Threads are available natively and in the -pthread WASM build
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define TASK_POOL_THREADS 1
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#ifdef __EMSCRIPTEN__
+#include <emscripten/threading.h>
+#endif
+#endif
+
+// Set while a thread runs a chunk, so that nested parallel_for calls run
+// inline instead of waiting on workers that are busy with the outer one.
+// They run under the index of that thread, which owns its scratch slot.
+static thread_local bool insideTask = false;
+static thread_local unsigned taskThread = 0;
+
+struct TaskPool::State
+{
+    unsigned threads = 1;
+
+    // The running parallel_for, one at a time
+    std::mutex submit;
+    const RangeTask *task = NULL;
+    size_t end = 0, grain = 1;
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+#ifdef TASK_POOL_THREADS
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    unsigned long generation = 0; // bumped for every job
+    unsigned busy = 0;            // workers still on the current job
+    bool stopping = false;
+    std::vector<std::thread> workers;
+#endif
+
+    // Takes chunks until the range is exhausted
+    void run(unsigned thread)
+    {
+        insideTask = true;
+        taskThread = thread;
+        for (;;)
+        {
+            const size_t lo = next.fetch_add(grain);
+            if (lo >= end)
+                break;
+            try
+            {
+                (*task)(lo, std::min(end, lo + grain), thread);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                next = end; // skip the remaining chunks
+            }
+        }
+        insideTask = false;
+        taskThread = 0;
+    }
+
+#ifdef TASK_POOL_THREADS
+    void worker(unsigned thread)
+    {
+        unsigned long seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]
+                          { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+
+            run(thread);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0)
+                done.notify_one();
+        }
+    }
+#endif
+};
+
+TaskPool &TaskPool::instance(void)
+{
+    static TaskPool pool;
+    return pool;
+}
+
+TaskPool::TaskPool() : state(new State())
+{
+#ifdef TASK_POOL_THREADS
+#ifdef __EMSCRIPTEN__
+    // Matches PTHREAD_POOL_SIZE=navigator.hardwareConcurrency, so every worker
+    // gets a pre-started thread and none has to be spawned from the main thread
+    unsigned cores = emscripten_num_logical_cores();
+#else
+    unsigned cores = std::thread::hardware_concurrency();
+#endif
+    state->threads = std::max(1u, cores);
+    for (unsigned t = 1; t < state->threads; ++t)
+    {
+        state->workers.emplace_back([this, t]
+                                    { state->worker(t); });
+    }
+#endif
+}
+
+TaskPool::~TaskPool()
+{
+#ifdef TASK_POOL_THREADS
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stopping = true;
+    }
+    state->wake.notify_all();
+    for (std::thread &w : state->workers)
+        w.join();
+#endif
+    delete state;
+}
+
+unsigned TaskPool::size(void) const
+{
+    return state->threads;
+}
+
+void TaskPool::parallel_for(size_t begin, size_t end, size_t grain, const RangeTask &task)
+{
+    if (begin >= end)
+        return;
+    grain = std::max<size_t>(1, grain);
+
+    // Nested calls, small ranges and the single-threaded build run inline
+    if (insideTask || state->threads == 1 || end - begin <= grain)
+    {
+        task(begin, end, insideTask ? taskThread : 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(state->submit);
+    state->task = &task;
+    state->end = end;
+    state->grain = grain;
+    state->next = begin;
+    state->error = NULL;
+
+#ifdef TASK_POOL_THREADS
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->busy = state->workers.size();
+        ++state->generation;
+    }
+    state->wake.notify_all();
+#endif
+
+    state->run(0);
+
+#ifdef TASK_POOL_THREADS
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&]
+                         { return state->busy == 0; });
+    }
+#endif
+
+    state->task = NULL;
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
@@ -0,0 +1,43 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+// Fixed pool of worker threads shared by the parallel algorithm kernels.
+//
+// In the multithreaded build (-pthread, see the Dockerfile) the workers are
+// started on first use, one per logical core minus the calling thread, and
+// take their threads from the Emscripten PTHREAD_POOL_SIZE pool. In the
+// single-threaded build, and for calls made from inside a task, everything
+// runs inline on the calling thread, under that thread's own index, so
+// kernels need no separate serial path.
+class TaskPool
+{
+public:
+    // Called with [begin, end) and the index of the executing thread, which
+    // is below size() and can index per-thread scratch space
+    typedef std::function<void(size_t begin, size_t end, unsigned thread)> RangeTask;
+
+    static TaskPool &instance(void);
+
+    // Threads taking part in a parallel_for, the caller included
+    unsigned size(void) const;
+
+    // Splits [begin, end) into chunks of `grain` elements handed out to the
+    // threads on demand, and returns once all of them have run. The first
+    // exception thrown by a chunk is rethrown here after the others finish.
+    void parallel_for(size_t begin, size_t end, size_t grain, const RangeTask &task);
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+private:
+    TaskPool();
+    ~TaskPool();
+
+    struct State;
+    State *state;
+};
+
+#endif
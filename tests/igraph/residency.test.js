@@ -0,0 +1,203 @@
+import { IgraphController } from "../../src/igraph/IgraphController";
+import { AlgorithmCancelledError } from "../../src/igraph/utils/runIgraphAlgo";
+import { GraphChangeLog, edgesBetween } from "../../src/lib/GraphChangeLog";
+
+// WASM module stand-in that records what the controller uploads
+function fakeModule() {
+  const resident = new Map();
+  let handles = 0;
+  const mod = {
+    uploads: 0,
+    create_graph_handle: () => ++handles,
+    set_vertex_order: () => {},
+    ingest_buffers: (edges, weighted) => ({
+      src: new Int32Array(edges),
+      dst: new Int32Array(edges),
+      weight: weighted ? new Float64Array(edges) : undefined,
+    }),
+    create_graph_from_ingest_buffers: (handle, nodes, directed, version) => {
+      mod.uploads++;
+      resident.set(handle, { version, directed });
+    },
+    graph_is_resident: (handle, version, directed) => {
+      const graph = resident.get(handle);
+      return (
+        graph !== undefined &&
+        graph.version === version &&
+        graph.directed === directed
+      );
+    },
+    added: [],
+    deleted: [],
+    add_edges: (handle, src, dst, weight, version) => {
+      mod.added.push(...Array.from(src, (s, i) => [s, dst[i]]));
+      resident.get(handle).version = version;
+    },
+    delete_edges: (handle, eids, version) => {
+      mod.deleted.push(...eids);
+      resident.get(handle).version = version;
+    },
+    delete_vertices: (handle, vids, version) => {
+      resident.get(handle).version = version;
+      // Vertex 0 ("a") goes; the others move down by one
+      return Int32Array.from([-1, 0, 1]);
+    },
+    graph_node_columns: () => ({}),
+    graph_edge_columns: () => ({}),
+    cancelFlag: new Int32Array(1),
+    cancel_view: () => mod.cancelFlag,
+    request_cancel: () => {
+      mod.cancelFlag[0] = 1;
+    },
+    clear_cancel: () => {
+      mod.cancelFlag[0] = 0;
+    },
+  };
+  return mod;
+}
+
+function node(id) {
+  return { id, _primaryKey: "id", _primaryKeyValue: id, tableName: "N" };
+}
+
+function edge(source, target) {
+  return { source, target, tableName: "E" };
+}
+
+function setup() {
+  const changes = new GraphChangeLog();
+  const snapshot = {
+    nodes: [node("a"), node("b"), node("c")],
+    edges: [edge("a", "b"), edge("b", "c")],
+    nodeTables: [],
+    edgeTables: [],
+  };
+  const db = {
+    snapshots: 0,
+    snapshotGraphState: async () => {
+      db.snapshots++;
+      // Every snapshot hands out fresh objects, as the Kuzu services do
+      return {
+        ...snapshot,
+        nodes: snapshot.nodes.map((n) => ({ ...n })),
+        edges: snapshot.edges.map((e) => ({ ...e })),
+      };
+    },
+  };
+  const controller = new IgraphController(
+    db.snapshotGraphState,
+    () => true,
+    changes
+  );
+  const mod = fakeModule();
+  controller._wasmGraphModule = mod;
+  return { controller, changes, db, mod, snapshot };
+}
+
+test("two calls with no change in between do not re-upload the graph", async () => {
+  const { controller, db, mod } = setup();
+
+  await controller.graphColumns();
+  await controller.graphColumns();
+
+  expect(mod.uploads).toBe(1);
+  expect(db.snapshots).toBe(1);
+});
+
+test("a database change makes the next call take a new snapshot", async () => {
+  const { controller, changes, db } = setup();
+
+  await controller.graphColumns();
+  changes.reset();
+  await controller.graphColumns();
+  await controller.graphColumns();
+
+  expect(db.snapshots).toBe(2);
+});
+
+test("logged edge changes are replayed without a snapshot", async () => {
+  const { controller, changes, db, mod, snapshot } = setup();
+
+  await controller.graphColumns();
+  snapshot.edges.push(edge("c", "a"));
+  changes.record(edgesBetween(snapshot.edges, "c", "a", "E"));
+  await controller.graphColumns();
+
+  expect(db.snapshots).toBe(1);
+  expect(mod.uploads).toBe(1);
+  expect(mod.added).toEqual([[2, 0]]);
+});
+
+test("a logged node deletion drops the node and its edges", async () => {
+  const { controller, changes, db, mod } = setup();
+
+  await controller.graphColumns();
+  changes.record({ type: "node", id: "a", node: null });
+  const { IgraphToKuzuMap } = await controller._residentGraphData(true);
+
+  expect(db.snapshots).toBe(1);
+  expect(mod.uploads).toBe(1);
+  expect(mod.deleted).toEqual([0]);
+  expect([...IgraphToKuzuMap]).toEqual([
+    [0, "b"],
+    [1, "c"],
+  ]);
+});
+
+test("concurrent calls into a worker-hosted module share one upload", async () => {
+  const { controller, db, mod } = setup();
+  // Every call resolves later, as through GraphWorkerClient
+  controller._wasmGraphModule = new Proxy(mod, {
+    get: (target, name) =>
+      typeof target[name] === "function" && name !== "ingest_buffers"
+        ? async (...args) => target[name](...args)
+        : target[name],
+  });
+
+  await Promise.all([controller.graphColumns(), controller.graphColumns()]);
+
+  expect(mod.uploads).toBe(1);
+  expect(db.snapshots).toBe(1);
+});
+
+test("a cancel during the upload stops the run before its kernel", async () => {
+  const { controller, mod } = setup();
+  let finishUpload;
+  const upload = mod.create_graph_from_ingest_buffers;
+  mod.create_graph_from_ingest_buffers = (...args) =>
+    new Promise((resolve) => {
+      finishUpload = () => resolve(upload(...args));
+    });
+  mod.graph_node_columns = () => {
+    throw new Error("kernel ran");
+  };
+
+  const run = controller.graphColumns();
+  await new Promise((resolve) => setTimeout(resolve, 0));
+  controller.cancel();
+  finishUpload();
+
+  await expect(run).rejects.toBeInstanceOf(AlgorithmCancelledError);
+  expect(mod.cancelFlag[0]).toBe(1);
+});
+
+test("a worker restart during the upload rejects as a cancel", async () => {
+  const { controller } = setup();
+  let failUpload;
+  // Stands in for GraphWorkerClient replacing a worker that has no shared
+  // memory: the pending upload rejects with "Cancelled"
+  controller._worker = {
+    clearCancel: () => {},
+    upload: () =>
+      new Promise((_, reject) => {
+        failUpload = () => reject(new Error("Cancelled"));
+      }),
+    cancel: () => failUpload(),
+  };
+
+  const run = controller.graphColumns();
+  await new Promise((resolve) => setTimeout(resolve, 0));
+  controller.cancel();
+
+  await expect(run).rejects.toBeInstanceOf(AlgorithmCancelledError);
+});
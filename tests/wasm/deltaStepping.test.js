@@ -0,0 +1,71 @@
+import {
+  describeWasm,
+  loadGraphModule,
+  random,
+  randomGraph,
+  referenceDistances,
+  uploadGraph,
+} from "./graphModule.js";
+
+// Dijkstra's tree form runs delta-stepping on the CSR snapshot; its
+// distances must match igraph's shortest-path tree and a reference Dijkstra,
+// and every predecessor edge must be tight
+describeWasm("delta-stepping shortest-path tree", () => {
+  let mod;
+
+  beforeAll(async () => {
+    mod = await loadGraphModule();
+  });
+
+  const cases = [
+    [true, "none"],
+    [false, "none"],
+    [true, "rcm"],
+    [false, "degree"],
+  ];
+
+  test.each(cases)("directed %p, vertex order %s", (directed, order) => {
+    const rand = random(directed ? 41 : 43);
+    for (let round = 0; round < 4; round++) {
+      const nodes = 100 + Math.floor(rand() * 900);
+      const { edges, weights } = randomGraph(rand, nodes, nodes * 4);
+      const handle = uploadGraph(mod, nodes, edges, directed, weights);
+      mod.set_vertex_order(handle, order);
+
+      for (let i = 0; i < 3; i++) {
+        const source = Math.floor(rand() * nodes);
+        const tree = mod.dijkstra_source_to_all(handle, source, true).data;
+        const igraph = mod.bellman_ford_source_to_all(handle, source, true);
+        const want = referenceDistances(
+          nodes,
+          edges,
+          weights,
+          directed,
+          source
+        );
+
+        expect(tree.delta).toBeGreaterThan(0);
+        for (let v = 0; v < nodes; v++) {
+          const got = tree.distances[v];
+          if (want[v] === Infinity) {
+            expect(got).toBe(Infinity);
+            expect(tree.predecessors[v]).toBe(-1);
+            continue;
+          }
+          expect(got).toBeCloseTo(want[v], 9);
+          expect(got).toBeCloseTo(igraph.data.distances[v], 9);
+          if (v === source) continue;
+
+          const e = tree.predecessorEdges[v];
+          const u = tree.predecessors[v];
+          const [from, to] = edges[e];
+          const joins =
+            (from === u && to === v) || (!directed && from === v && to === u);
+          expect(joins).toBe(true);
+          expect(tree.distances[u] + weights[e]).toBe(got);
+        }
+      }
+      mod.release_graph_handle(handle);
+    }
+  });
+});
@@ -0,0 +1,72 @@
+// Loads the multithreaded WASM build (src/graph-mt.js, produced by the
+// Dockerfile) under Node. Suites using it are skipped when it is not built.
+import { existsSync } from "fs";
+
+const modulePath = new URL("../../src/graph-mt.js", import.meta.url);
+
+export const describeWasm = existsSync(modulePath) ? describe : describe.skip;
+
+export async function loadGraphModule() {
+  const { default: createModule } = await import(modulePath.href);
+  return createModule();
+}
+
+// Uploads an edge list into a fresh resident graph and returns its handle
+export function uploadGraph(mod, nodes, edges, directed, weights) {
+  const handle = mod.create_graph_handle();
+  mod.create_graph_from_kuzu_to_igraph(
+    handle,
+    nodes,
+    Int32Array.from(edges.map(([s]) => s)),
+    Int32Array.from(edges.map(([, t]) => t)),
+    directed,
+    weights ? Float64Array.from(weights) : undefined
+  );
+  return handle;
+}
+
+// Deterministic pseudo-random source (mulberry32)
+export function random(seed) {
+  return () => {
+    seed = (seed + 0x6d2b79f5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+export function randomGraph(rand, nodes, edgeCount) {
+  const edges = [];
+  const weights = [];
+  for (let i = 0; i < edgeCount; i++) {
+    edges.push([Math.floor(rand() * nodes), Math.floor(rand() * nodes)]);
+    weights.push(1 + Math.floor(rand() * 100) / 10);
+  }
+  return { edges, weights };
+}
+
+// Plain O(V^2) Dijkstra used as the reference distance oracle
+export function referenceDistances(nodes, edges, weights, directed, source) {
+  const adjacency = Array.from({ length: nodes }, () => []);
+  edges.forEach(([s, t], i) => {
+    const w = weights ? weights[i] : 1;
+    adjacency[s].push([t, w]);
+    if (!directed) adjacency[t].push([s, w]);
+  });
+  const dist = new Array(nodes).fill(Infinity);
+  const done = new Array(nodes).fill(false);
+  dist[source] = 0;
+  for (;;) {
+    let u = -1;
+    for (let v = 0; v < nodes; v++) {
+      if (!done[v] && dist[v] < Infinity && (u < 0 || dist[v] < dist[u])) {
+        u = v;
+      }
+    }
+    if (u < 0) return dist;
+    done[u] = true;
+    for (const [v, w] of adjacency[u]) {
+      if (dist[u] + w < dist[v]) dist[v] = dist[u] + w;
+    }
+  }
+}
@@ -0,0 +1,61 @@
+import {
+  describeWasm,
+  loadGraphModule,
+  random,
+  randomGraph,
+  referenceDistances,
+  uploadGraph,
+} from "./graphModule.js";
+
+// Point-to-point queries answered from the contraction hierarchy must match
+// the plain bidirectional search and a reference Dijkstra, path included
+describeWasm("shortest-path index", () => {
+  let mod;
+
+  beforeAll(async () => {
+    mod = await loadGraphModule();
+  });
+
+  const cases = [
+    [true, "none"],
+    [false, "none"],
+    [true, "rcm"],
+    [false, "degree"],
+  ];
+
+  test.each(cases)("directed %p, vertex order %s", (directed, order) => {
+    const rand = random(directed ? 17 : 29);
+    for (let round = 0; round < 5; round++) {
+      const nodes = 20 + Math.floor(rand() * 60);
+      const { edges, weights } = randomGraph(rand, nodes, nodes * 3);
+      const plain = uploadGraph(mod, nodes, edges, directed, weights);
+      const indexed = uploadGraph(mod, nodes, edges, directed, weights);
+      mod.set_vertex_order(indexed, order);
+      expect(mod.build_shortest_path_index(indexed).built).toBe(true);
+
+      for (let s = 0; s < nodes; s += 3) {
+        const want = referenceDistances(nodes, edges, weights, directed, s);
+        for (let t = 0; t < nodes; t++) {
+          if (t === s) continue;
+          const fromIndex = mod.dijkstra_source_to_target(indexed, s, t).data;
+          const fromSearch = mod.dijkstra_source_to_target(plain, s, t).data;
+          expect(fromIndex.indexed).toBe(true);
+
+          if (want[t] === Infinity) {
+            expect(fromIndex.path).toHaveLength(0);
+            expect(fromSearch.path).toHaveLength(0);
+            continue;
+          }
+          expect(fromIndex.totalWeight).toBeCloseTo(want[t], 9);
+          expect(fromSearch.totalWeight).toBeCloseTo(want[t], 9);
+          const pathWeight = fromIndex.path.reduce((w, l) => w + l.weight, 0);
+          expect(pathWeight).toBeCloseTo(want[t], 9);
+          expect(fromIndex.path[0].from).toBe(s);
+          expect(fromIndex.path.at(-1).to).toBe(t);
+        }
+      }
+      mod.release_graph_handle(plain);
+      mod.release_graph_handle(indexed);
+    }
+  });
+});
@@ -0,0 +1,41 @@
+import { describeWasm, loadGraphModule, uploadGraph } from "./graphModule.js";
+
+// Vertex 0 has no edges; 1 -> 2 -> 3 is a chain
+const edges = [
+  [1, 2],
+  [2, 3],
+];
+
+describeWasm("shortest-path tree from an isolated source", () => {
+  let mod;
+
+  beforeAll(async () => {
+    mod = await loadGraphModule();
+  });
+
+  const cases = [
+    ["dijkstra_source_to_all", [2, 3]],
+    ["dijkstra_source_to_all", undefined],
+    ["bellman_ford_source_to_all", [2, 3]],
+    ["bellman_ford_source_to_all", undefined],
+  ];
+
+  test.each(cases)("%s with weights %p", (algorithm, weights) => {
+    for (const directed of [true, false]) {
+      const handle = uploadGraph(mod, 4, edges, directed, weights);
+      const result = mod[algorithm](handle, 0, true);
+
+      expect(result.data.reached).toBe(0);
+      expect(Array.from(result.data.distances)).toEqual([
+        0,
+        Infinity,
+        Infinity,
+        Infinity,
+      ]);
+      expect(Array.from(result.data.predecessors)).toEqual([-1, -1, -1, -1]);
+      expect(Array.from(result.highlight.vertices)).toEqual([0]);
+      expect(result.highlight.edgeSources.length).toBe(0);
+      mod.release_graph_handle(handle);
+    }
+  });
+});